@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Audio sample queue header file                                           //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This header file provides the queue that carries 16 bit stereo samples   //
+// from the emulation to the host's audio callback.                         //
+//                                                                          //
+// There must only ever be one thread writing and one thread reading, each  //
+// end only ever moves its own index so no locks are needed. Samples are    //
+// copied before the write index is published with a release store and the //
+// other end picks it up with an acquire load, likewise for the read index. //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUDIORING_H
+#define AUDIORING_H
+
+#include <string.h>
+
+#if defined(__GNUC__) && (__GNUC__>4 || (__GNUC__==4 && __GNUC_MINOR__>=7))
+#define AUDIO_RING_LOAD(x)		__atomic_load_n(&(x),__ATOMIC_ACQUIRE)
+#define AUDIO_RING_STORE(x,v)	__atomic_store_n(&(x),(v),__ATOMIC_RELEASE)
+#else
+// Older compilers get a full barrier either side of a volatile access
+#if defined(__GNUC__)
+#define AUDIO_RING_BARRIER()	__sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define AUDIO_RING_BARRIER()	_ReadWriteBarrier()
+#else
+#define AUDIO_RING_BARRIER()
+#endif
+inline ULONG AudioRingLoad(volatile ULONG &x) { ULONG v=x; AUDIO_RING_BARRIER(); return v; }
+inline void AudioRingStore(volatile ULONG &x,ULONG v) { AUDIO_RING_BARRIER(); x=v; }
+#define AUDIO_RING_LOAD(x)		AudioRingLoad(x)
+#define AUDIO_RING_STORE(x,v)	AudioRingStore(x,v)
+#endif
+
+// The size must be a power of two so the free running indexes wrap cleanly
+#if (HANDY_AUDIO_BUFFER_SIZE<=0) || (HANDY_AUDIO_BUFFER_SIZE & (HANDY_AUDIO_BUFFER_SIZE-1))
+#error HANDY_AUDIO_BUFFER_SIZE must be a power of two
+#endif
+#define AUDIO_RING_SIZE		HANDY_AUDIO_BUFFER_SIZE
+#define AUDIO_RING_MASK		(AUDIO_RING_SIZE-1)
+
+class CAudioRing
+{
+	public:
+		CAudioRing()
+		{
+			mWrite=0;
+			mRead=0;
+			mOverruns=0;
+			mUnderruns=0;
+			memset(mBuffer,0,sizeof(mBuffer));
+		};
+
+		//
+		// Producer side, queue count stereo samples. If the reader has
+		// fallen behind then whatever doesn't fit is dropped.
+		//
+		ULONG	Write(const SWORD *samples,ULONG count)
+		{
+			ULONG write=mWrite;
+			ULONG space=AUDIO_RING_SIZE-(write-AUDIO_RING_LOAD(mRead));
+
+			if(count>space)
+			{
+				AUDIO_RING_STORE(mOverruns,mOverruns+1);
+				count=space;
+			}
+
+			ULONG first=AUDIO_RING_SIZE-(write&AUDIO_RING_MASK);
+			if(first>count) first=count;
+			memcpy(&mBuffer[(write&AUDIO_RING_MASK)*2],samples,first*2*sizeof(SWORD));
+			memcpy(mBuffer,samples+first*2,(count-first)*2*sizeof(SWORD));
+
+			AUDIO_RING_STORE(mWrite,write+count);
+			return count;
+		};
+
+		//
+		// Consumer side, take up to count stereo samples. Returns how many
+		// we had, the caller fills the rest of its buffer.
+		//
+		ULONG	Read(SWORD *samples,ULONG count)
+		{
+			ULONG read=mRead;
+			ULONG fill=AUDIO_RING_LOAD(mWrite)-read;
+
+			if(count>fill)
+			{
+				AUDIO_RING_STORE(mUnderruns,mUnderruns+1);
+				count=fill;
+			}
+
+			ULONG first=AUDIO_RING_SIZE-(read&AUDIO_RING_MASK);
+			if(first>count) first=count;
+			memcpy(samples,&mBuffer[(read&AUDIO_RING_MASK)*2],first*2*sizeof(SWORD));
+			memcpy(samples+first*2,mBuffer,(count-first)*2*sizeof(SWORD));
+
+			AUDIO_RING_STORE(mRead,read+count);
+			return count;
+		};
+
+		// Either side can look, the answer may be stale by the time it's used
+		ULONG	Fill(void) { return AUDIO_RING_LOAD(mWrite)-AUDIO_RING_LOAD(mRead); };
+		ULONG	Space(void) { return AUDIO_RING_SIZE-Fill(); };
+		ULONG	Overruns(void) { return AUDIO_RING_LOAD(mOverruns); };
+		ULONG	Underruns(void) { return AUDIO_RING_LOAD(mUnderruns); };
+
+	private:
+		volatile ULONG	mWrite;			// Only moved by the producer
+		volatile ULONG	mRead;			// Only moved by the consumer
+		volatile ULONG	mOverruns;
+		volatile ULONG	mUnderruns;
+
+		SWORD	mBuffer[AUDIO_RING_SIZE*2];
+};
+
+#endif
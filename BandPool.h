@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Band thread pool header file                                             //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This header file provides the small thread pool that the display         //
+// filters and the sprite engine use to cut a job into horizontal bands.    //
+//                                                                          //
+// Start() runs a worker for each band after the first, Run() hands the     //
+// same job to all of them, runs band 0 on the calling thread and           //
+// returns once every band is done. If a thread can't be started the job    //
+// is just cut into fewer bands, GetBands() says how many there are.        //
+//                                                                          //
+// Only built with HANDY_FILTER_THREADS or HANDY_SPRITE_THREADS, it needs   //
+// pthreads.                                                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BANDPOOL_H
+#define BANDPOOL_H
+
+#include <pthread.h>
+
+// Most bands a job is cut into, one thread each
+#define BAND_POOL_MAX_BANDS	8
+
+// Called with the object given to Start() and the band to do
+typedef void (*TBandFunction)(void *object,ULONG band);
+
+class CBandPool
+{
+	public:
+		CBandPool()
+		{
+			mBands=1;
+			mFunction=NULL;
+			mObject=NULL;
+			mJob=0;
+			mPending=0;
+			mQuit=FALSE;
+			pthread_mutex_init(&mLock,NULL);
+			pthread_cond_init(&mStart,NULL);
+			pthread_cond_init(&mDone,NULL);
+		};
+
+		~CBandPool()
+		{
+			Stop();
+			pthread_cond_destroy(&mDone);
+			pthread_cond_destroy(&mStart);
+			pthread_mutex_destroy(&mLock);
+		};
+
+		ULONG	Start(ULONG bands,TBandFunction function,void *object)
+		{
+			Stop();
+			if(bands>BAND_POOL_MAX_BANDS) bands=BAND_POOL_MAX_BANDS;
+			mFunction=function;
+			mObject=object;
+
+			while(mBands<bands)
+			{
+				mWorker[mBands].pool=this;
+				mWorker[mBands].band=mBands;
+				if(pthread_create(&mThread[mBands],NULL,WorkerEntry,&mWorker[mBands])) break;
+				mBands++;
+			}
+			return mBands;
+		};
+
+		void	Stop(void)
+		{
+			if(mBands>1)
+			{
+				pthread_mutex_lock(&mLock);
+				mQuit=TRUE;
+				pthread_cond_broadcast(&mStart);
+				pthread_mutex_unlock(&mLock);
+				for(ULONG loop=1;loop<mBands;loop++) pthread_join(mThread[loop],NULL);
+			}
+			mBands=1;
+			mJob=0;
+			mPending=0;
+			mQuit=FALSE;
+		};
+
+		void	Run(void)
+		{
+			if(mBands>1)
+			{
+				pthread_mutex_lock(&mLock);
+				mPending=mBands-1;
+				mJob++;
+				pthread_cond_broadcast(&mStart);
+				pthread_mutex_unlock(&mLock);
+			}
+
+			mFunction(mObject,0);
+
+			if(mBands>1)
+			{
+				pthread_mutex_lock(&mLock);
+				while(mPending) pthread_cond_wait(&mDone,&mLock);
+				pthread_mutex_unlock(&mLock);
+			}
+		};
+
+		ULONG	GetBands(void) { return mBands; };
+
+	private:
+		struct TBandWorker
+		{
+			CBandPool	*pool;
+			ULONG	band;
+		};
+
+		static void* WorkerEntry(void *object)
+		{
+			TBandWorker *worker=(TBandWorker*)object;
+			worker->pool->Worker(worker->band);
+			return NULL;
+		};
+
+		void	Worker(ULONG band)
+		{
+			ULONG job=0;
+
+			pthread_mutex_lock(&mLock);
+			for(;;)
+			{
+				while(mJob==job && !mQuit) pthread_cond_wait(&mStart,&mLock);
+				if(mQuit) break;
+				job=mJob;
+				pthread_mutex_unlock(&mLock);
+
+				mFunction(mObject,band);
+
+				pthread_mutex_lock(&mLock);
+				if(--mPending==0) pthread_cond_signal(&mDone);
+			}
+			pthread_mutex_unlock(&mLock);
+		};
+
+		ULONG	mBands;
+		TBandFunction	mFunction;
+		void	*mObject;
+
+		pthread_t		mThread[BAND_POOL_MAX_BANDS];
+		TBandWorker		mWorker[BAND_POOL_MAX_BANDS];
+		pthread_mutex_t	mLock;
+		pthread_cond_t	mStart;
+		pthread_cond_t	mDone;
+		ULONG	mJob;
+		ULONG	mPending;
+		ULONG	mQuit;
+};
+
+#endif
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Band limited sound synthesis                                             //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This class turns the steps in the Mikie audio output into 16 bit stereo  //
+// samples at the host rate and queues them in gAudioRing.                  //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#define BLIP_CPP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "System.h"
+#include "Blip.h"
+
+// Cutoff as a fraction of the host Nyquist frequency
+#define BLIP_CUTOFF			0.9
+#define BLIP_STEPS			16
+
+#ifndef M_PI
+#define M_PI				3.14159265358979323846
+#endif
+
+//
+// Windowed sinc lowpass, the window keeps it inside the taps we have
+//
+static double BlipImpulse(double x)
+{
+	double width=BLIP_TAPS/2-1;
+	if(x<=-width || x>=width) return 0.0;
+
+	double window=0.42+0.5*cos(M_PI*x/width)+0.08*cos(2.0*M_PI*x/width);
+	double sinc=(x==0.0)?1.0:sin(M_PI*BLIP_CUTOFF*x)/(M_PI*BLIP_CUTOFF*x);
+	return BLIP_CUTOFF*sinc*window;
+}
+
+CBlip::CBlip()
+{
+	//
+	// Each tap is the area of the impulse across one output sample, for a
+	// step that lands BLIP_TAPS/2 samples and a fraction of a sample in
+	// 
+	for(ULONG phase=0;phase<BLIP_PHASES;phase++)
+	{
+		double shift=(double)phase/BLIP_PHASES;
+		SLONG total=0;
+		ULONG peak=0;
+
+		for(ULONG tap=0;tap<BLIP_TAPS;tap++)
+		{
+			double area=0.0;
+			for(ULONG step=0;step<BLIP_STEPS;step++)
+			{
+				area+=BlipImpulse((double)tap-BLIP_TAPS/2-1-shift+(step+0.5)/BLIP_STEPS);
+			}
+			mKernel[phase][tap]=(SLONG)floor(area*(1<<BLIP_KERNEL_BITS)/BLIP_STEPS+0.5);
+			total+=mKernel[phase][tap];
+			if(mKernel[phase][tap]>mKernel[phase][peak]) peak=tap;
+		}
+
+		// Every step must settle at exactly its height
+		mKernel[phase][peak]+=(1<<BLIP_KERNEL_BITS)-total;
+	}
+
+	SetSampleFreq(HANDY_AUDIO_SAMPLE_FREQ);
+	Reset(0);
+}
+
+void CBlip::SetSampleFreq(ULONG freq)
+{
+	mSampleFreq=freq;
+	mFactor=(((UCYCLE)freq<<32)+HANDY_SYSTEM_FREQ/2)/HANDY_SYSTEM_FREQ;
+}
+
+void CBlip::Reset(UCYCLE cycle)
+{
+	gAudioLastUpdateCycle=cycle;
+	mFraction=0;
+	mLeftSum=0;
+	mRightSum=0;
+	memset(mLeft,0,sizeof(mLeft));
+	memset(mRight,0,sizeof(mRight));
+}
+
+//
+// Pass every sample that no later step can reach on to the host
+//
+void CBlip::Flush(UCYCLE cycle)
+{
+	if(cycle<=gAudioLastUpdateCycle) return;
+
+	UCYCLE offset=(cycle-gAudioLastUpdateCycle)*mFactor+mFraction;
+	UCYCLE count=offset>>32;
+
+	gAudioLastUpdateCycle=cycle;
+	mFraction=offset&0xffffffff;
+
+	while(count)
+	{
+		ULONG chunk=(count>BLIP_BUFFER_SIZE)?BLIP_BUFFER_SIZE:(ULONG)count;
+		ReadSamples(chunk);
+		count-=chunk;
+	}
+}
+
+void CBlip::ReadSamples(ULONG count)
+{
+	SLONG left=mLeftSum;
+	SLONG right=mRightSum;
+
+	for(ULONG loop=0;loop<count;loop++)
+	{
+		left+=mLeft[loop]-(left>>BLIP_BASS_SHIFT);
+		right+=mRight[loop]-(right>>BLIP_BASS_SHIFT);
+
+		SLONG sample=left>>BLIP_OUTPUT_SHIFT;
+		if(sample>32767) sample=32767;
+		if(sample<-32768) sample=-32768;
+		mOutput[loop*2]=(SWORD)sample;
+
+		sample=right>>BLIP_OUTPUT_SHIFT;
+		if(sample>32767) sample=32767;
+		if(sample<-32768) sample=-32768;
+		mOutput[loop*2+1]=(SWORD)sample;
+	}
+
+	// If the host has stopped reading then these are lost, the queue keeps
+	// count of that
+	gAudioRing.Write(mOutput,count);
+
+	mLeftSum=left;
+	mRightSum=right;
+
+	// Only the tails of the last steps can be beyond what we have read
+	memmove(mLeft,mLeft+count,BLIP_TAPS*sizeof(SLONG));
+	memmove(mRight,mRight+count,BLIP_TAPS*sizeof(SLONG));
+	memset(mLeft+BLIP_TAPS,0,count*sizeof(SLONG));
+	memset(mRight+BLIP_TAPS,0,count*sizeof(SLONG));
+}
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Band limited sound synthesis header file                                 //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This header file provides the interface definition for the synthesiser   //
+// that turns the steps in the Mikie audio output into 16 bit stereo at     //
+// the host sample rate.                                                    //
+//                                                                          //
+// Each step is added to the output as a band limited step, so the cost is  //
+// per waveform edge rather than per host sample and the output needs no    //
+// further filtering. Steps are placed to a fraction of a sample, there is  //
+// no rounding of the sample period to a whole number of cycles.            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLIP_H
+#define BLIP_H
+
+// Each step is spread over BLIP_TAPS samples and placed to 1/BLIP_PHASES
+// of a sample, this delays the output by BLIP_TAPS/2 samples
+#define BLIP_PHASE_BITS		5
+#define BLIP_PHASES			(1<<BLIP_PHASE_BITS)
+#define BLIP_TAPS			16
+#define BLIP_KERNEL_BITS	15
+
+// Samples that can build up before we have to pass them to the host
+#define BLIP_BUFFER_SIZE	1024
+
+// A unit step on one channel comes out as 64, so all four channels at full
+// volume just fill a word
+#define BLIP_OUTPUT_SHIFT	(BLIP_KERNEL_BITS-6)
+
+// Gentle high pass to lose any DC, a pole at about 14Hz at 44.1KHz
+#define BLIP_BASS_SHIFT		9
+
+class CBlip
+{
+	public:
+		CBlip();
+
+		void	SetSampleFreq(ULONG freq);
+		ULONG	GetSampleFreq(void) { return mSampleFreq; };
+		void	Reset(UCYCLE cycle);
+		void	Flush(UCYCLE cycle);
+
+		//
+		// Add a step in the left and right outputs at the given cycle, steps
+		// must come in time order and never before the last flush.
+		//
+		inline void	AddDelta(UCYCLE cycle,SLONG left,SLONG right)
+		{
+			if(cycle<gAudioLastUpdateCycle) cycle=gAudioLastUpdateCycle;
+
+			UCYCLE offset=(cycle-gAudioLastUpdateCycle)*mFactor+mFraction;
+			if((offset>>32)>=BLIP_BUFFER_SIZE)
+			{
+				Flush(cycle);
+				offset=mFraction;
+			}
+
+			const SLONG *kernel=mKernel[(offset>>(32-BLIP_PHASE_BITS))&(BLIP_PHASES-1)];
+			SLONG *pleft=&mLeft[offset>>32];
+			SLONG *pright=&mRight[offset>>32];
+			for(ULONG loop=0;loop<BLIP_TAPS;loop++)
+			{
+				pleft[loop]+=left*kernel[loop];
+				pright[loop]+=right*kernel[loop];
+			}
+		};
+
+	private:
+		void	ReadSamples(ULONG count);
+
+		ULONG	mSampleFreq;
+		UCYCLE	mFactor;			// Host samples per cycle, 32.32 fixed point
+		UCYCLE	mFraction;			// Part sample still to come at the last flush
+
+		SLONG	mLeftSum;
+		SLONG	mRightSum;
+		SLONG	mLeft[BLIP_BUFFER_SIZE+BLIP_TAPS];
+		SLONG	mRight[BLIP_BUFFER_SIZE+BLIP_TAPS];
+
+		SLONG	mKernel[BLIP_PHASES][BLIP_TAPS];
+		SWORD	mOutput[BLIP_BUFFER_SIZE*2];
+};
+
+#endif
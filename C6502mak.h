@@ -47,18 +47,18 @@
 //
 
 #define	xIMMEDIATE()			{mOperand=mPC;mPC++;}
-#define	xABSOLUTE()				{mOperand=CPU_PEEKW(mPC);mPC+=2;}
-#define xZEROPAGE()				{mOperand=CPU_PEEK(mPC);mPC++;}
-#define xZEROPAGE_X()			{mOperand=CPU_PEEK(mPC)+mX;mPC++;mOperand&=0xff;}
-#define xZEROPAGE_Y()			{mOperand=CPU_PEEK(mPC)+mY;mPC++;mOperand&=0xff;}
-#define xABSOLUTE_X()			{mOperand=CPU_PEEKW(mPC);mPC+=2;mOperand+=mX;mOperand&=0xffff;}
-#define	xABSOLUTE_Y()			{mOperand=CPU_PEEKW(mPC);mPC+=2;mOperand+=mY;mOperand&=0xffff;}
-#define xINDIRECT_ABSOLUTE_X()	{mOperand=CPU_PEEKW(mPC);mPC+=2;mOperand+=mX;mOperand&=0xffff;mOperand=CPU_PEEKW(mOperand);}
-#define xRELATIVE()				{mOperand=CPU_PEEK(mPC);mPC++;mOperand=(mPC+mOperand)&0xffff;}
-#define xINDIRECT_X()			{mOperand=CPU_PEEK(mPC);mPC++;mOperand=mOperand+mX;mOperand&=0x00ff;mOperand=CPU_PEEKW(mOperand);}
-#define xINDIRECT_Y()			{mOperand=CPU_PEEK(mPC);mPC++;mOperand=CPU_PEEKW(mOperand);mOperand=mOperand+mY;mOperand&=0xffff;}
-#define xINDIRECT_ABSOLUTE()	{mOperand=CPU_PEEKW(mPC);mPC+=2;mOperand=CPU_PEEKW(mOperand);}
-#define xINDIRECT()				{mOperand=CPU_PEEK(mPC);mPC++;mOperand=CPU_PEEKW(mOperand);}
+#define	xABSOLUTE()				{mOperand=CPU_FETCHW();mPC+=2;}
+#define xZEROPAGE()				{mOperand=CPU_FETCH();mPC++;}
+#define xZEROPAGE_X()			{mOperand=CPU_FETCH()+mX;mPC++;mOperand&=0xff;}
+#define xZEROPAGE_Y()			{mOperand=CPU_FETCH()+mY;mPC++;mOperand&=0xff;}
+#define xABSOLUTE_X()			{mOperand=CPU_FETCHW();mPC+=2;mOperand+=mX;mOperand&=0xffff;}
+#define	xABSOLUTE_Y()			{mOperand=CPU_FETCHW();mPC+=2;mOperand+=mY;mOperand&=0xffff;}
+#define xINDIRECT_ABSOLUTE_X()	{mOperand=CPU_FETCHW();mPC+=2;mOperand+=mX;mOperand&=0xffff;mOperand=CPU_PEEKW(mOperand);}
+#define xRELATIVE()				{mOperand=CPU_FETCH();mPC++;mOperand=(mPC+mOperand)&0xffff;}
+#define xINDIRECT_X()			{mOperand=CPU_FETCH();mPC++;mOperand=mOperand+mX;mOperand&=0x00ff;mOperand=CPU_PEEKW(mOperand);}
+#define xINDIRECT_Y()			{mOperand=CPU_FETCH();mPC++;mOperand=CPU_PEEKW(mOperand);mOperand=mOperand+mY;mOperand&=0xffff;}
+#define xINDIRECT_ABSOLUTE()	{mOperand=CPU_FETCHW();mPC+=2;mOperand=CPU_PEEKW(mOperand);}
+#define xINDIRECT()				{mOperand=CPU_FETCH();mPC++;mOperand=CPU_PEEKW(mOperand);}
 
 //
 // Helper Macros
@@ -161,7 +161,7 @@
 {\
 	if(!mC)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -177,7 +177,7 @@
 {\
 	if(mC)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -193,7 +193,7 @@
 {\
 	if(mZ)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -235,7 +235,7 @@
 {\
 	if(mN)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -251,7 +251,7 @@
 {\
 	if(!mZ)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -267,7 +267,7 @@
 {\
 	if(!mN)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -281,7 +281,7 @@
 
 #define	xBRA()\
 {\
-	int offset=(signed char)CPU_PEEK(mPC);\
+	int offset=(signed char)CPU_FETCH();\
 	mPC++;\
 	mPC+=offset;\
 	mPC&=0xffff;\
@@ -320,7 +320,7 @@
 {\
 	if(!mV)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -336,7 +336,7 @@
 {\
 	if(mV)\
 	{\
-		int offset=(signed char)CPU_PEEK(mPC);\
+		int offset=(signed char)CPU_FETCH();\
 		mPC++;\
 		mPC+=offset;\
 		mPC&=0xffff;\
@@ -0,0 +1,1417 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// 65C02 Opcode dispatch                                                    //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This file holds the case labels for the 256 way opcode switch. It is     //
+// included into the body of each switch statement that executes 65C02      //
+// opcodes, the instruction stream is read via the CPU_FETCH()/CPU_FETCHW() //
+// macros so that each includer can supply its operands from memory or      //
+// from a predecoded block. Cycles are charged via CPU_CYCLES() so that a   //
+// block executor can charge a whole block in one go.                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+//
+// 0x00
+//
+		case 0x00:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			// IMPLIED
+			xBRK();
+			break;
+		case 0x01:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xORA();
+			break;
+		case 0x02:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x03:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x04:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xTSB();
+			break;
+		case 0x05:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xORA();
+			break;
+		case 0x06:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xASL();
+			break;
+		case 0x07:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x08:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			// IMPLIED
+			xPHP();
+			break;
+		case 0x09:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xORA();
+			break;
+		case 0x0A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xASLA();
+			break;
+		case 0x0B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x0C:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xTSB();
+			break;
+		case 0x0D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xORA();
+			break;
+		case 0x0E:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xASL();
+			break;
+		case 0x0F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x10
+//
+		case 0x10:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBPL();
+			break;
+		case 0x11:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xORA();
+			break;
+		case 0x12:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xORA();
+			break;
+		case 0x13:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x14:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xTRB();
+			break;
+		case 0x15:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xORA();
+			break;
+		case 0x16:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xASL();
+			break;
+		case 0x17:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x18:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xCLC();
+			break;
+		case 0x19:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xORA();
+			break;
+		case 0x1A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xINCA();
+			break;
+		case 0x1B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x1C:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xTRB();
+			break;
+		case 0x1D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xORA();
+			break;
+		case 0x1E:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xASL();
+			break;
+		case 0x1F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x20
+//
+		case 0x20:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xJSR();
+			break;
+		case 0x21:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xAND();
+			break;
+		case 0x22:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x23:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x24:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xBIT();
+			break;
+		case 0x25:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xAND();
+			break;
+		case 0x26:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xROL();
+			break;
+		case 0x27:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x28:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// IMPLIED
+			xPLP();
+			break;
+		case 0x29:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xAND();
+			break;
+		case 0x2A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xROLA();
+			break;
+		case 0x2B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x2C:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xBIT();
+			break;
+		case 0x2D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xAND();
+			break;
+		case 0x2E:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xROL();
+			break;
+		case 0x2F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x30
+//
+		case 0x30:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBMI();
+			break;
+		case 0x31:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xAND();
+			break;
+		case 0x32:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xAND();
+			break;
+		case 0x33:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x34:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xBIT();
+			break;
+		case 0x35:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xAND();
+			break;
+		case 0x36:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xROL();
+			break;
+		case 0x37:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x38:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xSEC();
+			break;
+		case 0x39:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xAND();
+			break;
+		case 0x3A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xDECA();
+			break;
+		case 0x3B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x3C:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xBIT();
+			break;
+		case 0x3D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xAND();
+			break;
+		case 0x3E:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xROL();
+			break;
+		case 0x3F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x40
+//
+		case 0x40:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			// Only clear IRQ if this is not a BRK instruction based RTI
+
+			// B flag is on the stack cant test the flag
+			int tmp;
+			PULL(tmp);
+			PUSH (tmp);
+			if(!(tmp&0x10))
+			{
+				gSystemCPUSleep=gSystemCPUSleep_Saved;
+
+				// If were in sleep mode then we need to push the 
+				// wakeup counter along by the same number of cycles
+				// we have used during the sleep period
+				if(gSystemCPUSleep)
+				{
+					gCPUWakeupTime+=gSystemCycleCount-gIRQEntryCycle;
+				}
+			}
+			// IMPLIED
+			xRTI();
+			break;
+		case 0x41:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xEOR();
+			break;
+		case 0x42:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x43:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x44:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x45:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xEOR();
+			break;
+		case 0x46:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xLSR();
+			break;
+		case 0x47:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x48:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			// IMPLIED
+			xPHA();
+			break;
+		case 0x49:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xEOR();
+			break;
+		case 0x4A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xLSRA();
+			break;
+		case 0x4B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x4C:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xJMP();
+			break;
+		case 0x4D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xEOR();
+			break;
+		case 0x4E:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xLSR();
+			break;
+		case 0x4F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x50
+//
+		case 0x50:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBVC();
+			break;
+		case 0x51:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xEOR();
+			break;
+		case 0x52:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xEOR();
+			break;
+		case 0x53:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x54:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x55:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xEOR();
+			break;
+		case 0x56:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xLSR();
+			break;
+		case 0x57:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x58:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xCLI();
+			break;
+		case 0x59:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xEOR();
+			break;
+		case 0x5A:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			// IMPLIED
+			xPHY();
+			break;
+		case 0x5B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x5C:
+			CPU_CYCLES(1+(7*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x5D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xEOR();
+			break;
+		case 0x5E:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xLSR();
+			break;
+		case 0x5F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x60
+//
+		case 0x60:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			// IMPLIED
+			xRTS();
+			break;
+		case 0x61:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xADC();
+			break;
+		case 0x62:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x63:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x64:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xSTZ();
+			break;
+		case 0x65:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xADC();
+			break;
+		case 0x66:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xROR();
+			break;
+		case 0x67:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x68:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// IMPLIED
+			xPLA();
+			break;
+		case 0x69:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xADC();
+			break;
+		case 0x6A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xRORA();
+			break;
+		case 0x6B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x6C:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_ABSOLUTE();
+			xJMP();
+			break;
+		case 0x6D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xADC();
+			break;
+		case 0x6E:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xROR();
+			break;
+		case 0x6F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x70
+//
+		case 0x70:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBVS();
+			break;
+		case 0x71:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xADC();
+			break;
+		case 0x72:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xADC();
+			break;
+		case 0x73:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x74:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xSTZ();
+			break;
+		case 0x75:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xADC();
+			break;
+		case 0x76:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xROR();
+			break;
+		case 0x77:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x78:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xSEI();
+			break;
+		case 0x79:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xADC();
+			break;
+		case 0x7A:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// IMPLIED
+			xPLY();
+			break;
+		case 0x7B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x7C:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_ABSOLUTE_X();
+			xJMP();
+			break;
+		case 0x7D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xADC();
+			break;
+		case 0x7E:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xROR();
+			break;
+		case 0x7F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x80
+//
+		case 0x80:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBRA();
+			break;
+		case 0x81:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xSTA();
+			break;
+		case 0x82:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x83:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x84:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xSTY();
+			break;
+		case 0x85:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xSTA();
+			break;
+		case 0x86:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xSTX();
+			break;
+		case 0x87:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x88:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xDEY();
+			break;
+		case 0x89:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xBIT();
+			break;
+		case 0x8A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xTXA();
+			break;
+		case 0x8B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x8C:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xSTY();
+			break;
+		case 0x8D:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xSTA();
+			break;
+		case 0x8E:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xSTX();
+			break;
+		case 0x8F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0x90
+//
+		case 0x90:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBCC();
+			break;
+		case 0x91:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xSTA();
+			break;
+		case 0x92:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xSTA();
+			break;
+		case 0x93:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x94:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xSTY();
+			break;
+		case 0x95:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xSTA();
+			break;
+		case 0x96:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_Y();
+			xSTX();
+			break;
+		case 0x97:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0x98:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xTYA();
+			break;
+		case 0x99:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xSTA();
+			break;
+		case 0x9A:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xTXS();
+			break;
+		case 0x9B:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0x9C:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xSTZ();
+			break;
+		case 0x9D:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xSTA();
+			break;
+		case 0x9E:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xSTZ();
+			break;
+		case 0x9F:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0xA0
+//
+		case 0xA0:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xLDY();
+			break;
+		case 0xA1:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xLDA();
+			break;
+		case 0xA2:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xLDX();
+			break;
+		case 0xA3:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xA4:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xLDY();
+			break;
+		case 0xA5:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xLDA();
+			break;
+		case 0xA6:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xLDX();
+			break;
+		case 0xA7:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0xA8:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xTAY();
+			break;
+		case 0xA9:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xLDA();
+			break;
+		case 0xAA:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xTAX();
+			break;
+		case 0xAB:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xAC:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xLDY();
+			break;
+		case 0xAD:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xLDA();
+			break;
+		case 0xAE:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xLDX();
+			break;
+		case 0xAF:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0xB0
+//
+		case 0xB0:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBCS();
+			break;
+		case 0xB1:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xLDA();
+			break;
+		case 0xB2:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xLDA();
+			break;
+		case 0xB3:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xB4:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xLDY();
+			break;
+		case 0xB5:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xLDA();
+			break;
+		case 0xB6:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_Y();
+			xLDX();
+			break;
+		case 0xB7:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0xB8:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xCLV();
+			break;
+		case 0xB9:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xLDA();
+			break;
+		case 0xBA:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xTSX();
+			break;
+		case 0xBB:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xBC:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xLDY();
+			break;
+		case 0xBD:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xLDA();
+			break;
+		case 0xBE:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xLDX();
+			break;
+		case 0xBF:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0xC0
+//
+		case 0xC0:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xCPY();
+			break;
+		case 0xC1:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xCMP();
+			break;
+		case 0xC2:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xC3:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xC4:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xCPY();
+			break;
+		case 0xC5:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xCMP();
+			break;
+		case 0xC6:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xDEC();
+			break;
+		case 0xC7:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0xC8:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xINY();
+			break;
+		case 0xC9:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xCMP();
+			break;
+		case 0xCA:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xDEX();
+			break;
+		case 0xCB:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xWAI();
+			break;
+		case 0xCC:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xCPY();
+			break;
+		case 0xCD:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xCMP();
+			break;
+		case 0xCE:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xDEC();
+			break;
+		case 0xCF:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0xD0
+//
+		case 0xD0:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBNE();
+			break;
+		case 0xD1:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xCMP();
+			break;
+		case 0xD2:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xCMP();
+			break;
+		case 0xD3:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xD4:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xD5:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xCMP();
+			break;
+		case 0xD6:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xDEC();
+			break;
+		case 0xD7:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0xD8:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xCLD();
+			break;
+		case 0xD9:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xCMP();
+			break;
+		case 0xDA:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			// IMPLIED
+			xPHX();
+			break;
+		case 0xDB:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xSTP();
+			break;
+		case 0xDC:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xDD:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xCMP();
+			break;
+		case 0xDE:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xDEC();
+			break;
+		case 0xDF:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0xE0
+//
+		case 0xE0:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xCPX();
+			break;
+		case 0xE1:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xINDIRECT_X();
+			xSBC();
+			break;
+		case 0xE2:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xE3:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xE4:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xCPX();
+			break;
+		case 0xE5:
+			CPU_CYCLES(1+(2*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xSBC();
+			break;
+		case 0xE6:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xZEROPAGE();
+			xINC();
+			break;
+		case 0xE7:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0xE8:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xINX();
+			break;
+		case 0xE9:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			xIMMEDIATE();
+			xSBC();
+			break;
+		case 0xEA:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xNOP();
+			break;
+		case 0xEB:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xEC:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xCPX();
+			break;
+		case 0xED:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xSBC();
+			break;
+		case 0xEE:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xABSOLUTE();
+			xINC();
+			break;
+		case 0xEF:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+//
+// 0xF0
+//
+		case 0xF0:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// RELATIVE (IN FUNCTION)
+			xBEQ();
+			break;
+		case 0xF1:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT_Y();
+			xSBC();
+			break;
+		case 0xF2:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			xINDIRECT();
+			xSBC();
+			break;
+		case 0xF3:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xF4:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xF5:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xSBC();
+			break;
+		case 0xF6:
+			CPU_CYCLES(1+(5*CPU_RDWR_CYC));
+			xZEROPAGE_X();
+			xINC();
+			break;
+		case 0xF7:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+
+		case 0xF8:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// IMPLIED
+			xSED();
+			break;
+		case 0xF9:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_Y();
+			xSBC();
+			break;
+		case 0xFA:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// IMPLIED
+			xPLX();
+			break;
+		case 0xFB:
+			CPU_CYCLES(1+(1*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xFC:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
+		case 0xFD:
+			CPU_CYCLES(1+(3*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xSBC();
+			break;
+		case 0xFE:
+			CPU_CYCLES(1+(6*CPU_RDWR_CYC));
+			xABSOLUTE_X();
+			xINC();
+			break;
+		case 0xFF:
+			CPU_CYCLES(1+(4*CPU_RDWR_CYC));
+			// *** ILLEGAL ***
+			xILLEGAL();
+			break;
@@ -49,10 +49,939 @@
 
 #include "System.h"
 
+#ifdef HANDY_CPU_JIT
+#include <sys/mman.h>
+#endif
+
 #ifdef GZIP_STATE
 #include "./zlib-113/zlib.h"
 #endif
 
+#ifdef HANDY_BLOCK_CACHE
+
+//
+// Instruction length in bytes, the kind of memory access the opcode makes
+// and whether it ends a block, see the CPU_DECODE_xxx flags
+//
+static const UBYTE cpuDecodeTable[256]=
+{
+	0xc1,0x42,0xc1,0xc1,0x32,0x12,0x32,0xc1,0x31,0x02,0x01,0xc1,0x2b,0x0b,0x2b,0xc1,	// 0x00
+	0x82,0x42,0x42,0xc1,0x32,0x12,0x32,0xc1,0x01,0x0f,0x01,0xc1,0x2b,0x0f,0x2f,0xc1,	// 0x10
+	0xb3,0x42,0xc1,0xc1,0x12,0x12,0x32,0xc1,0x41,0x02,0x01,0xc1,0x0b,0x0b,0x2b,0xc1,	// 0x20
+	0x82,0x42,0x42,0xc1,0x12,0x12,0x32,0xc1,0x01,0x0f,0x01,0xc1,0x0f,0x0f,0x2f,0xc1,	// 0x30
+	0xc1,0x42,0xc1,0xc1,0xc1,0x12,0x32,0xc1,0x31,0x02,0x01,0xc1,0x83,0x0b,0x2b,0xc1,	// 0x40
+	0x82,0x42,0x42,0xc1,0xc1,0x12,0x32,0xc1,0x41,0x0f,0x31,0xc1,0xc1,0x0f,0x2f,0xc1,	// 0x50
+	0x91,0x42,0xc1,0xc1,0x32,0x12,0x32,0xc1,0x11,0x02,0x01,0xc1,0xc3,0x0b,0x2b,0xc1,	// 0x60
+	0x82,0x42,0x42,0xc1,0x32,0x12,0x32,0xc1,0x01,0x0f,0x11,0xc1,0xc3,0x0f,0x2f,0xc1,	// 0x70
+	0x82,0x62,0xc1,0xc1,0x32,0x32,0x32,0xc1,0x01,0x02,0x01,0xc1,0x2b,0x2b,0x2b,0xc1,	// 0x80
+	0x82,0x62,0x62,0xc1,0x32,0x32,0x32,0xc1,0x01,0x2f,0x01,0xc1,0x2b,0x2f,0x2f,0xc1,	// 0x90
+	0x02,0x42,0x02,0xc1,0x12,0x12,0x12,0xc1,0x01,0x02,0x01,0xc1,0x0b,0x0b,0x0b,0xc1,	// 0xA0
+	0x82,0x42,0x42,0xc1,0x12,0x12,0x12,0xc1,0x01,0x0f,0x01,0xc1,0x0f,0x0f,0x0f,0xc1,	// 0xB0
+	0x02,0x42,0xc1,0xc1,0x12,0x12,0x32,0xc1,0x01,0x02,0x01,0x81,0x0b,0x0b,0x2b,0xc1,	// 0xC0
+	0x82,0x42,0x42,0xc1,0xc1,0x12,0x32,0xc1,0x01,0x0f,0x31,0x81,0xc1,0x0f,0x2f,0xc1,	// 0xD0
+	0x02,0x42,0xc1,0xc1,0x12,0x12,0x32,0xc1,0x01,0x02,0x01,0xc1,0x0b,0x0b,0x2b,0xc1,	// 0xE0
+	0x82,0x42,0x42,0xc1,0xc1,0x12,0x32,0xc1,0x01,0x0f,0x11,0xc1,0xc1,0x0f,0x2f,0xc1	// 0xF0
+};
+
+//
+// Bus cycles for each opcode, must match the CPU_CYCLES() in C6502ops.h
+//
+static const UBYTE cpuCycleTable[256]=
+{
+	6,5,1,1,4,2,4,1,2,2,1,1,5,3,5,4,	// 0x00
+	1,4,4,1,4,3,5,4,1,3,1,1,5,3,6,4,	// 0x10
+	5,5,1,1,2,2,4,4,3,1,1,1,3,3,5,4,	// 0x20
+	1,4,4,1,3,3,5,4,1,3,1,1,3,3,6,4,	// 0x30
+	5,5,1,1,2,2,4,4,2,1,1,1,2,3,5,4,	// 0x40
+	1,4,4,1,3,3,5,4,1,3,2,1,7,3,6,4,	// 0x50
+	5,5,1,1,2,2,4,4,3,1,1,1,5,3,5,4,	// 0x60
+	1,4,4,1,3,3,5,4,1,3,3,1,5,3,6,4,	// 0x70
+	2,5,1,1,2,2,2,4,1,1,1,1,3,3,3,4,	// 0x80
+	1,5,4,1,3,3,3,4,1,4,1,1,3,4,4,4,	// 0x90
+	1,5,1,1,2,2,2,4,1,1,1,1,3,3,3,4,	// 0xA0
+	1,4,4,1,3,3,3,4,1,3,1,1,3,3,3,3,	// 0xB0
+	1,5,1,1,2,2,4,4,1,1,1,1,3,3,5,4,	// 0xC0
+	1,4,4,1,3,3,5,4,1,3,2,1,3,3,6,4,	// 0xD0
+	1,5,1,1,2,2,4,4,1,1,1,1,3,3,5,4,	// 0xE0
+	1,4,4,1,3,3,5,4,1,3,3,1,3,3,6,4	// 0xF0
+};
+
+void C65C02::FlushBlockCache(void)
+{
+	TRACE_CPU0("FlushBlockCache()");
+	memset(mBlockIndex,0,CPU_BLOCK_LIMIT*sizeof(UWORD));
+	memset(mCodePage,0,sizeof(mCodePage));
+	mBlockCount=0;
+	mCodeModified=TRUE;
+#ifdef HANDY_CPU_JIT
+	memset(mCodeRewrites,0,sizeof(mCodeRewrites));
+	mJitUsed=0;
+#endif
+}
+
+void C65C02::InvalidateCodePage(ULONG page)
+{
+	TRACE_CPU1("InvalidateCodePage() Page=$%02x",page);
+
+	// A block may run on from the previous page so it must go as well
+	ULONG start=(page)?((page-1)<<8):0;
+	ULONG end=(page+1)<<8;
+	if(end>CPU_BLOCK_LIMIT) end=CPU_BLOCK_LIMIT;
+
+	memset(&mBlockIndex[start],0,(end-start)*sizeof(UWORD));
+	mCodePage[page]=FALSE;
+	mCodeModified=TRUE;
+#ifdef HANDY_CPU_JIT
+	if(mCodeRewrites[page]<0xff) mCodeRewrites[page]++;
+#endif
+}
+
+C6502_BLOCK* C65C02::DecodeBlock(ULONG pc)
+{
+	TRACE_CPU1("DecodeBlock() PC=$%04x",pc);
+
+	// Start afresh when the pool runs dry, only hot code will come back
+	if(mBlockCount>=CPU_BLOCK_POOL) FlushBlockCache();
+
+	C6502_BLOCK *block=&mBlockPool[mBlockCount];
+	ULONG addr=pc;
+	ULONG page=pc>>8;
+
+	block->Count=0;
+	block->Folded=TRUE;
+	block->Cycles=0;
+	block->Lead=0;
+	block->Address=pc;
+#ifdef HANDY_CPU_JIT
+	block->Runs=0;
+	block->Native=NULL;
+#endif
+	while(block->Count<CPU_BLOCK_MAX_INSN)
+	{
+		UBYTE opcode=mRamPointer[addr];
+		ULONG decode=cpuDecodeTable[opcode];
+		ULONG length=decode&CPU_DECODE_LENGTH;
+
+		// Never decode operands from the I/O area
+		if(addr+length>CPU_BLOCK_LIMIT) break;
+
+		C6502_INSN *insn=&block->Insn[block->Count++];
+		insn->Opcode=opcode;
+		insn->Operand=0;
+		if(length>1) insn->Operand=mRamPointer[addr+1];
+		if(length>2) insn->Operand|=mRamPointer[addr+2]<<8;
+
+		// A block can only be folded if it stays clear of I/O and cannot
+		// write to itself, a write to a page drops blocks starting in the
+		// page and the one before so check against both
+		if(decode&CPU_DECODE_DYNAMIC) block->Folded=FALSE;
+		if((decode&CPU_DECODE_LOWRAM) && (decode&CPU_DECODE_WRITE) && page<2) block->Folded=FALSE;
+		if(decode&CPU_DECODE_ABSOLUTE)
+		{
+			ULONG low=insn->Operand;
+			ULONG high=low+((decode&CPU_DECODE_INDEXED)?0xff:0);
+			if(high>=CPU_BLOCK_LIMIT) block->Folded=FALSE;
+			if((decode&CPU_DECODE_WRITE) && (low>>8)<=page+1 && (high>>8)>=page) block->Folded=FALSE;
+		}
+
+		block->Lead=block->Cycles;
+		block->Cycles+=1+(cpuCycleTable[opcode]*CPU_RDWR_CYC);
+
+		mCodePage[addr>>8]=TRUE;
+		mCodePage[(addr+length-1)>>8]=TRUE;
+		addr+=length;
+
+		if(decode&CPU_DECODE_FLOW) break;
+	}
+
+	if(!block->Count) return NULL;
+
+	mBlockIndex[pc]=(UWORD)++mBlockCount;
+	return block;
+}
+
+#ifdef HANDY_CPU_JIT
+
+//
+// Recompiler, each hot folded block becomes one x86-64 function called as
+// Native(cpu). While it runs rbx holds the CPU and r12 the RAM, the 65C02
+// registers and flags stay in the CPU object so the interpreter and the
+// service requests below always see the current state. Only eax, ecx, edx
+// and esi are used, ecx holds the address of an indexed operand.
+//
+
+#define X86_EAX		0
+#define X86_ECX		1
+#define X86_EDX		2
+#define X86_ESI		6
+
+#define X86_AE		3
+#define X86_E		4
+#define X86_NE		5
+
+#define JIT_REQ_CODEWRITE	0x10000
+#define JIT_REQ_ADC			0x20000
+#define JIT_REQ_SBC			0x30000
+#define JIT_REQ_PHP			0x40000
+
+enum {	JIT_NONE=0,
+		JIT_LDA,JIT_LDX,JIT_LDY,JIT_STA,JIT_STX,JIT_STY,JIT_STZ,
+		JIT_ORA,JIT_AND,JIT_EOR,JIT_ADC,JIT_SBC,JIT_CMP,JIT_CPX,JIT_CPY,JIT_BIT,
+		JIT_ASL,JIT_LSR,JIT_ROL,JIT_ROR,JIT_INC,JIT_DEC,JIT_TSB,JIT_TRB,
+		JIT_TAX,JIT_TAY,JIT_TXA,JIT_TYA,JIT_TSX,JIT_TXS,JIT_INX,JIT_INY,JIT_DEX,JIT_DEY,
+		JIT_CLC,JIT_SEC,JIT_CLD,JIT_SED,JIT_CLV,JIT_SEI,JIT_NOP,
+		JIT_PHA,JIT_PHX,JIT_PHY,JIT_PLA,JIT_PLX,JIT_PLY,JIT_PHP,JIT_JSR,JIT_RTS,JIT_JMP,
+		JIT_BPL,JIT_BMI,JIT_BVC,JIT_BVS,JIT_BCC,JIT_BCS,JIT_BNE,JIT_BEQ,JIT_BRA
+};
+
+typedef struct
+{
+	UBYTE	Operation;
+	UBYTE	Mode;
+}C6502_JIT_OP;
+
+typedef struct
+{
+	ULONG	A,X,Y,SP,PC,Opcode,Operand;
+	ULONG	N,V,D,I,Z,C;
+	ULONG	CodePage;
+	ULONG	Ram;
+}C6502_JIT_LAYOUT;
+
+//
+// Opcodes the recompiler handles with the addressing mode used for each in
+// C6502ops.h, a block using any other opcode stays with the interpreter
+//
+static const UBYTE cpuJitOps[][3]=
+{
+	{0x04,JIT_TSB,zp},{0x05,JIT_ORA,zp},{0x06,JIT_ASL,zp},{0x08,JIT_PHP,impl},{0x09,JIT_ORA,imm},{0x0a,JIT_ASL,accu},
+	{0x0c,JIT_TSB,absl},{0x0d,JIT_ORA,absl},{0x0e,JIT_ASL,absl},{0x10,JIT_BPL,rel},{0x14,JIT_TRB,zp},{0x15,JIT_ORA,zpx},
+	{0x16,JIT_ASL,zpx},{0x18,JIT_CLC,impl},{0x19,JIT_ORA,absy},{0x1a,JIT_INC,accu},{0x1c,JIT_TRB,absl},{0x1d,JIT_ORA,absx},
+	{0x1e,JIT_ASL,absx},{0x20,JIT_JSR,absl},{0x24,JIT_BIT,zp},{0x25,JIT_AND,zp},{0x26,JIT_ROL,zp},{0x29,JIT_AND,imm},
+	{0x2a,JIT_ROL,accu},{0x2c,JIT_BIT,absl},{0x2d,JIT_AND,absl},{0x2e,JIT_ROL,absl},{0x30,JIT_BMI,rel},{0x34,JIT_BIT,zpx},
+	{0x35,JIT_AND,zpx},{0x36,JIT_ROL,zpx},{0x38,JIT_SEC,impl},{0x39,JIT_AND,absy},{0x3a,JIT_DEC,accu},{0x3c,JIT_BIT,absx},
+	{0x3d,JIT_AND,absx},{0x3e,JIT_ROL,absx},{0x45,JIT_EOR,zp},{0x46,JIT_LSR,zp},{0x48,JIT_PHA,impl},{0x49,JIT_EOR,imm},
+	{0x4a,JIT_LSR,accu},{0x4c,JIT_JMP,absl},{0x4d,JIT_EOR,absl},{0x4e,JIT_LSR,absl},{0x50,JIT_BVC,rel},{0x55,JIT_EOR,zpx},
+	{0x56,JIT_LSR,zpx},{0x59,JIT_EOR,absy},{0x5a,JIT_PHY,impl},{0x5d,JIT_EOR,absx},{0x5e,JIT_LSR,absx},{0x60,JIT_RTS,impl},
+	{0x64,JIT_STZ,zp},{0x65,JIT_ADC,zp},{0x66,JIT_ROR,zp},{0x68,JIT_PLA,impl},{0x69,JIT_ADC,imm},{0x6a,JIT_ROR,accu},
+	{0x6d,JIT_ADC,absl},{0x6e,JIT_ROR,absl},{0x70,JIT_BVS,rel},{0x74,JIT_STZ,zpx},{0x75,JIT_ADC,zpx},{0x76,JIT_ROR,zpx},
+	{0x78,JIT_SEI,impl},{0x79,JIT_ADC,absy},{0x7a,JIT_PLY,impl},{0x7d,JIT_ADC,absx},{0x7e,JIT_ROR,absx},{0x80,JIT_BRA,rel},
+	{0x84,JIT_STY,zp},{0x85,JIT_STA,zp},{0x86,JIT_STX,zp},{0x88,JIT_DEY,impl},{0x89,JIT_BIT,imm},{0x8a,JIT_TXA,impl},
+	{0x8c,JIT_STY,absl},{0x8d,JIT_STA,absl},{0x8e,JIT_STX,absl},{0x90,JIT_BCC,rel},{0x94,JIT_STY,zpx},{0x95,JIT_STA,zpx},
+	{0x96,JIT_STX,zpy},{0x98,JIT_TYA,impl},{0x99,JIT_STA,absy},{0x9a,JIT_TXS,impl},{0x9c,JIT_STZ,absl},{0x9d,JIT_STA,absx},
+	{0x9e,JIT_STZ,absx},{0xa0,JIT_LDY,imm},{0xa2,JIT_LDX,imm},{0xa4,JIT_LDY,zp},{0xa5,JIT_LDA,zp},{0xa6,JIT_LDX,zp},
+	{0xa8,JIT_TAY,impl},{0xa9,JIT_LDA,imm},{0xaa,JIT_TAX,impl},{0xac,JIT_LDY,absl},{0xad,JIT_LDA,absl},{0xae,JIT_LDX,absl},
+	{0xb0,JIT_BCS,rel},{0xb4,JIT_LDY,zpx},{0xb5,JIT_LDA,zpx},{0xb6,JIT_LDX,zpy},{0xb8,JIT_CLV,impl},{0xb9,JIT_LDA,absy},
+	{0xba,JIT_TSX,impl},{0xbc,JIT_LDY,absx},{0xbd,JIT_LDA,absx},{0xbe,JIT_LDX,absy},{0xc0,JIT_CPY,imm},{0xc4,JIT_CPY,zp},
+	{0xc5,JIT_CMP,zp},{0xc6,JIT_DEC,zp},{0xc8,JIT_INY,impl},{0xc9,JIT_CMP,imm},{0xca,JIT_DEX,impl},{0xcc,JIT_CPY,absl},
+	{0xcd,JIT_CMP,absl},{0xce,JIT_DEC,absl},{0xd0,JIT_BNE,rel},{0xd5,JIT_CMP,zpx},{0xd6,JIT_DEC,zpx},{0xd8,JIT_CLD,impl},
+	{0xd9,JIT_CMP,absy},{0xda,JIT_PHX,impl},{0xdd,JIT_CMP,absx},{0xde,JIT_DEC,absx},{0xe0,JIT_CPX,imm},{0xe4,JIT_CPX,zp},
+	{0xe5,JIT_SBC,zp},{0xe6,JIT_INC,zp},{0xe8,JIT_INX,impl},{0xe9,JIT_SBC,imm},{0xea,JIT_NOP,impl},{0xec,JIT_CPX,absl},
+	{0xed,JIT_SBC,absl},{0xee,JIT_INC,absl},{0xf0,JIT_BEQ,rel},{0xf5,JIT_SBC,zpx},{0xf6,JIT_INC,zpx},{0xf8,JIT_SED,impl},
+	{0xf9,JIT_SBC,absy},{0xfa,JIT_PLX,impl},{0xfd,JIT_SBC,absx},{0xfe,JIT_INC,absx}
+};
+
+static C6502_JIT_OP cpuJitTable[256];
+
+class CJitEmitter
+{
+	public:
+		CJitEmitter(UBYTE *code,const C6502_JIT_LAYOUT &layout)
+			:mpCode(code),
+			mLayout(layout)
+		{
+		};
+
+		inline UBYTE* Here(void) { return mpCode; };
+
+		//
+		// Raw instructions
+		//
+		inline void Byte(ULONG data) { *mpCode++=(UBYTE)data; };
+		inline void Long(ULONG data) { for(int loop=0;loop<32;loop+=8) Byte(data>>loop); };
+		inline void Quad(UCYCLE data) { Long((ULONG)(data&0xffffffff)); Long((ULONG)(data>>32)); };
+
+		// mov reg,[rbx+member], mov [rbx+member],reg and mov dword [rbx+member],imm
+		inline void Load(ULONG reg,ULONG member) { Byte(0x8b); Byte(0x83|(reg<<3)); Long(member); };
+		inline void Store(ULONG member,ULONG reg) { Byte(0x89); Byte(0x83|(reg<<3)); Long(member); };
+		inline void StoreImm(ULONG member,ULONG data) { Byte(0xc7); Byte(0x83); Long(member); Long(data); };
+		// cmp dword [rbx+member],0
+		inline void Test(ULONG member) { Byte(0x83); Byte(0xbb); Long(member); Byte(0); };
+		// op reg,[rbx+member] for 0b or, 23 and, 33 xor
+		inline void OpMember(ULONG opcode,ULONG reg,ULONG member) { Byte(opcode); Byte(0x83|(reg<<3)); Long(member); };
+		// op dst,src for 01 add, 09 or, 21 and, 29 sub, 31 xor, 39 cmp, 85 test, 89 mov
+		inline void Op(ULONG opcode,ULONG dst,ULONG src) { Byte(opcode); Byte(0xc0|(src<<3)|dst); };
+		// op reg,imm for /0 add, /1 or, /4 and, /5 sub, /6 xor
+		inline void OpImm(ULONG op,ULONG reg,ULONG data) { Byte(0x81); Byte(0xc0|(op<<3)|reg); Long(data); };
+		inline void MovImm(ULONG reg,ULONG data) { Byte(0xb8+reg); Long(data); };
+		// shl /4 and shr /5
+		inline void Shift(ULONG op,ULONG reg,ULONG count) { Byte(0xc1); Byte(0xc0|(op<<3)|reg); Byte(count); };
+		inline void Not(ULONG reg) { Byte(0xf7); Byte(0xd0|reg); };
+		// setcc and zero extend, eax, ecx or edx only
+		inline void Set(ULONG cc,ULONG reg) { Byte(0x0f); Byte(0x90|cc); Byte(0xc0|reg); Byte(0x0f); Byte(0xb6); Byte(0xc0|(reg<<3)|reg); };
+		// cmovcc dst,src
+		inline void Select(ULONG cc,ULONG dst,ULONG src) { Byte(0x0f); Byte(0x40|cc); Byte(0xc0|(dst<<3)|src); };
+		// movzx reg,byte [r12+addr] and movzx reg,byte [r12+rcx]
+		inline void LoadRam(ULONG reg,ULONG addr) { Byte(0x41); Byte(0x0f); Byte(0xb6); Byte(0x84|(reg<<3)); Byte(0x24); Long(addr); };
+		inline void LoadRamIndexed(ULONG reg) { Byte(0x41); Byte(0x0f); Byte(0xb6); Byte(0x04|(reg<<3)); Byte(0x0c); };
+		// mov byte [r12+addr],al and mov byte [r12+rcx],al
+		inline void StoreRam(ULONG addr) { Byte(0x41); Byte(0x88); Byte(0x84); Byte(0x24); Long(addr); };
+		inline void StoreRamIndexed(void) { Byte(0x41); Byte(0x88); Byte(0x04); Byte(0x0c); };
+		// Forward jcc and jmp, answers the offset to fill in with Land()
+		inline UBYTE* Jump(ULONG cc) { Byte(0x0f); Byte(0x80|cc); Long(0); return mpCode-4; };
+		inline UBYTE* Jump(void) { Byte(0xe9); Long(0); return mpCode-4; };
+		inline void Land(UBYTE *offset) { ULONG rel=mpCode-(offset+4); for(int loop=0;loop<4;loop++) offset[loop]=(UBYTE)(rel>>(loop*8)); };
+
+		inline void Prologue(void)
+		{
+			Byte(0x53);										// push rbx
+			Byte(0x41); Byte(0x54);							// push r12
+			Byte(0x48); Byte(0x83); Byte(0xec); Byte(0x08);	// sub rsp,8
+			Byte(0x48); Byte(0x89); Byte(0xfb);				// mov rbx,rdi
+			Byte(0x4c); Byte(0x8b); Byte(0xa3); Long(mLayout.Ram);	// mov r12,[rbx+ram]
+		};
+
+		inline void Epilogue(void)
+		{
+			Byte(0x48); Byte(0x83); Byte(0xc4); Byte(0x08);	// add rsp,8
+			Byte(0x41); Byte(0x5c);							// pop r12
+			Byte(0x5b);										// pop rbx
+			Byte(0xc3);										// ret
+		};
+
+		// gSystemCycleCount+=cycles
+		inline void Cycles(ULONG cycles)
+		{
+			Byte(0x48); Byte(0xb8); Quad((UCYCLE)&gSystemCycleCount);
+			Byte(0x48); Byte(0x81); Byte(0x00); Long(cycles);
+		};
+
+		// JitService(cpu,esi)
+		inline void Service(void)
+		{
+			Byte(0x48); Byte(0x89); Byte(0xdf);
+			Byte(0x48); Byte(0xb8); Quad((UCYCLE)&C65C02::JitService);
+			Byte(0xff); Byte(0xd0);
+		};
+
+		//
+		// 65C02 building blocks
+		//
+
+		// Z and N from eax
+		inline void SetNZ(void)
+		{
+			Op(0x85,X86_EAX,X86_EAX);
+			Set(X86_E,X86_EDX);
+			Store(mLayout.Z,X86_EDX);
+			Op(0x89,X86_EDX,X86_EAX);
+			OpImm(4,X86_EDX,0x80);
+			Store(mLayout.N,X86_EDX);
+		};
+
+		// Work out the operand address leaving mOperand as the interpreter
+		// would, answers TRUE if it is indexed and so in ecx
+		inline bool Address(ULONG mode,ULONG operand)
+		{
+			switch(mode)
+			{
+				case zpx:
+				case zpy:
+					Load(X86_ECX,(mode==zpx)?mLayout.X:mLayout.Y);
+					OpImm(0,X86_ECX,operand);
+					OpImm(4,X86_ECX,0xff);
+					Store(mLayout.Operand,X86_ECX);
+					return TRUE;
+				case absx:
+				case absy:
+					// Folded blocks never index past the I/O area
+					Load(X86_ECX,(mode==absx)?mLayout.X:mLayout.Y);
+					OpImm(0,X86_ECX,operand);
+					Store(mLayout.Operand,X86_ECX);
+					return TRUE;
+				default:
+					StoreImm(mLayout.Operand,operand);
+					return FALSE;
+			}
+		};
+
+		// Operand value into eax
+		inline bool Read(ULONG mode,ULONG operand,ULONG pc)
+		{
+			if(mode==imm)
+			{
+				StoreImm(mLayout.Operand,pc+1);
+				MovImm(X86_EAX,operand);
+				return FALSE;
+			}
+			bool indexed=Address(mode,operand);
+			if(indexed) LoadRamIndexed(X86_EAX); else LoadRam(X86_EAX,operand);
+			return indexed;
+		};
+
+		// Store al to the operand, dropping any blocks decoded from the page
+		inline void Write(bool indexed,ULONG addr)
+		{
+			UBYTE *skip;
+			if(indexed)
+			{
+				StoreRamIndexed();
+				Op(0x89,X86_EDX,X86_ECX);
+				Shift(5,X86_EDX,8);
+				Byte(0x80); Byte(0xbc); Byte(0x13); Long(mLayout.CodePage); Byte(0);	// cmp byte [rbx+rdx+codepage],0
+				skip=Jump(X86_E);
+				Op(0x89,X86_ESI,X86_EDX);
+				OpImm(1,X86_ESI,JIT_REQ_CODEWRITE);
+			}
+			else
+			{
+				StoreRam(addr);
+				Byte(0x80); Byte(0xbb); Long(mLayout.CodePage+(addr>>8)); Byte(0);	// cmp byte [rbx+codepage+page],0
+				skip=Jump(X86_E);
+				MovImm(X86_ESI,JIT_REQ_CODEWRITE|(addr>>8));
+			}
+			Service();
+			Land(skip);
+		};
+
+		// Push al
+		inline void Push(void)
+		{
+			Load(X86_ECX,mLayout.SP);
+			Op(0x89,X86_EDX,X86_ECX);
+			OpImm(5,X86_EDX,1);
+			OpImm(4,X86_EDX,0xff);
+			Store(mLayout.SP,X86_EDX);
+			OpImm(0,X86_ECX,0x100);
+			Write(TRUE,0);
+		};
+
+		// Pull into reg, not ecx
+		inline void Pull(ULONG reg)
+		{
+			Load(X86_ECX,mLayout.SP);
+			OpImm(0,X86_ECX,1);
+			OpImm(4,X86_ECX,0xff);
+			Store(mLayout.SP,X86_ECX);
+			OpImm(0,X86_ECX,0x100);
+			LoadRamIndexed(reg);
+		};
+
+		// Read-modify-write operations on eax
+		inline void Modify(ULONG operation)
+		{
+			switch(operation)
+			{
+				case JIT_ASL:
+					Op(0x89,X86_EDX,X86_EAX);
+					OpImm(4,X86_EDX,0x80);
+					Store(mLayout.C,X86_EDX);
+					Shift(4,X86_EAX,1);
+					OpImm(4,X86_EAX,0xff);
+					break;
+				case JIT_LSR:
+					Op(0x89,X86_EDX,X86_EAX);
+					OpImm(4,X86_EDX,0x01);
+					Store(mLayout.C,X86_EDX);
+					Shift(5,X86_EAX,1);
+					break;
+				case JIT_ROL:
+					Test(mLayout.C);
+					Set(X86_NE,X86_EDX);
+					Op(0x89,X86_ESI,X86_EAX);
+					OpImm(4,X86_ESI,0x80);
+					Store(mLayout.C,X86_ESI);
+					Shift(4,X86_EAX,1);
+					Op(0x09,X86_EAX,X86_EDX);
+					OpImm(4,X86_EAX,0xff);
+					break;
+				case JIT_ROR:
+					Test(mLayout.C);
+					Set(X86_NE,X86_EDX);
+					Shift(4,X86_EDX,7);
+					Op(0x89,X86_ESI,X86_EAX);
+					OpImm(4,X86_ESI,0x01);
+					Store(mLayout.C,X86_ESI);
+					Shift(5,X86_EAX,1);
+					Op(0x09,X86_EAX,X86_EDX);
+					break;
+				case JIT_INC:
+					OpImm(0,X86_EAX,1);
+					OpImm(4,X86_EAX,0xff);
+					break;
+				case JIT_DEC:
+					OpImm(5,X86_EAX,1);
+					OpImm(4,X86_EAX,0xff);
+					break;
+			}
+		};
+
+		// Binary mode ADC of eax, see xADC()
+		inline void Adc(void)
+		{
+			Test(mLayout.C);
+			Set(X86_NE,X86_ECX);
+			Load(X86_EDX,mLayout.A);
+			Op(0x01,X86_ECX,X86_EDX);
+			Op(0x01,X86_ECX,X86_EAX);			// ecx=sum
+			Op(0x31,X86_EAX,X86_EDX);
+			Not(X86_EAX);
+			Op(0x31,X86_EDX,X86_ECX);
+			Op(0x21,X86_EAX,X86_EDX);
+			Shift(5,X86_EAX,7);
+			OpImm(4,X86_EAX,1);
+			Store(mLayout.V,X86_EAX);
+			Op(0x89,X86_EAX,X86_ECX);
+			Shift(5,X86_EAX,8);
+			Store(mLayout.C,X86_EAX);
+			Op(0x89,X86_EAX,X86_ECX);
+			OpImm(4,X86_EAX,0xff);
+			Store(mLayout.A,X86_EAX);
+			SetNZ();
+		};
+
+		// Binary mode SBC of eax, see xSBC()
+		inline void Sbc(void)
+		{
+			Test(mLayout.C);
+			Set(X86_E,X86_ECX);
+			Load(X86_EDX,mLayout.A);
+			Op(0x89,X86_ESI,X86_EDX);
+			Op(0x29,X86_ESI,X86_EAX);
+			Op(0x29,X86_ESI,X86_ECX);			// esi=sum
+			Op(0x89,X86_ECX,X86_EDX);
+			Op(0x31,X86_ECX,X86_EAX);
+			Op(0x89,X86_EAX,X86_EDX);
+			Op(0x31,X86_EAX,X86_ESI);
+			Op(0x21,X86_EAX,X86_ECX);
+			Shift(5,X86_EAX,7);
+			OpImm(4,X86_EAX,1);
+			Store(mLayout.V,X86_EAX);
+			Op(0x89,X86_EAX,X86_ESI);
+			OpImm(4,X86_EAX,0xff00);
+			Set(X86_E,X86_EAX);
+			Store(mLayout.C,X86_EAX);
+			Op(0x89,X86_EAX,X86_ESI);
+			OpImm(4,X86_EAX,0xff);
+			Store(mLayout.A,X86_EAX);
+			SetNZ();
+		};
+
+	private:
+		UBYTE				*mpCode;
+		C6502_JIT_LAYOUT	mLayout;
+};
+
+void C65C02::JitOpen(void)
+{
+	TRACE_CPU0("JitOpen()");
+	memset(cpuJitTable,0,sizeof(cpuJitTable));
+	for(ULONG loop=0;loop<sizeof(cpuJitOps)/sizeof(cpuJitOps[0]);loop++)
+	{
+		cpuJitTable[cpuJitOps[loop][0]].Operation=cpuJitOps[loop][1];
+		cpuJitTable[cpuJitOps[loop][0]].Mode=cpuJitOps[loop][2];
+	}
+
+	// Without somewhere to put native code everything is interpreted
+	mJitCode=(UBYTE*)mmap(NULL,CPU_JIT_CODE_SIZE,PROT_READ|PROT_WRITE|PROT_EXEC,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+	if(mJitCode==(UBYTE*)MAP_FAILED) mJitCode=NULL;
+	mJitUsed=0;
+	mJitBlocks=0;
+	memset(mCodeRewrites,0,sizeof(mCodeRewrites));
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+	mJitRam=new UBYTE[2*RAM_SIZE];
+	mJitMismatches=0;
+#endif
+}
+
+void C65C02::JitClose(void)
+{
+	TRACE_CPU0("JitClose()");
+	if(mJitCode) munmap(mJitCode,CPU_JIT_CODE_SIZE);
+	mJitCode=NULL;
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+	delete[] mJitRam;
+#endif
+}
+
+bool C65C02::CompileBlock(C6502_BLOCK *block)
+{
+	TRACE_CPU1("CompileBlock() PC=$%04x",block->Address);
+
+	if(!mJitCode || mJitUsed+CPU_JIT_BLOCK_CODE>CPU_JIT_CODE_SIZE) return FALSE;
+
+	// Every opcode must be understood and self modifying code is left to
+	// the interpreter, a block decoded from a page that keeps being written
+	// would only be thrown away again
+	ULONG addr=block->Address;
+	for(ULONG loop=0;loop<block->Count;loop++)
+	{
+		UBYTE opcode=block->Insn[loop].Opcode;
+		if(cpuJitTable[opcode].Operation==JIT_NONE) return FALSE;
+		if(mCodeRewrites[addr>>8]>=CPU_JIT_REWRITES) return FALSE;
+		addr+=cpuDecodeTable[opcode]&CPU_DECODE_LENGTH;
+	}
+	if(mCodeRewrites[(addr-1)>>8]>=CPU_JIT_REWRITES) return FALSE;
+
+	C6502_JIT_LAYOUT layout;
+	layout.A=(UBYTE*)&mA-(UBYTE*)this;
+	layout.X=(UBYTE*)&mX-(UBYTE*)this;
+	layout.Y=(UBYTE*)&mY-(UBYTE*)this;
+	layout.SP=(UBYTE*)&mSP-(UBYTE*)this;
+	layout.PC=(UBYTE*)&mPC-(UBYTE*)this;
+	layout.Opcode=(UBYTE*)&mOpcode-(UBYTE*)this;
+	layout.Operand=(UBYTE*)&mOperand-(UBYTE*)this;
+	layout.N=(UBYTE*)&mN-(UBYTE*)this;
+	layout.V=(UBYTE*)&mV-(UBYTE*)this;
+	layout.D=(UBYTE*)&mD-(UBYTE*)this;
+	layout.I=(UBYTE*)&mI-(UBYTE*)this;
+	layout.Z=(UBYTE*)&mZ-(UBYTE*)this;
+	layout.C=(UBYTE*)&mC-(UBYTE*)this;
+	layout.CodePage=(UBYTE*)mCodePage-(UBYTE*)this;
+	layout.Ram=(UBYTE*)&mRamPointer-(UBYTE*)this;
+
+	UBYTE *code=mJitCode+mJitUsed;
+	CJitEmitter emit(code,layout);
+	bool flow=FALSE;
+
+	emit.Prologue();
+	addr=block->Address;
+	for(ULONG loop=0;loop<block->Count;loop++)
+	{
+		C6502_INSN *insn=&block->Insn[loop];
+		ULONG operation=cpuJitTable[insn->Opcode].Operation;
+		ULONG mode=cpuJitTable[insn->Opcode].Mode;
+		ULONG operand=insn->Operand;
+		ULONG reg;
+		bool indexed;
+
+		switch(operation)
+		{
+			case JIT_LDA:
+			case JIT_LDX:
+			case JIT_LDY:
+				reg=(operation==JIT_LDA)?layout.A:(operation==JIT_LDX)?layout.X:layout.Y;
+				emit.Read(mode,operand,addr);
+				emit.Store(reg,X86_EAX);
+				emit.SetNZ();
+				break;
+			case JIT_STA:
+			case JIT_STX:
+			case JIT_STY:
+			case JIT_STZ:
+				indexed=emit.Address(mode,operand);
+				if(operation==JIT_STZ) emit.MovImm(X86_EAX,0);
+				else emit.Load(X86_EAX,(operation==JIT_STA)?layout.A:(operation==JIT_STX)?layout.X:layout.Y);
+				emit.Write(indexed,operand);
+				break;
+			case JIT_ORA:
+			case JIT_AND:
+			case JIT_EOR:
+				emit.Read(mode,operand,addr);
+				emit.OpMember((operation==JIT_ORA)?0x0b:(operation==JIT_AND)?0x23:0x33,X86_EAX,layout.A);
+				emit.Store(layout.A,X86_EAX);
+				emit.SetNZ();
+				break;
+			case JIT_ADC:
+			case JIT_SBC:
+			{
+				// Decimal mode goes back to the interpreter's arithmetic
+				ULONG request=(operation==JIT_ADC)?JIT_REQ_ADC:JIT_REQ_SBC;
+				indexed=FALSE;
+				if(mode==imm) emit.StoreImm(layout.Operand,addr+1);
+				else indexed=emit.Address(mode,operand);
+				emit.Test(layout.D);
+				UBYTE *binary=emit.Jump(X86_E);
+				if(indexed)
+				{
+					emit.Op(0x89,X86_ESI,X86_ECX);
+					emit.OpImm(1,X86_ESI,request);
+				}
+				else emit.MovImm(X86_ESI,request|((mode==imm)?addr+1:operand));
+				emit.Service();
+				UBYTE *done=emit.Jump();
+				emit.Land(binary);
+				if(mode==imm) emit.MovImm(X86_EAX,operand);
+				else if(indexed) emit.LoadRamIndexed(X86_EAX);
+				else emit.LoadRam(X86_EAX,operand);
+				if(operation==JIT_ADC) emit.Adc(); else emit.Sbc();
+				emit.Land(done);
+				break;
+			}
+			case JIT_CMP:
+			case JIT_CPX:
+			case JIT_CPY:
+				emit.Read(mode,operand,addr);
+				emit.Load(X86_EDX,(operation==JIT_CMP)?layout.A:(operation==JIT_CPX)?layout.X:layout.Y);
+				emit.Op(0x39,X86_EDX,X86_EAX);
+				emit.Set(X86_AE,X86_ECX);
+				emit.Store(layout.C,X86_ECX);
+				emit.Op(0x29,X86_EDX,X86_EAX);
+				emit.OpImm(4,X86_EDX,0xff);
+				emit.Op(0x89,X86_EAX,X86_EDX);
+				emit.SetNZ();
+				break;
+			case JIT_BIT:
+				emit.Read(mode,operand,addr);
+				emit.Load(X86_EDX,layout.A);
+				emit.Op(0x85,X86_EDX,X86_EAX);
+				emit.Set(X86_E,X86_EDX);
+				emit.Store(layout.Z,X86_EDX);
+				if(mode!=imm)
+				{
+					emit.Op(0x89,X86_EDX,X86_EAX);
+					emit.OpImm(4,X86_EDX,0x80);
+					emit.Store(layout.N,X86_EDX);
+					emit.OpImm(4,X86_EAX,0x40);
+					emit.Store(layout.V,X86_EAX);
+				}
+				break;
+			case JIT_ASL:
+			case JIT_LSR:
+			case JIT_ROL:
+			case JIT_ROR:
+			case JIT_INC:
+			case JIT_DEC:
+				indexed=FALSE;
+				if(mode==accu) emit.Load(X86_EAX,layout.A);
+				else indexed=emit.Read(mode,operand,addr);
+				emit.Modify(operation);
+				emit.SetNZ();
+				if(mode==accu) emit.Store(layout.A,X86_EAX);
+				else emit.Write(indexed,operand);
+				break;
+			case JIT_TSB:
+			case JIT_TRB:
+				indexed=emit.Read(mode,operand,addr);
+				emit.Load(X86_EDX,layout.A);
+				emit.Op(0x85,X86_EDX,X86_EAX);
+				emit.Set(X86_E,X86_EDX);
+				emit.Store(layout.Z,X86_EDX);
+				if(operation==JIT_TSB)
+				{
+					emit.OpMember(0x0b,X86_EAX,layout.A);
+				}
+				else
+				{
+					emit.Load(X86_EDX,layout.A);
+					emit.OpImm(6,X86_EDX,0xff);
+					emit.Op(0x21,X86_EAX,X86_EDX);
+				}
+				emit.Write(indexed,operand);
+				break;
+			case JIT_TAX:
+			case JIT_TAY:
+			case JIT_TXA:
+			case JIT_TYA:
+			case JIT_TSX:
+			case JIT_TXS:
+				switch(operation)
+				{
+					case JIT_TAX: emit.Load(X86_EAX,layout.A); emit.Store(layout.X,X86_EAX); break;
+					case JIT_TAY: emit.Load(X86_EAX,layout.A); emit.Store(layout.Y,X86_EAX); break;
+					case JIT_TXA: emit.Load(X86_EAX,layout.X); emit.Store(layout.A,X86_EAX); break;
+					case JIT_TYA: emit.Load(X86_EAX,layout.Y); emit.Store(layout.A,X86_EAX); break;
+					case JIT_TSX: emit.Load(X86_EAX,layout.SP); emit.Store(layout.X,X86_EAX); break;
+					case JIT_TXS: emit.Load(X86_EAX,layout.X); emit.Store(layout.SP,X86_EAX); break;
+				}
+				if(operation!=JIT_TXS) emit.SetNZ();
+				break;
+			case JIT_INX:
+			case JIT_INY:
+			case JIT_DEX:
+			case JIT_DEY:
+				reg=(operation==JIT_INX || operation==JIT_DEX)?layout.X:layout.Y;
+				emit.Load(X86_EAX,reg);
+				emit.Modify((operation==JIT_INX || operation==JIT_INY)?JIT_INC:JIT_DEC);
+				emit.Store(reg,X86_EAX);
+				emit.SetNZ();
+				break;
+			case JIT_CLC: emit.StoreImm(layout.C,FALSE); break;
+			case JIT_SEC: emit.StoreImm(layout.C,TRUE); break;
+			case JIT_CLD: emit.StoreImm(layout.D,FALSE); break;
+			case JIT_SED: emit.StoreImm(layout.D,TRUE); break;
+			case JIT_CLV: emit.StoreImm(layout.V,FALSE); break;
+			case JIT_SEI: emit.StoreImm(layout.I,TRUE); break;
+			case JIT_NOP: break;
+			case JIT_PHA:
+			case JIT_PHX:
+			case JIT_PHY:
+				emit.Load(X86_EAX,(operation==JIT_PHA)?layout.A:(operation==JIT_PHX)?layout.X:layout.Y);
+				emit.Push();
+				break;
+			case JIT_PHP:
+				emit.MovImm(X86_ESI,JIT_REQ_PHP);
+				emit.Service();
+				break;
+			case JIT_PLA:
+			case JIT_PLX:
+			case JIT_PLY:
+				emit.Pull(X86_EAX);
+				emit.Store((operation==JIT_PLA)?layout.A:(operation==JIT_PLX)?layout.X:layout.Y,X86_EAX);
+				emit.SetNZ();
+				break;
+			case JIT_JSR:
+				emit.StoreImm(layout.Operand,operand);
+				emit.MovImm(X86_EAX,(addr+2)>>8);
+				emit.Push();
+				emit.MovImm(X86_EAX,(addr+2)&0xff);
+				emit.Push();
+				emit.StoreImm(layout.PC,operand);
+				flow=TRUE;
+				break;
+			case JIT_RTS:
+				emit.Pull(X86_EAX);
+				emit.Pull(X86_EDX);
+				emit.Shift(4,X86_EDX,8);
+				emit.Op(0x09,X86_EAX,X86_EDX);
+				emit.OpImm(0,X86_EAX,1);
+				emit.Store(layout.PC,X86_EAX);
+				flow=TRUE;
+				break;
+			case JIT_JMP:
+				emit.StoreImm(layout.Operand,operand);
+				emit.StoreImm(layout.PC,operand);
+				flow=TRUE;
+				break;
+			case JIT_BRA:
+				emit.StoreImm(layout.PC,(addr+2+(signed char)operand)&0xffff);
+				flow=TRUE;
+				break;
+			default:
+			{
+				// Conditional branches pick the new PC without jumping
+				ULONG flag,cc;
+				switch(operation)
+				{
+					case JIT_BPL: flag=layout.N; cc=X86_E; break;
+					case JIT_BMI: flag=layout.N; cc=X86_NE; break;
+					case JIT_BVC: flag=layout.V; cc=X86_E; break;
+					case JIT_BVS: flag=layout.V; cc=X86_NE; break;
+					case JIT_BCC: flag=layout.C; cc=X86_E; break;
+					case JIT_BCS: flag=layout.C; cc=X86_NE; break;
+					case JIT_BNE: flag=layout.Z; cc=X86_E; break;
+					default: flag=layout.Z; cc=X86_NE; break;
+				}
+				emit.MovImm(X86_EAX,(addr+2)&0xffff);
+				emit.MovImm(X86_EDX,(addr+2+(signed char)operand)&0xffff);
+				emit.Test(flag);
+				emit.Select(cc,X86_EAX,X86_EDX);
+				emit.Store(layout.PC,X86_EAX);
+				flow=TRUE;
+				break;
+			}
+		}
+		addr+=cpuDecodeTable[insn->Opcode]&CPU_DECODE_LENGTH;
+	}
+
+	if(!flow) emit.StoreImm(layout.PC,addr);
+	emit.StoreImm(layout.Opcode,block->Insn[block->Count-1].Opcode);
+	emit.Cycles(block->Cycles);
+	emit.Epilogue();
+
+	block->Native=(void (*)(C65C02*))code;
+	mJitUsed=(emit.Here()-mJitCode+15)&~15;
+	mJitBlocks++;
+	return TRUE;
+}
+
+//
+// Entry point for the generated code when it needs the interpreter's help
+//
+void C65C02::JitService(C65C02 *cpu,ULONG request)
+{
+	cpu->JitRequest(request);
+}
+
+void C65C02::JitRequest(ULONG request)
+{
+	switch(request&0xffff0000)
+	{
+		case JIT_REQ_CODEWRITE:
+			InvalidateCodePage(request&0xff);
+			break;
+		case JIT_REQ_ADC:
+			mOperand=request&0xffff;
+			xADC();
+			break;
+		case JIT_REQ_SBC:
+			mOperand=request&0xffff;
+			xSBC();
+			break;
+		case JIT_REQ_PHP:
+			xPHP();
+			break;
+	}
+}
+
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+
+//
+// Run the block through the interpreter, rewind and run the native code,
+// then insist both left the same registers, flags, cycle count and RAM and
+// dropped the same decoded code pages
+//
+void C65C02::JitLockstep(C6502_BLOCK *block)
+{
+	int *regs[]={&mA,&mX,&mY,&mSP,&mOpcode,&mOperand,&mPC,&mN,&mV,&mB,&mD,&mI,&mZ,&mC};
+	const ULONG count=sizeof(regs)/sizeof(regs[0]);
+	int before[count];
+	int expect[count];
+	UBYTE pages[2][256];
+	UBYTE expectpages[2][256];
+	UBYTE *ram=mJitRam;
+	UBYTE *expectram=mJitRam+RAM_SIZE;
+	UCYCLE cycles=gSystemCycleCount;
+	bool match=TRUE;
+
+	for(ULONG loop=0;loop<count;loop++) before[loop]=*regs[loop];
+	memcpy(ram,mRamPointer,RAM_SIZE);
+	memcpy(pages[0],mCodePage,256);
+	memcpy(pages[1],mCodeRewrites,256);
+
+	RunFolded(block);
+
+	UCYCLE expectcycles=gSystemCycleCount;
+	for(ULONG loop=0;loop<count;loop++) expect[loop]=*regs[loop];
+	memcpy(expectram,mRamPointer,RAM_SIZE);
+	memcpy(expectpages[0],mCodePage,256);
+	memcpy(expectpages[1],mCodeRewrites,256);
+
+	for(ULONG loop=0;loop<count;loop++) *regs[loop]=before[loop];
+	memcpy(mRamPointer,ram,RAM_SIZE);
+	memcpy(mCodePage,pages[0],256);
+	memcpy(mCodeRewrites,pages[1],256);
+	gSystemCycleCount=cycles;
+
+	block->Native(this);
+
+	for(ULONG loop=0;loop<count;loop++) if(*regs[loop]!=expect[loop]) match=FALSE;
+	if(gSystemCycleCount!=expectcycles) match=FALSE;
+	if(memcmp(mRamPointer,expectram,RAM_SIZE)) match=FALSE;
+	if(memcmp(mCodePage,expectpages[0],256) || memcmp(mCodeRewrites,expectpages[1],256)) match=FALSE;
+
+	if(!match)
+	{
+		// Report it and carry on from the interpreter's result
+		char message[1024];
+		sprintf(message,"C65C02::JitLockstep() - Native code for the block at PC=$%04x differs from the interpreter.",(int)block->Address);
+		gError->Warning(message);
+		mJitMismatches++;
+
+		for(ULONG loop=0;loop<count;loop++) *regs[loop]=expect[loop];
+		memcpy(mRamPointer,expectram,RAM_SIZE);
+		memcpy(mCodePage,expectpages[0],256);
+		memcpy(mCodeRewrites,expectpages[1],256);
+		gSystemCycleCount=expectcycles;
+	}
+}
+
+#endif
+
+#endif
+
+#endif
+
 bool C65C02::ContextSave(FILE *fp)
 {
   TRACE_CPU0("ContextSave()");
@@ -84,6 +1013,9 @@ bool C65C02::ContextSave(FILE *fp)
 bool C65C02::ContextLoad(LSS_FILE *fp)
 {
   TRACE_CPU0("ContextLoad()");
+#ifdef HANDY_BLOCK_CACHE
+  FlushBlockCache();
+#endif
   int mPS;
   char teststr[100]="XXXXXXXXXXXXXXXXXX";
   if(!lss_read(teststr,sizeof(char),18,fp)) return 0;
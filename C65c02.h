@@ -74,6 +74,15 @@
 
 #define MAX_CPU_BREAKPOINTS	8
 
+//
+// The debugger needs to see every instruction so the block cache is never
+// used in debug builds
+//
+
+#ifdef _LYNXDBG
+#undef HANDY_BLOCK_CACHE
+#endif
+
 //
 // ACCESS MACROS
 //
@@ -84,7 +93,93 @@
 
 #define CPU_PEEK(m)				(((m<0xfc00)?mRamPointer[m]:mSystem.Peek_CPU(m)))
 #define CPU_PEEKW(m)			(((m<0xfc00)?(mRamPointer[m]+(mRamPointer[m+1]<<8)):mSystem.PeekW_CPU(m)))
+#ifdef HANDY_BLOCK_CACHE
+#define CPU_POKE(m1,m2)			{if(m1<0xfc00) {mRamPointer[m1]=m2; CodeWrite(m1);} else mSystem.Poke_CPU(m1,m2);}
+#else
 #define CPU_POKE(m1,m2)			{if(m1<0xfc00) mRamPointer[m1]=m2; else mSystem.Poke_CPU(m1,m2);}
+#endif
+
+//
+// Instruction stream access, operands are always fetched from mPC
+// except when running from the block cache where they are predecoded
+//
+
+#define CPU_FETCH()				CPU_PEEK(mPC)
+#define CPU_FETCHW()			CPU_PEEKW(mPC)
+#define CPU_CYCLES(c)			gSystemCycleCount+=(c)
+
+//
+// Block cache, straight line code below the I/O area is decoded once into
+// blocks of opcode/operand pairs keyed by start address. A block ends on any
+// change of program flow, an illegal opcode or when it is full.
+//
+// Blocks that cannot touch I/O, the interrupt mask or their own code are
+// marked as folded, when such a block completes before the next timer event
+// it is run without any per instruction checks and its cycles are charged
+// in one go at the end.
+//
+
+//
+// Hot folded blocks can be recompiled to x86-64 code, the recompiler needs
+// the block cache and an executable mapping so it is only built on x86-64
+// Linux. Blocks that use anything the recompiler does not handle, and code
+// in pages that keep being rewritten, stay with the interpreter. Building
+// with HANDY_CPU_JIT_LOCKSTEP as well runs every recompiled block through
+// the interpreter first and checks both leave the same CPU state and RAM.
+//
+
+#if !defined(HANDY_BLOCK_CACHE) || !defined(__x86_64__) || !defined(__linux__)
+#undef HANDY_CPU_JIT
+#endif
+
+#ifndef HANDY_CPU_JIT
+#undef HANDY_CPU_JIT_LOCKSTEP
+#endif
+
+#ifdef HANDY_BLOCK_CACHE
+
+#define CPU_BLOCK_LIMIT		0xfc00
+#define CPU_BLOCK_MAX_INSN	16
+#define CPU_BLOCK_POOL		4096
+
+#define CPU_DECODE_LENGTH	0x03
+#define CPU_DECODE_INDEXED	0x04
+#define CPU_DECODE_ABSOLUTE	0x08
+#define CPU_DECODE_LOWRAM	0x10
+#define CPU_DECODE_WRITE	0x20
+#define CPU_DECODE_DYNAMIC	0x40
+#define CPU_DECODE_FLOW		0x80
+
+#ifdef HANDY_CPU_JIT
+#define CPU_JIT_HOT			16				// Folded runs before a block is recompiled
+#define CPU_JIT_REWRITES	8				// Code rewrites before a page is left alone
+#define CPU_JIT_CODE_SIZE	(4*1024*1024)
+#define CPU_JIT_BLOCK_CODE	4096			// Worst case native code for one block
+
+class C65C02;
+#endif
+
+typedef struct
+{
+	UBYTE	Opcode;
+	UWORD	Operand;
+}C6502_INSN;
+
+typedef struct
+{
+	ULONG		Count;
+	ULONG		Folded;		// Safe to run without per instruction checks
+	ULONG		Cycles;		// Cycles for the whole block
+	ULONG		Lead;		// Cycles for all but the last instruction
+	ULONG		Address;	// Address of the first instruction
+#ifdef HANDY_CPU_JIT
+	ULONG		Runs;		// Folded runs so far
+	void		(*Native)(C65C02 *cpu);	// Recompiled code if any
+#endif
+	C6502_INSN	Insn[CPU_BLOCK_MAX_INSN];
+}C6502_BLOCK;
+
+#endif
 
 
 enum {	illegal=0,
@@ -148,6 +243,13 @@ class C65C02
 #ifdef _LYNXDBG
 			for(int loop=0;loop<MAX_CPU_BREAKPOINTS;loop++)	mPcBreakpoints[loop]=0xfffffff;
 			mDbgFlag=0;
+#endif
+#ifdef HANDY_BLOCK_CACHE
+			mBlockIndex=new UWORD[CPU_BLOCK_LIMIT];
+			mBlockPool=new C6502_BLOCK[CPU_BLOCK_POOL];
+#endif
+#ifdef HANDY_CPU_JIT
+			JitOpen();
 #endif
 			Reset();
 			
@@ -156,6 +258,13 @@ class C65C02
 		~C65C02()
 		{
 			TRACE_CPU0("~C65C02()");
+#ifdef HANDY_BLOCK_CACHE
+			delete[] mBlockIndex;
+			delete[] mBlockPool;
+#endif
+#ifdef HANDY_CPU_JIT
+			JitClose();
+#endif
 		}
 
 	public:
@@ -183,6 +292,9 @@ class C65C02
 			gSystemIRQ=FALSE;
 			gSystemCPUSleep=FALSE;
 			gSystemCPUSleep_Saved=FALSE;
+#ifdef HANDY_BLOCK_CACHE
+			FlushBlockCache();
+#endif
 		}
 
 		bool ContextSave(FILE *fp);
@@ -242,6 +354,23 @@ class C65C02
 	//			
 	if(gSystemCPUSleep) return;
 
+#ifdef HANDY_BLOCK_CACHE
+	//
+	// Run from the block cache if this code has been decoded
+	//
+	if(mPC<CPU_BLOCK_LIMIT)
+	{
+		C6502_BLOCK *block;
+		UWORD index=mBlockIndex[mPC];
+		block=(index)?&mBlockPool[index-1]:DecodeBlock(mPC);
+		if(block)
+		{
+			ExecuteBlock(block);
+			return;
+		}
+	}
+#endif
+
 	// Fetch opcode
 	mOpcode=CPU_PEEK(mPC);
 	TRACE_CPU2("Update() PC=$%04x, Opcode=%02x",mPC,mOpcode);
@@ -252,1383 +381,7 @@ class C65C02
 	switch(mOpcode)
 	{
 
-//
-// 0x00
-//
-		case 0x00:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			// IMPLIED
-			xBRK();
-			break;
-		case 0x01:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xORA();
-			break;
-		case 0x02:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x03:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x04:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xTSB();
-			break;
-		case 0x05:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xORA();
-			break;
-		case 0x06:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xASL();
-			break;
-		case 0x07:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x08:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			// IMPLIED
-			xPHP();
-			break;
-		case 0x09:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xORA();
-			break;
-		case 0x0A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xASLA();
-			break;
-		case 0x0B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x0C:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xTSB();
-			break;
-		case 0x0D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xORA();
-			break;
-		case 0x0E:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xASL();
-			break;
-		case 0x0F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x10
-//
-		case 0x10:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBPL();
-			break;
-		case 0x11:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xORA();
-			break;
-		case 0x12:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xORA();
-			break;
-		case 0x13:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x14:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xTRB();
-			break;
-		case 0x15:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xORA();
-			break;
-		case 0x16:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xASL();
-			break;
-		case 0x17:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x18:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xCLC();
-			break;
-		case 0x19:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xORA();
-			break;
-		case 0x1A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xINCA();
-			break;
-		case 0x1B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x1C:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xTRB();
-			break;
-		case 0x1D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xORA();
-			break;
-		case 0x1E:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xASL();
-			break;
-		case 0x1F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x20
-//
-		case 0x20:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xJSR();
-			break;
-		case 0x21:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xAND();
-			break;
-		case 0x22:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x23:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x24:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xBIT();
-			break;
-		case 0x25:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xAND();
-			break;
-		case 0x26:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xROL();
-			break;
-		case 0x27:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x28:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// IMPLIED
-			xPLP();
-			break;
-		case 0x29:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xAND();
-			break;
-		case 0x2A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xROLA();
-			break;
-		case 0x2B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x2C:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xBIT();
-			break;
-		case 0x2D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xAND();
-			break;
-		case 0x2E:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xROL();
-			break;
-		case 0x2F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x30
-//
-		case 0x30:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBMI();
-			break;
-		case 0x31:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xAND();
-			break;
-		case 0x32:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xAND();
-			break;
-		case 0x33:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x34:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xBIT();
-			break;
-		case 0x35:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xAND();
-			break;
-		case 0x36:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xROL();
-			break;
-		case 0x37:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x38:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xSEC();
-			break;
-		case 0x39:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xAND();
-			break;
-		case 0x3A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xDECA();
-			break;
-		case 0x3B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x3C:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xBIT();
-			break;
-		case 0x3D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xAND();
-			break;
-		case 0x3E:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xROL();
-			break;
-		case 0x3F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x40
-//
-		case 0x40:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			// Only clear IRQ if this is not a BRK instruction based RTI
-
-			// B flag is on the stack cant test the flag
-			int tmp;
-			PULL(tmp);
-			PUSH (tmp);
-			if(!(tmp&0x10))
-			{
-				gSystemCPUSleep=gSystemCPUSleep_Saved;
-
-				// If were in sleep mode then we need to push the 
-				// wakeup counter along by the same number of cycles
-				// we have used during the sleep period
-				if(gSystemCPUSleep)
-				{
-					gCPUWakeupTime+=gSystemCycleCount-gIRQEntryCycle;
-				}
-			}
-			// IMPLIED
-			xRTI();
-			break;
-		case 0x41:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xEOR();
-			break;
-		case 0x42:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x43:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x44:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x45:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xEOR();
-			break;
-		case 0x46:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xLSR();
-			break;
-		case 0x47:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x48:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			// IMPLIED
-			xPHA();
-			break;
-		case 0x49:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xEOR();
-			break;
-		case 0x4A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xLSRA();
-			break;
-		case 0x4B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x4C:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xJMP();
-			break;
-		case 0x4D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xEOR();
-			break;
-		case 0x4E:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xLSR();
-			break;
-		case 0x4F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x50
-//
-		case 0x50:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBVC();
-			break;
-		case 0x51:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xEOR();
-			break;
-		case 0x52:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xEOR();
-			break;
-		case 0x53:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x54:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x55:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xEOR();
-			break;
-		case 0x56:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xLSR();
-			break;
-		case 0x57:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x58:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xCLI();
-			break;
-		case 0x59:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xEOR();
-			break;
-		case 0x5A:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			// IMPLIED
-			xPHY();
-			break;
-		case 0x5B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x5C:
-			gSystemCycleCount+=(1+(7*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x5D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xEOR();
-			break;
-		case 0x5E:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xLSR();
-			break;
-		case 0x5F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x60
-//
-		case 0x60:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			// IMPLIED
-			xRTS();
-			break;
-		case 0x61:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xADC();
-			break;
-		case 0x62:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x63:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x64:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xSTZ();
-			break;
-		case 0x65:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xADC();
-			break;
-		case 0x66:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xROR();
-			break;
-		case 0x67:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x68:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// IMPLIED
-			xPLA();
-			break;
-		case 0x69:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xADC();
-			break;
-		case 0x6A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xRORA();
-			break;
-		case 0x6B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x6C:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_ABSOLUTE();
-			xJMP();
-			break;
-		case 0x6D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xADC();
-			break;
-		case 0x6E:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xROR();
-			break;
-		case 0x6F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x70
-//
-		case 0x70:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBVS();
-			break;
-		case 0x71:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xADC();
-			break;
-		case 0x72:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xADC();
-			break;
-		case 0x73:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x74:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xSTZ();
-			break;
-		case 0x75:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xADC();
-			break;
-		case 0x76:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xROR();
-			break;
-		case 0x77:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x78:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xSEI();
-			break;
-		case 0x79:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xADC();
-			break;
-		case 0x7A:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// IMPLIED
-			xPLY();
-			break;
-		case 0x7B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x7C:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_ABSOLUTE_X();
-			xJMP();
-			break;
-		case 0x7D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xADC();
-			break;
-		case 0x7E:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xROR();
-			break;
-		case 0x7F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x80
-//
-		case 0x80:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBRA();
-			break;
-		case 0x81:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xSTA();
-			break;
-		case 0x82:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x83:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x84:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xSTY();
-			break;
-		case 0x85:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xSTA();
-			break;
-		case 0x86:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xSTX();
-			break;
-		case 0x87:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x88:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xDEY();
-			break;
-		case 0x89:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xBIT();
-			break;
-		case 0x8A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xTXA();
-			break;
-		case 0x8B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x8C:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xSTY();
-			break;
-		case 0x8D:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xSTA();
-			break;
-		case 0x8E:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xSTX();
-			break;
-		case 0x8F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0x90
-//
-		case 0x90:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBCC();
-			break;
-		case 0x91:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xSTA();
-			break;
-		case 0x92:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xSTA();
-			break;
-		case 0x93:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x94:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xSTY();
-			break;
-		case 0x95:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xSTA();
-			break;
-		case 0x96:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_Y();
-			xSTX();
-			break;
-		case 0x97:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0x98:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xTYA();
-			break;
-		case 0x99:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xSTA();
-			break;
-		case 0x9A:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xTXS();
-			break;
-		case 0x9B:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0x9C:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xSTZ();
-			break;
-		case 0x9D:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xSTA();
-			break;
-		case 0x9E:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xSTZ();
-			break;
-		case 0x9F:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0xA0
-//
-		case 0xA0:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xLDY();
-			break;
-		case 0xA1:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xLDA();
-			break;
-		case 0xA2:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xLDX();
-			break;
-		case 0xA3:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xA4:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xLDY();
-			break;
-		case 0xA5:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xLDA();
-			break;
-		case 0xA6:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xLDX();
-			break;
-		case 0xA7:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0xA8:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xTAY();
-			break;
-		case 0xA9:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xLDA();
-			break;
-		case 0xAA:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xTAX();
-			break;
-		case 0xAB:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xAC:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xLDY();
-			break;
-		case 0xAD:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xLDA();
-			break;
-		case 0xAE:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xLDX();
-			break;
-		case 0xAF:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0xB0
-//
-		case 0xB0:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBCS();
-			break;
-		case 0xB1:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xLDA();
-			break;
-		case 0xB2:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xLDA();
-			break;
-		case 0xB3:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xB4:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xLDY();
-			break;
-		case 0xB5:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xLDA();
-			break;
-		case 0xB6:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_Y();
-			xLDX();
-			break;
-		case 0xB7:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0xB8:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xCLV();
-			break;
-		case 0xB9:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xLDA();
-			break;
-		case 0xBA:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xTSX();
-			break;
-		case 0xBB:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xBC:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xLDY();
-			break;
-		case 0xBD:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xLDA();
-			break;
-		case 0xBE:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xLDX();
-			break;
-		case 0xBF:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0xC0
-//
-		case 0xC0:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xCPY();
-			break;
-		case 0xC1:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xCMP();
-			break;
-		case 0xC2:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xC3:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xC4:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xCPY();
-			break;
-		case 0xC5:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xCMP();
-			break;
-		case 0xC6:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xDEC();
-			break;
-		case 0xC7:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0xC8:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xINY();
-			break;
-		case 0xC9:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xCMP();
-			break;
-		case 0xCA:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xDEX();
-			break;
-		case 0xCB:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xWAI();
-			break;
-		case 0xCC:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xCPY();
-			break;
-		case 0xCD:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xCMP();
-			break;
-		case 0xCE:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xDEC();
-			break;
-		case 0xCF:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0xD0
-//
-		case 0xD0:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBNE();
-			break;
-		case 0xD1:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xCMP();
-			break;
-		case 0xD2:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xCMP();
-			break;
-		case 0xD3:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xD4:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xD5:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xCMP();
-			break;
-		case 0xD6:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xDEC();
-			break;
-		case 0xD7:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0xD8:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xCLD();
-			break;
-		case 0xD9:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xCMP();
-			break;
-		case 0xDA:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			// IMPLIED
-			xPHX();
-			break;
-		case 0xDB:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xSTP();
-			break;
-		case 0xDC:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xDD:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xCMP();
-			break;
-		case 0xDE:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xDEC();
-			break;
-		case 0xDF:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0xE0
-//
-		case 0xE0:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xCPX();
-			break;
-		case 0xE1:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xINDIRECT_X();
-			xSBC();
-			break;
-		case 0xE2:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xE3:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xE4:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xCPX();
-			break;
-		case 0xE5:
-			gSystemCycleCount+=(1+(2*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xSBC();
-			break;
-		case 0xE6:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xZEROPAGE();
-			xINC();
-			break;
-		case 0xE7:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0xE8:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xINX();
-			break;
-		case 0xE9:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			xIMMEDIATE();
-			xSBC();
-			break;
-		case 0xEA:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xNOP();
-			break;
-		case 0xEB:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xEC:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xCPX();
-			break;
-		case 0xED:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xSBC();
-			break;
-		case 0xEE:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xABSOLUTE();
-			xINC();
-			break;
-		case 0xEF:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-//
-// 0xF0
-//
-		case 0xF0:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// RELATIVE (IN FUNCTION)
-			xBEQ();
-			break;
-		case 0xF1:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT_Y();
-			xSBC();
-			break;
-		case 0xF2:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			xINDIRECT();
-			xSBC();
-			break;
-		case 0xF3:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xF4:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xF5:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xSBC();
-			break;
-		case 0xF6:
-			gSystemCycleCount+=(1+(5*CPU_RDWR_CYC));
-			xZEROPAGE_X();
-			xINC();
-			break;
-		case 0xF7:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-
-		case 0xF8:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// IMPLIED
-			xSED();
-			break;
-		case 0xF9:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_Y();
-			xSBC();
-			break;
-		case 0xFA:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// IMPLIED
-			xPLX();
-			break;
-		case 0xFB:
-			gSystemCycleCount+=(1+(1*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xFC:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
-		case 0xFD:
-			gSystemCycleCount+=(1+(3*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xSBC();
-			break;
-		case 0xFE:
-			gSystemCycleCount+=(1+(6*CPU_RDWR_CYC));
-			xABSOLUTE_X();
-			xINC();
-			break;
-		case 0xFF:
-			gSystemCycleCount+=(1+(4*CPU_RDWR_CYC));
-			// *** ILLEGAL ***
-			xILLEGAL();
-			break;
+#include "C6502ops.h"
 	}
 
 #ifdef _LYNXDBG
@@ -1718,6 +471,122 @@ class C65C02
 
 		inline int GetPC(void) { return mPC; }
 
+#ifdef HANDY_BLOCK_CACHE
+		//
+		// Must be called for every write to RAM below the I/O area so that
+		// any decoded blocks covering the address are thrown away
+		//
+		inline void CodeWrite(ULONG addr)
+		{
+			if(mCodePage[addr>>8]) InvalidateCodePage(addr>>8);
+		}
+
+		void FlushBlockCache(void);
+		void InvalidateCodePage(ULONG page);
+		C6502_BLOCK* DecodeBlock(ULONG pc);
+
+#ifdef HANDY_CPU_JIT
+		void JitOpen(void);
+		void JitClose(void);
+		bool CompileBlock(C6502_BLOCK *block);
+		void JitRequest(ULONG request);
+		static void JitService(C65C02 *cpu,ULONG request);
+		inline ULONG GetJitBlocks(void) { return mJitBlocks; };
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+		void JitLockstep(C6502_BLOCK *block);
+		inline ULONG GetJitMismatches(void) { return mJitMismatches; };
+#endif
+#endif
+
+		//
+		// Run a folded block with its cycles charged in one go
+		//
+		inline void RunFolded(C6502_BLOCK *block)
+		{
+			C6502_INSN *insn=block->Insn;
+			C6502_INSN *last=insn+block->Count-1;
+
+#undef CPU_FETCH
+#undef CPU_FETCHW
+#undef CPU_CYCLES
+#define CPU_FETCH()				(insn->Operand&0xff)
+#define CPU_FETCHW()			(insn->Operand)
+#define CPU_CYCLES(c)
+			for(;insn<=last;insn++)
+			{
+				mOpcode=insn->Opcode;
+				mPC++;
+
+				switch(mOpcode)
+				{
+
+#include "C6502ops.h"
+				}
+			}
+#undef CPU_CYCLES
+#define CPU_CYCLES(c)			gSystemCycleCount+=(c)
+			gSystemCycleCount+=block->Cycles;
+		}
+
+		inline void ExecuteBlock(C6502_BLOCK *block)
+		{
+			C6502_INSN *insn=block->Insn;
+			C6502_INSN *last=insn+block->Count-1;
+
+#undef CPU_FETCH
+#undef CPU_FETCHW
+#define CPU_FETCH()				(insn->Operand&0xff)
+#define CPU_FETCHW()			(insn->Operand)
+
+			// Nothing in a folded block can raise an event, so if no
+			// timer falls due before the last instruction just run it
+			if(block->Folded && (gSystemCycleCount+block->Lead)<gNextTimerEvent)
+			{
+#ifdef HANDY_CPU_JIT
+				if(block->Native)
+				{
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+					JitLockstep(block);
+#else
+					block->Native(this);
+#endif
+					return;
+				}
+				if(++block->Runs==CPU_JIT_HOT) CompileBlock(block);
+#endif
+				RunFolded(block);
+				return;
+			}
+
+			mCodeModified=FALSE;
+			for(;;)
+			{
+				mOpcode=insn->Opcode;
+				TRACE_CPU2("ExecuteBlock() PC=$%04x, Opcode=%02x",mPC,mOpcode);
+				mPC++;
+
+				switch(mOpcode)
+				{
+
+#include "C6502ops.h"
+				}
+
+#undef CPU_FETCH
+#undef CPU_FETCHW
+#define CPU_FETCH()				CPU_PEEK(mPC)
+#define CPU_FETCHW()			CPU_PEEKW(mPC)
+
+				// Hand back to the system at the same points the single step
+				// path would, a timer event, sleep, a pending IRQ or a write
+				// to code that has been decoded
+				if(insn==last || mCodeModified) break;
+				if(gSystemCycleCount>=gNextTimerEvent || gSystemCPUSleep) break;
+				if(gSystemIRQ && !mI) break;
+				insn++;
+			}
+		}
+#endif
+
 		inline void xILLEGAL(void)
 		{
 			char addr[1024];
@@ -1758,6 +627,29 @@ class C65C02
 
 	    int mBCDTable[2][256];
 
+#ifdef HANDY_BLOCK_CACHE
+		// Decoded block storage
+
+		UWORD		*mBlockIndex;
+		C6502_BLOCK	*mBlockPool;
+		ULONG		mBlockCount;
+		UBYTE		mCodePage[256];
+		bool		mCodeModified;
+#endif
+
+#ifdef HANDY_CPU_JIT
+		// Recompiled code storage
+
+		UBYTE		*mJitCode;
+		ULONG		mJitUsed;
+		ULONG		mJitBlocks;
+		UBYTE		mCodeRewrites[256];
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+		UBYTE		*mJitRam;
+		ULONG		mJitMismatches;
+#endif
+#endif
+
 	//
 	// Opcode prototypes
 	//
@@ -0,0 +1,451 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Screen DMA pixel conversion header file                                  //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This header file provides the conversion of a line of Lynx screen memory //
+// into host pixels, one routine per host pixel size.                       //
+//                                                                          //
+// Each byte of screen memory holds two 4 bit pens, high nibble first. The  //
+// caller resolves the 16 pens into host colours once per line so the       //
+// conversion is a 16 entry table lookup per pixel. Where the compiler      //
+// targets SSSE3 the lookup is done 16 pixels at a time with byte shuffles, //
+// the output being identical to the plain C++ version.                     //
+//                                                                          //
+// Rotated displays are converted a block of lines at a time and the block  //
+// then turned into columns, so each destination row is written as one run  //
+// rather than a pixel at a time down the whole screen. With SSE2 the 16    //
+// and 32 bit formats are transposed in 8x8 and 4x4 pixel tiles.            //
+//                                                                          //
+// Integer scaled output widens each converted line by repeating pixels,    //
+// with SSE2 interleaves for the common 2x and 4x cases, and the caller     //
+// repeats the widened line.                                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define DISPLAY_SSSE3
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DISPLAY_SSE2
+#endif
+
+// Bytes of screen memory in a display line, each giving two pixels
+#define DISPLAY_LINE_BYTES	80
+
+//
+// Pixel writers for each host format, the 16 bit formats all share one
+//
+template<ULONG Format> struct TDisplayPixel
+{
+	enum { Size=sizeof(UWORD) };
+	static inline void Put(UBYTE *dest,ULONG pixel) { *((UWORD*)(dest))=(UWORD)pixel; }
+};
+
+template<> struct TDisplayPixel<MIKIE_PIXEL_FORMAT_8BPP>
+{
+	enum { Size=sizeof(UBYTE) };
+	static inline void Put(UBYTE *dest,ULONG pixel) { *(dest)=(UBYTE)pixel; }
+};
+
+template<> struct TDisplayPixel<MIKIE_PIXEL_FORMAT_24BPP>
+{
+	enum { Size=3 };
+	static inline void Put(UBYTE *dest,ULONG pixel)
+	{
+		*(dest)=(UBYTE)pixel; pixel>>=8;
+		*(dest+1)=(UBYTE)pixel; pixel>>=8;
+		*(dest+2)=(UBYTE)pixel;
+	}
+};
+
+// 32 bit pixels are 32 bits even where a ULONG is wider
+template<> struct TDisplayPixel<MIKIE_PIXEL_FORMAT_32BPP>
+{
+	enum { Size=4 };
+	static inline void Put(UBYTE *dest,ULONG pixel) { *((unsigned int*)(dest))=(unsigned int)pixel; }
+};
+
+//
+// Plain C++ conversion, also the reference for the vector versions
+//
+template<ULONG Format>
+inline void DisplayConvertLineC(UBYTE *dest,const UBYTE *source,const ULONG *palette)
+{
+	typedef TDisplayPixel<Format> TPixel;
+
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES;loop++)
+	{
+		TPixel::Put(dest,palette[source[loop]>>4]);
+		dest+=TPixel::Size;
+		TPixel::Put(dest,palette[source[loop]&0x0f]);
+		dest+=TPixel::Size;
+	}
+}
+
+#ifdef DISPLAY_SSSE3
+
+// Gather byte n of each palette entry into one register for PSHUFB
+inline __m128i DisplayPlane(const ULONG *palette,ULONG shift)
+{
+	UBYTE plane[16];
+	for(ULONG loop=0;loop<16;loop++) plane[loop]=(UBYTE)(palette[loop]>>shift);
+	return _mm_loadu_si128((const __m128i*)plane);
+}
+
+// Split 16 bytes of screen memory into 32 pens in display order
+inline void DisplayPens(const UBYTE *source,__m128i &first,__m128i &second)
+{
+	const __m128i nibble=_mm_set1_epi8(0x0f);
+	__m128i data=_mm_loadu_si128((const __m128i*)source);
+	__m128i high=_mm_and_si128(_mm_srli_epi16(data,4),nibble);
+	__m128i low=_mm_and_si128(data,nibble);
+	first=_mm_unpacklo_epi8(high,low);
+	second=_mm_unpackhi_epi8(high,low);
+}
+
+inline void DisplayConvert8(UBYTE *dest,const UBYTE *source,const ULONG *palette)
+{
+	__m128i plane0=DisplayPlane(palette,0);
+	__m128i pens[2];
+
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES;loop+=16)
+	{
+		DisplayPens(source+loop,pens[0],pens[1]);
+		for(ULONG half=0;half<2;half++)
+		{
+			_mm_storeu_si128((__m128i*)dest,_mm_shuffle_epi8(plane0,pens[half]));
+			dest+=16;
+		}
+	}
+}
+
+inline void DisplayConvert16(UBYTE *dest,const UBYTE *source,const ULONG *palette)
+{
+	__m128i plane0=DisplayPlane(palette,0);
+	__m128i plane1=DisplayPlane(palette,8);
+	__m128i pens[2];
+
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES;loop+=16)
+	{
+		DisplayPens(source+loop,pens[0],pens[1]);
+		for(ULONG half=0;half<2;half++)
+		{
+			__m128i byte0=_mm_shuffle_epi8(plane0,pens[half]);
+			__m128i byte1=_mm_shuffle_epi8(plane1,pens[half]);
+			_mm_storeu_si128((__m128i*)dest,_mm_unpacklo_epi8(byte0,byte1));
+			_mm_storeu_si128((__m128i*)(dest+16),_mm_unpackhi_epi8(byte0,byte1));
+			dest+=32;
+		}
+	}
+}
+
+// Expand 16 pens into four registers of four 32 bit pixels
+inline void DisplayPixels32(const __m128i *planes,__m128i pens,__m128i *pixels)
+{
+	__m128i byte0=_mm_shuffle_epi8(planes[0],pens);
+	__m128i byte1=_mm_shuffle_epi8(planes[1],pens);
+	__m128i byte2=_mm_shuffle_epi8(planes[2],pens);
+	__m128i byte3=_mm_shuffle_epi8(planes[3],pens);
+	__m128i low=_mm_unpacklo_epi8(byte0,byte1);
+	__m128i high=_mm_unpacklo_epi8(byte2,byte3);
+	pixels[0]=_mm_unpacklo_epi16(low,high);
+	pixels[1]=_mm_unpackhi_epi16(low,high);
+	low=_mm_unpackhi_epi8(byte0,byte1);
+	high=_mm_unpackhi_epi8(byte2,byte3);
+	pixels[2]=_mm_unpacklo_epi16(low,high);
+	pixels[3]=_mm_unpackhi_epi16(low,high);
+}
+
+inline void DisplayConvert24(UBYTE *dest,const UBYTE *source,const ULONG *palette)
+{
+	__m128i planes[4]={DisplayPlane(palette,0),DisplayPlane(palette,8),DisplayPlane(palette,16),_mm_setzero_si128()};
+	// Drop the top byte of each pixel, packing four pixels into 12 bytes
+	const __m128i pack=_mm_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+	__m128i pens[2],pixels[4];
+
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES;loop+=16)
+	{
+		DisplayPens(source+loop,pens[0],pens[1]);
+		for(ULONG half=0;half<2;half++)
+		{
+			DisplayPixels32(planes,pens[half],pixels);
+			for(ULONG quad=0;quad<4;quad++)
+			{
+				__m128i packed=_mm_shuffle_epi8(pixels[quad],pack);
+				unsigned int tail=(unsigned int)_mm_cvtsi128_si32(_mm_srli_si128(packed,8));
+				_mm_storel_epi64((__m128i*)dest,packed);
+				memcpy(dest+8,&tail,4);
+				dest+=12;
+			}
+		}
+	}
+}
+
+inline void DisplayConvert32(UBYTE *dest,const UBYTE *source,const ULONG *palette)
+{
+	__m128i planes[4]={DisplayPlane(palette,0),DisplayPlane(palette,8),DisplayPlane(palette,16),DisplayPlane(palette,24)};
+	__m128i pens[2],pixels[4];
+
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES;loop+=16)
+	{
+		DisplayPens(source+loop,pens[0],pens[1]);
+		for(ULONG half=0;half<2;half++)
+		{
+			DisplayPixels32(planes,pens[half],pixels);
+			for(ULONG quad=0;quad<4;quad++)
+			{
+				_mm_storeu_si128((__m128i*)dest,pixels[quad]);
+				dest+=16;
+			}
+		}
+	}
+}
+
+#endif
+
+//
+// Convert DISPLAY_LINE_BYTES of screen memory into a contiguous run of
+// host pixels, palette holding the host colour for each of the 16 pens
+//
+template<ULONG Format>
+inline void DisplayConvertLine(UBYTE *dest,const UBYTE *source,const ULONG *palette)
+{
+#ifdef DISPLAY_SSSE3
+	switch((ULONG)TDisplayPixel<Format>::Size)
+	{
+		case 1: DisplayConvert8(dest,source,palette); break;
+		case 2: DisplayConvert16(dest,source,palette); break;
+		case 3: DisplayConvert24(dest,source,palette); break;
+		default: DisplayConvert32(dest,source,palette); break;
+	}
+#else
+	DisplayConvertLineC<Format>(dest,source,palette);
+#endif
+}
+
+//
+// Turn a block of converted lines, width pixels long, into columns. Pixel x
+// of each row goes to dest+x*pitch, row n being placed n pixels along, so
+// every destination row gets one contiguous run of count pixels.
+//
+template<ULONG Format>
+inline void DisplayRotateBlockC(UBYTE *dest,long pitch,const UBYTE *const *rows,ULONG count,ULONG width)
+{
+	const ULONG size=TDisplayPixel<Format>::Size;
+
+	for(ULONG loop=0;loop<width;loop++)
+	{
+		UBYTE *out=dest+(long)loop*pitch;
+		for(ULONG row=0;row<count;row++) memcpy(out+row*size,rows[row]+loop*size,size);
+	}
+}
+
+#ifdef DISPLAY_SSE2
+
+inline void DisplayRotate16(UBYTE *dest,long pitch,const UBYTE *const *rows,ULONG count,ULONG width)
+{
+	ULONG row=0;
+
+	for(;row+8<=count;row+=8)
+	{
+		for(ULONG loop=0;loop<width;loop+=8)
+		{
+			__m128i in[8],pair[8],quad[8];
+			for(ULONG tile=0;tile<8;tile++) in[tile]=_mm_loadu_si128((const __m128i*)(rows[row+tile]+loop*2));
+
+			// 8x8 transpose of 16 bit pixels in three rounds of interleaving
+			for(ULONG tile=0;tile<8;tile+=2)
+			{
+				pair[tile]=_mm_unpacklo_epi16(in[tile],in[tile+1]);
+				pair[tile+1]=_mm_unpackhi_epi16(in[tile],in[tile+1]);
+			}
+			for(ULONG tile=0;tile<8;tile+=4)
+			{
+				quad[tile]=_mm_unpacklo_epi32(pair[tile],pair[tile+2]);
+				quad[tile+1]=_mm_unpackhi_epi32(pair[tile],pair[tile+2]);
+				quad[tile+2]=_mm_unpacklo_epi32(pair[tile+1],pair[tile+3]);
+				quad[tile+3]=_mm_unpackhi_epi32(pair[tile+1],pair[tile+3]);
+			}
+			for(ULONG tile=0;tile<4;tile++)
+			{
+				UBYTE *out=dest+(long)(loop+tile*2)*pitch+row*2;
+				_mm_storeu_si128((__m128i*)out,_mm_unpacklo_epi64(quad[tile],quad[tile+4]));
+				_mm_storeu_si128((__m128i*)(out+pitch),_mm_unpackhi_epi64(quad[tile],quad[tile+4]));
+			}
+		}
+	}
+	if(row<count) DisplayRotateBlockC<MIKIE_PIXEL_FORMAT_16BPP_555>(dest+row*2,pitch,rows+row,count-row,width);
+}
+
+inline void DisplayRotate32(UBYTE *dest,long pitch,const UBYTE *const *rows,ULONG count,ULONG width)
+{
+	ULONG row=0;
+
+	for(;row+4<=count;row+=4)
+	{
+		for(ULONG loop=0;loop<width;loop+=4)
+		{
+			__m128i in[4],pair[4];
+			for(ULONG tile=0;tile<4;tile++) in[tile]=_mm_loadu_si128((const __m128i*)(rows[row+tile]+loop*4));
+
+			// 4x4 transpose of 32 bit pixels
+			pair[0]=_mm_unpacklo_epi32(in[0],in[1]);
+			pair[1]=_mm_unpacklo_epi32(in[2],in[3]);
+			pair[2]=_mm_unpackhi_epi32(in[0],in[1]);
+			pair[3]=_mm_unpackhi_epi32(in[2],in[3]);
+			for(ULONG tile=0;tile<2;tile++)
+			{
+				UBYTE *out=dest+(long)(loop+tile*2)*pitch+row*4;
+				_mm_storeu_si128((__m128i*)out,_mm_unpacklo_epi64(pair[tile*2],pair[tile*2+1]));
+				_mm_storeu_si128((__m128i*)(out+pitch),_mm_unpackhi_epi64(pair[tile*2],pair[tile*2+1]));
+			}
+		}
+	}
+	if(row<count) DisplayRotateBlockC<MIKIE_PIXEL_FORMAT_32BPP>(dest+row*4,pitch,rows+row,count-row,width);
+}
+
+#endif
+
+template<ULONG Format>
+inline void DisplayRotateBlock(UBYTE *dest,long pitch,const UBYTE *const *rows,ULONG count,ULONG width)
+{
+#ifdef DISPLAY_SSE2
+	switch((ULONG)TDisplayPixel<Format>::Size)
+	{
+		case 2: DisplayRotate16(dest,pitch,rows,count,width); break;
+		case 4: DisplayRotate32(dest,pitch,rows,count,width); break;
+		default: DisplayRotateBlockC<Format>(dest,pitch,rows,count,width); break;
+	}
+#else
+	DisplayRotateBlockC<Format>(dest,pitch,rows,count,width);
+#endif
+}
+
+//
+// Widen a converted line by repeating each pixel scale times
+//
+template<ULONG Format>
+inline void DisplayScaleLineC(UBYTE *dest,const UBYTE *source,ULONG scale)
+{
+	const ULONG size=TDisplayPixel<Format>::Size;
+
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES*2;loop++)
+	{
+		for(ULONG copy=0;copy<scale;copy++)
+		{
+			memcpy(dest,source,size);
+			dest+=size;
+		}
+		source+=size;
+	}
+}
+
+#ifdef DISPLAY_SSE2
+
+// Double each lane of Size bytes in a register, giving two registers
+template<ULONG Size>
+inline void DisplayDouble(__m128i in,__m128i &low,__m128i &high)
+{
+	if(Size==1)
+	{
+		low=_mm_unpacklo_epi8(in,in);
+		high=_mm_unpackhi_epi8(in,in);
+	}
+	else if(Size==2)
+	{
+		low=_mm_unpacklo_epi16(in,in);
+		high=_mm_unpackhi_epi16(in,in);
+	}
+	else if(Size==4)
+	{
+		low=_mm_unpacklo_epi32(in,in);
+		high=_mm_unpackhi_epi32(in,in);
+	}
+	else
+	{
+		low=_mm_unpacklo_epi64(in,in);
+		high=_mm_unpackhi_epi64(in,in);
+	}
+}
+
+template<ULONG Size>
+inline void DisplayScale2(UBYTE *dest,const UBYTE *source)
+{
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES*2*Size;loop+=16)
+	{
+		__m128i low,high;
+		DisplayDouble<Size>(_mm_loadu_si128((const __m128i*)(source+loop)),low,high);
+		_mm_storeu_si128((__m128i*)(dest+loop*2),low);
+		_mm_storeu_si128((__m128i*)(dest+loop*2+16),high);
+	}
+}
+
+template<ULONG Size>
+inline void DisplayScale4(UBYTE *dest,const UBYTE *source)
+{
+	for(ULONG loop=0;loop<DISPLAY_LINE_BYTES*2*Size;loop+=16)
+	{
+		__m128i low,high,out[4];
+		DisplayDouble<Size>(_mm_loadu_si128((const __m128i*)(source+loop)),low,high);
+		DisplayDouble<Size*2>(low,out[0],out[1]);
+		DisplayDouble<Size*2>(high,out[2],out[3]);
+		for(ULONG quad=0;quad<4;quad++) _mm_storeu_si128((__m128i*)(dest+loop*4+quad*16),out[quad]);
+	}
+}
+
+#endif
+
+template<ULONG Format>
+inline void DisplayScaleLine(UBYTE *dest,const UBYTE *source,ULONG scale)
+{
+#ifdef DISPLAY_SSE2
+	const ULONG size=TDisplayPixel<Format>::Size;
+
+	// 24 bit pixels do not fit the register lanes
+	if(size!=3 && scale==2)
+	{
+		DisplayScale2<size>(dest,source);
+		return;
+	}
+	if(size!=3 && scale==4)
+	{
+		DisplayScale4<size>(dest,source);
+		return;
+	}
+#endif
+	DisplayScaleLineC<Format>(dest,source,scale);
+}
+
+#endif
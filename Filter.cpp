@@ -0,0 +1,543 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Display scaling filters                                                  //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This class scales a finished frame with one of the pixel art filters,    //
+// see Filter.h for the list.                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#define FILTER_CPP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "System.h"
+#include "Filter.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FILTER_SSE2
+#endif
+
+#ifdef FILTER_SSE2
+//
+// Compares and interleaves for each pixel size
+//
+template<class T> struct TFilterLanes;
+
+template<> struct TFilterLanes<UWORD>
+{
+	enum { Count=8 };
+	static inline __m128i Equal(__m128i a,__m128i b) { return _mm_cmpeq_epi16(a,b); }
+	static inline __m128i Low(__m128i a,__m128i b) { return _mm_unpacklo_epi16(a,b); }
+	static inline __m128i High(__m128i a,__m128i b) { return _mm_unpackhi_epi16(a,b); }
+};
+
+template<> struct TFilterLanes<unsigned int>
+{
+	enum { Count=4 };
+	static inline __m128i Equal(__m128i a,__m128i b) { return _mm_cmpeq_epi32(a,b); }
+	static inline __m128i Low(__m128i a,__m128i b) { return _mm_unpacklo_epi32(a,b); }
+	static inline __m128i High(__m128i a,__m128i b) { return _mm_unpackhi_epi32(a,b); }
+};
+
+static inline __m128i FilterSelect(__m128i mask,__m128i a,__m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b));
+}
+#endif
+
+//
+// The 2x filters work on the 3x3 block around each pixel
+//
+//   A B C
+//   D E F   ->   0 1
+//   G H I        2 3
+//
+
+// A corner takes the colour of the two edges meeting at it when they match
+// and the edges across from them don't
+struct TFilterScale2x
+{
+	template<class T> static inline void Pixel(T a,T b,T c,T d,T e,T f,T g,T h,T i,T *out)
+	{
+		out[0]=(d==b && b!=f && d!=h)?d:e;
+		out[1]=(b==f && b!=d && f!=h)?f:e;
+		out[2]=(d==h && d!=b && h!=f)?d:e;
+		out[3]=(h==f && d!=h && b!=f)?f:e;
+	}
+
+#ifdef FILTER_SSE2
+	template<class L> static inline void Vector(__m128i a,__m128i b,__m128i c,__m128i d,__m128i e,__m128i f,__m128i g,__m128i h,__m128i i,__m128i *out)
+	{
+		__m128i db=L::Equal(d,b);
+		__m128i bf=L::Equal(b,f);
+		__m128i dh=L::Equal(d,h);
+		__m128i hf=L::Equal(h,f);
+		out[0]=FilterSelect(_mm_andnot_si128(_mm_or_si128(bf,dh),db),d,e);
+		out[1]=FilterSelect(_mm_andnot_si128(_mm_or_si128(db,hf),bf),f,e);
+		out[2]=FilterSelect(_mm_andnot_si128(_mm_or_si128(db,hf),dh),d,e);
+		out[3]=FilterSelect(_mm_andnot_si128(_mm_or_si128(dh,bf),hf),f,e);
+	}
+#endif
+};
+
+// A corner takes the colour of the three pixels around it when they match
+struct TFilterEagle
+{
+	template<class T> static inline void Pixel(T a,T b,T c,T d,T e,T f,T g,T h,T i,T *out)
+	{
+		out[0]=(a==b && b==d)?a:e;
+		out[1]=(b==c && c==f)?c:e;
+		out[2]=(d==g && g==h)?g:e;
+		out[3]=(f==i && i==h)?i:e;
+	}
+
+#ifdef FILTER_SSE2
+	template<class L> static inline void Vector(__m128i a,__m128i b,__m128i c,__m128i d,__m128i e,__m128i f,__m128i g,__m128i h,__m128i i,__m128i *out)
+	{
+		out[0]=FilterSelect(_mm_and_si128(L::Equal(a,b),L::Equal(b,d)),a,e);
+		out[1]=FilterSelect(_mm_and_si128(L::Equal(b,c),L::Equal(c,f)),c,e);
+		out[2]=FilterSelect(_mm_and_si128(L::Equal(d,g),L::Equal(g,h)),g,e);
+		out[3]=FilterSelect(_mm_and_si128(L::Equal(f,i),L::Equal(i,h)),i,e);
+	}
+#endif
+};
+
+// Fraction of full scale of a channel of a 16 bit pixel
+static double FilterChannel(ULONG pixel,ULONG mask)
+{
+	ULONG unit=mask&(~mask+1);
+	return (double)((pixel&mask)/unit)*255.0/(double)(mask/unit);
+}
+
+static ULONG FilterByte(double value)
+{
+	if(value<0.0) return 0;
+	if(value>255.0) return 255;
+	return (ULONG)value;
+}
+
+CFilter::CFilter(ULONG threads)
+{
+	mFilter=FILTER_NONE;
+	mFormat=MIKIE_PIXEL_FORMAT_16BPP_555;
+	mpDest=NULL;
+	mDestPitch=0;
+	mpSource=NULL;
+	mSourcePitch=0;
+	mWidth=0;
+	mHeight=0;
+	mMask[0]=mMask[1]=mMask[2]=0;
+	mKeep=0;
+	mpYuv=NULL;
+	mYuvFormat=0xffffffff;
+
+	if(threads<1) threads=1;
+	if(threads>FILTER_MAX_THREADS) threads=FILTER_MAX_THREADS;
+	mThreads=1;
+
+#ifdef HANDY_FILTER_THREADS
+	// Band 0 is always filtered by the caller
+	mThreads=mPool.Start(threads,BandEntry,this);
+#endif
+}
+
+CFilter::~CFilter()
+{
+#ifdef HANDY_FILTER_THREADS
+	mPool.Stop();
+#endif
+	delete[] mpYuv;
+}
+
+ULONG CFilter::GetScale(ULONG filter)
+{
+	switch(filter)
+	{
+		case FILTER_SCALE2X:
+		case FILTER_EAGLE:
+		case FILTER_XBR:
+			return 2;
+		case FILTER_SCALE3X:
+			return 3;
+		default:
+			return 1;
+	}
+}
+
+bool CFilter::Apply(ULONG filter,ULONG format,UBYTE *dest,ULONG destpitch,const UBYTE *source,ULONG sourcepitch,ULONG width,ULONG height)
+{
+	if(filter>=FILTER_COUNT || !width || !height) return FALSE;
+
+	switch(format)
+	{
+		case MIKIE_PIXEL_FORMAT_16BPP_555:
+		case MIKIE_PIXEL_FORMAT_16BPP_5551:
+			mMask[0]=0x7c00;
+			mMask[1]=0x03e0;
+			mMask[2]=0x001f;
+			mKeep=0x8000;
+			break;
+		case MIKIE_PIXEL_FORMAT_16BPP_565:
+			mMask[0]=0xf800;
+			mMask[1]=0x07e0;
+			mMask[2]=0x001f;
+			mKeep=0;
+			break;
+		case MIKIE_PIXEL_FORMAT_32BPP:
+			mMask[0]=0x00ff0000;
+			mMask[1]=0x0000ff00;
+			mMask[2]=0x000000ff;
+			mKeep=0xff000000;
+			break;
+		default:
+			return FALSE;
+	}
+
+	mFilter=filter;
+	mFormat=format;
+	mpDest=dest;
+	mDestPitch=destpitch;
+	mpSource=source;
+	mSourcePitch=sourcepitch;
+	mWidth=width;
+	mHeight=height;
+
+	if(mFilter==FILTER_XBR && mYuvFormat!=mFormat) BuildYuv(mFormat);
+
+#ifdef HANDY_FILTER_THREADS
+	mPool.Run();
+#else
+	FilterBand(0);
+#endif
+	return TRUE;
+}
+
+#ifdef HANDY_FILTER_THREADS
+void CFilter::BandEntry(void *object,ULONG band)
+{
+	((CFilter*)object)->FilterBand(band);
+}
+#endif
+
+void CFilter::FilterBand(ULONG band)
+{
+	// Bands only read the rows either side of them, never write them
+	ULONG top=mHeight*band/mThreads;
+	ULONG bottom=mHeight*(band+1)/mThreads;
+
+	if(mFormat==MIKIE_PIXEL_FORMAT_32BPP)
+	{
+		FilterRows<unsigned int>(top,bottom);
+	}
+	else
+	{
+		FilterRows<UWORD>(top,bottom);
+	}
+}
+
+template<class T> void CFilter::FilterRows(ULONG top,ULONG bottom)
+{
+	switch(mFilter)
+	{
+		case FILTER_SCALE2X:
+			Filter2x<T,TFilterScale2x>(top,bottom);
+			break;
+		case FILTER_SCALE3X:
+			Filter3x<T>(top,bottom);
+			break;
+		case FILTER_EAGLE:
+			Filter2x<T,TFilterEagle>(top,bottom);
+			break;
+		case FILTER_XBR:
+			FilterXbr<T>(top,bottom);
+			break;
+		default:
+			for(ULONG row=top;row<bottom;row++)
+			{
+				memcpy(DestRow<T>(row),SourceRow<T>(row),mWidth*sizeof(T));
+			}
+			break;
+	}
+}
+
+template<class T,class TRule> void CFilter::Filter2x(ULONG top,ULONG bottom)
+{
+	ULONG last=mWidth-1;
+
+	for(ULONG row=top;row<bottom;row++)
+	{
+		const T *above=SourceRow<T>((SLONG)row-1);
+		const T *line=SourceRow<T>(row);
+		const T *below=SourceRow<T>(row+1);
+		T *out0=DestRow<T>(row*2);
+		T *out1=DestRow<T>(row*2+1);
+		ULONG x=0;
+		T out[4];
+
+#ifdef FILTER_SSE2
+		//
+		// The edge columns repeat, so the vectors start one pixel in and
+		// stop a pixel short to keep their neighbours inside the line
+		//
+		typedef TFilterLanes<T> L;
+		if(mWidth>L::Count+1)
+		{
+			TRule::Pixel(above[0],above[0],above[1],line[0],line[0],line[1],below[0],below[0],below[1],out);
+			out0[0]=out[0];
+			out0[1]=out[1];
+			out1[0]=out[2];
+			out1[1]=out[3];
+
+			for(x=1;x+L::Count<mWidth;x+=L::Count)
+			{
+				__m128i vout[4];
+				TRule::template Vector<L>(
+					_mm_loadu_si128((const __m128i*)(above+x-1)),
+					_mm_loadu_si128((const __m128i*)(above+x)),
+					_mm_loadu_si128((const __m128i*)(above+x+1)),
+					_mm_loadu_si128((const __m128i*)(line+x-1)),
+					_mm_loadu_si128((const __m128i*)(line+x)),
+					_mm_loadu_si128((const __m128i*)(line+x+1)),
+					_mm_loadu_si128((const __m128i*)(below+x-1)),
+					_mm_loadu_si128((const __m128i*)(below+x)),
+					_mm_loadu_si128((const __m128i*)(below+x+1)),
+					vout);
+				_mm_storeu_si128((__m128i*)(out0+x*2),L::Low(vout[0],vout[1]));
+				_mm_storeu_si128((__m128i*)(out0+x*2)+1,L::High(vout[0],vout[1]));
+				_mm_storeu_si128((__m128i*)(out1+x*2),L::Low(vout[2],vout[3]));
+				_mm_storeu_si128((__m128i*)(out1+x*2)+1,L::High(vout[2],vout[3]));
+			}
+		}
+#endif
+
+		for(;x<mWidth;x++)
+		{
+			ULONG left=(x>0)?x-1:0;
+			ULONG right=(x<last)?x+1:last;
+			TRule::Pixel(above[left],above[x],above[right],line[left],line[x],line[right],below[left],below[x],below[right],out);
+			out0[x*2]=out[0];
+			out0[x*2+1]=out[1];
+			out1[x*2]=out[2];
+			out1[x*2+1]=out[3];
+		}
+	}
+}
+
+//
+// Scale3x works on the same 3x3 block as the 2x filters, each pixel gives
+// a 3x3 block with the centre left alone
+//
+template<class T> void CFilter::Filter3x(ULONG top,ULONG bottom)
+{
+	ULONG last=mWidth-1;
+
+	for(ULONG row=top;row<bottom;row++)
+	{
+		const T *above=SourceRow<T>((SLONG)row-1);
+		const T *line=SourceRow<T>(row);
+		const T *below=SourceRow<T>(row+1);
+		T *out0=DestRow<T>(row*3);
+		T *out1=DestRow<T>(row*3+1);
+		T *out2=DestRow<T>(row*3+2);
+
+		for(ULONG x=0;x<mWidth;x++)
+		{
+			ULONG left=(x>0)?x-1:0;
+			ULONG right=(x<last)?x+1:last;
+			T a=above[left],b=above[x],c=above[right];
+			T d=line[left],e=line[x],f=line[right];
+			T g=below[left],h=below[x],i=below[right];
+
+			// With a straight line through the centre nothing changes
+			if(b==h || d==f)
+			{
+				out0[x*3]=out0[x*3+1]=out0[x*3+2]=e;
+				out1[x*3]=out1[x*3+1]=out1[x*3+2]=e;
+				out2[x*3]=out2[x*3+1]=out2[x*3+2]=e;
+				continue;
+			}
+
+			bool db=(d==b && b!=f && d!=h);
+			bool bf=(b==f && b!=d && f!=h);
+			bool dh=(d==h && d!=b && h!=f);
+			bool hf=(h==f && d!=h && b!=f);
+
+			out0[x*3]=db?d:e;
+			out0[x*3+1]=((db && e!=c) || (bf && e!=a))?b:e;
+			out0[x*3+2]=bf?f:e;
+			out1[x*3]=((db && e!=g) || (dh && e!=a))?d:e;
+			out1[x*3+1]=e;
+			out1[x*3+2]=((bf && e!=i) || (hf && e!=c))?f:e;
+			out2[x*3]=dh?d:e;
+			out2[x*3+1]=((dh && e!=i) || (hf && e!=g))?h:e;
+			out2[x*3+2]=hf?f:e;
+		}
+	}
+}
+
+//
+// xBR looks at the 5x5 block around each pixel less the corners
+//
+//      A1 B1 C1
+//   A0 A  B  C  C4
+//   D0 D  E  F  F4
+//   G0 G  H  I  I4
+//      G5 H5 I5
+//
+// Each corner is worked out with the block turned so that corner is at the
+// bottom right, the pixel names below being for that corner. Where the edge
+// through H and F is stronger than the one through E and I the corner is
+// blended towards whichever of F and H is nearer to E, and along the edge
+// into the next output pixel when the edge is shallow or steep.
+//
+template<class T> inline void CFilter::XbrCorner(T *out,T pe,T pi,T ph,T pf,T pg,T pc,T pd,T pb,T f4,T i4,T h5,T i5,ULONG n1,ULONG n2,ULONG n3)
+{
+	if(pe==ph || pe==pf) return;
+
+	ULONG e=Distance(pe,pc)+Distance(pe,pg)+Distance(pi,h5)+Distance(pi,f4)+(Distance(ph,pf)<<2);
+	ULONG i=Distance(ph,pd)+Distance(ph,i5)+Distance(pf,i4)+Distance(pf,pb)+(Distance(pe,pi)<<2);
+	T px=(Distance(pe,pf)<=Distance(pe,ph))?pf:ph;
+
+	if(e<i && ((!Same(pf,pb) && !Same(ph,pd)) || (Same(pe,pi) && !Same(pf,i4) && !Same(ph,i5)) || Same(pe,pg) || Same(pe,pc)))
+	{
+		ULONG ke=Distance(pf,pg);
+		ULONG ki=Distance(ph,pc);
+		bool shallow=((ke<<1)<=ki && pe!=pg && pd!=pg);
+		bool steep=(ke>=(ki<<1) && pe!=pc && pb!=pc);
+
+		if(shallow && steep)
+		{
+			out[n3]=Blend(out[n3],px,224);
+			out[n2]=Blend(out[n2],px,64);
+			out[n1]=out[n2];
+		}
+		else if(shallow)
+		{
+			out[n3]=Blend(out[n3],px,192);
+			out[n2]=Blend(out[n2],px,64);
+		}
+		else if(steep)
+		{
+			out[n3]=Blend(out[n3],px,192);
+			out[n1]=Blend(out[n1],px,64);
+		}
+		else
+		{
+			out[n3]=Blend(out[n3],px,128);
+		}
+	}
+	else if(e<=i)
+	{
+		out[n3]=Blend(out[n3],px,64);
+	}
+}
+
+template<class T> void CFilter::FilterXbr(ULONG top,ULONG bottom)
+{
+	ULONG last=mWidth-1;
+
+	for(ULONG row=top;row<bottom;row++)
+	{
+		const T *up2=SourceRow<T>((SLONG)row-2);
+		const T *up=SourceRow<T>((SLONG)row-1);
+		const T *line=SourceRow<T>(row);
+		const T *down=SourceRow<T>(row+1);
+		const T *down2=SourceRow<T>(row+2);
+		T *out0=DestRow<T>(row*2);
+		T *out1=DestRow<T>(row*2+1);
+
+		for(ULONG x=0;x<mWidth;x++)
+		{
+			ULONG left=(x>0)?x-1:0;
+			ULONG left2=(x>1)?x-2:0;
+			ULONG right=(x<last)?x+1:last;
+			ULONG right2=(x+1<last)?x+2:last;
+
+			T a1=up2[left],b1=up2[x],c1=up2[right];
+			T a0=up[left2],pa=up[left],pb=up[x],pc=up[right],c4=up[right2];
+			T d0=line[left2],pd=line[left],pe=line[x],pf=line[right],f4=line[right2];
+			T g0=down[left2],pg=down[left],ph=down[x],pi=down[right],i4=down[right2];
+			T g5=down2[left],h5=down2[x],i5=down2[right];
+
+			T out[4]={pe,pe,pe,pe};
+
+			// A corner only changes when E differs from both edges there
+			if((pe!=pb || pe!=ph) && (pe!=pd || pe!=pf))
+			{
+				XbrCorner<T>(out,pe,pi,ph,pf,pg,pc,pd,pb,f4,i4,h5,i5,1,2,3);
+				XbrCorner<T>(out,pe,pc,pf,pb,pi,pa,ph,pd,b1,c1,f4,c4,0,3,1);
+				XbrCorner<T>(out,pe,pa,pb,pd,pc,pg,pf,ph,d0,a0,b1,a1,2,1,0);
+				XbrCorner<T>(out,pe,pg,pd,ph,pa,pi,pb,pf,h5,g5,d0,g0,3,0,2);
+			}
+
+			out0[x*2]=out[0];
+			out0[x*2+1]=out[1];
+			out1[x*2]=out[2];
+			out1[x*2+1]=out[3];
+		}
+	}
+}
+
+void CFilter::BuildYuv(ULONG format)
+{
+	if(mpYuv==NULL) mpYuv=new unsigned int[FILTER_YUV_SIZE];
+
+	// 32 bit pixels are looked up by their top 5, 6 and 5 bits
+	ULONG red=0xf800,green=0x07e0,blue=0x001f;
+	switch(format)
+	{
+		case MIKIE_PIXEL_FORMAT_16BPP_555:
+			red=0x7c00;
+			green=0x03e0;
+			blue=0x001f;
+			break;
+		case MIKIE_PIXEL_FORMAT_16BPP_5551:
+			red=0x001f;
+			green=0x03e0;
+			blue=0x7c00;
+			break;
+		default:
+			break;
+	}
+
+	for(ULONG pixel=0;pixel<FILTER_YUV_SIZE;pixel++)
+	{
+		double r=FilterChannel(pixel,red);
+		double g=FilterChannel(pixel,green);
+		double b=FilterChannel(pixel,blue);
+		ULONG y=FilterByte(0.299*r+0.587*g+0.114*b+0.5);
+		ULONG u=FilterByte(-0.169*r-0.331*g+0.5*b+128.5);
+		ULONG v=FilterByte(0.5*r-0.419*g-0.081*b+128.5);
+		mpYuv[pixel]=(unsigned int)((y<<16)|(u<<8)|v);
+	}
+	mYuvFormat=format;
+}
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Display scaling filter header file                                       //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// This header file provides the scaling filters that can be run over a     //
+// finished frame in one of the 16 or 32 bit host formats before it is      //
+// shown: Scale2x, Scale3x, Eagle and a 2x xBR.                             //
+//                                                                          //
+// Each filter writes whole output rows from the source rows around them    //
+// so there is no per pixel division back into the source. Scale2x and      //
+// Eagle only compare pixels and run 8 or 4 pixels at a time with SSE2.     //
+// xBR weighs edges by colour distance, read from a YUV table built once    //
+// per host format.                                                         //
+//                                                                          //
+// The frame is cut into horizontal bands, one per thread. Threads need     //
+// HANDY_FILTER_THREADS and pthreads, the caller filters the first band     //
+// itself. Without threads the caller filters the whole frame.              //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#ifdef HANDY_FILTER_THREADS
+#include "BandPool.h"
+#endif
+
+enum
+{
+	FILTER_NONE=0,
+	FILTER_SCALE2X,
+	FILTER_SCALE3X,
+	FILTER_EAGLE,
+	FILTER_XBR,
+	FILTER_COUNT
+};
+
+// Most bands a frame is cut into, one thread each
+#define FILTER_MAX_THREADS	8
+
+// Entries in the colour distance table, one per 16 bit pixel
+#define FILTER_YUV_SIZE		65536
+
+// Colours closer than this count as the same to xBR
+#define FILTER_XBR_SAME		155
+
+class CFilter
+{
+	public:
+		CFilter(ULONG threads=1);
+		~CFilter();
+
+		static ULONG	GetScale(ULONG filter);
+		ULONG	GetThreads(void) { return mThreads; };
+
+		//
+		// Filter a width x height frame in the given Mikie pixel format into
+		// dest, which must hold GetScale() times as many rows and columns.
+		// Pitches are in bytes. Returns FALSE for an unknown filter or a
+		// format other than the 16 and 32 bit ones.
+		//
+		bool	Apply(ULONG filter,ULONG format,UBYTE *dest,ULONG destpitch,const UBYTE *source,ULONG sourcepitch,ULONG width,ULONG height);
+
+	private:
+		void	FilterBand(ULONG band);
+		template<class T> void FilterRows(ULONG top,ULONG bottom);
+		template<class T,class TRule> void Filter2x(ULONG top,ULONG bottom);
+		template<class T> void Filter3x(ULONG top,ULONG bottom);
+		template<class T> void FilterXbr(ULONG top,ULONG bottom);
+		template<class T> inline void XbrCorner(T *out,T pe,T pi,T ph,T pf,T pg,T pc,T pd,T pb,T f4,T i4,T h5,T i5,ULONG n1,ULONG n2,ULONG n3);
+
+		template<class T> inline const T* SourceRow(SLONG row)
+		{
+			if(row<0) row=0;
+			if(row>=(SLONG)mHeight) row=mHeight-1;
+			return (const T*)(mpSource+row*mSourcePitch);
+		};
+		template<class T> inline T* DestRow(ULONG row) { return (T*)(mpDest+row*mDestPitch); };
+
+		void	BuildYuv(ULONG format);
+		template<class T> inline ULONG Distance(T a,T b)
+		{
+			ULONG yuva=mpYuv[Key(a)];
+			ULONG yuvb=mpYuv[Key(b)];
+			return 48*Diff(yuva>>16,yuvb>>16)+7*Diff((yuva>>8)&0xff,(yuvb>>8)&0xff)+6*Diff(yuva&0xff,yuvb&0xff);
+		};
+		template<class T> inline bool Same(T a,T b) { return Distance(a,b)<FILTER_XBR_SAME; };
+		static inline ULONG Diff(ULONG a,ULONG b) { return (a>b)?a-b:b-a; };
+		static inline ULONG Key(UWORD pixel) { return pixel; };
+		static inline ULONG Key(unsigned int pixel) { return ((pixel>>8)&0xf800)|((pixel>>5)&0x07e0)|((pixel>>3)&0x001f); };
+
+		// Mix weight/256 of b into a, a channel at a time
+		inline ULONG Blend(ULONG a,ULONG b,ULONG weight)
+		{
+			ULONG mix=a&mKeep;
+			for(ULONG loop=0;loop<3;loop++)
+			{
+				mix|=(((a&mMask[loop])*(256-weight)+(b&mMask[loop])*weight)>>8)&mMask[loop];
+			}
+			return mix;
+		};
+
+		ULONG	mThreads;
+
+		// The frame being filtered
+		ULONG	mFilter;
+		ULONG	mFormat;
+		UBYTE	*mpDest;
+		ULONG	mDestPitch;
+		const UBYTE	*mpSource;
+		ULONG	mSourcePitch;
+		ULONG	mWidth;
+		ULONG	mHeight;
+
+		// Channel masks of the format for blending, keep is carried from the
+		// first pixel
+		ULONG	mMask[3];
+		ULONG	mKeep;
+
+		// Y, U and V of each 16 bit pixel, 32 bit pixels are cut to 565
+		unsigned int	*mpYuv;
+		ULONG	mYuvFormat;
+
+#ifdef HANDY_FILTER_THREADS
+		static void	BandEntry(void *object,ULONG band);
+
+		CBandPool	mPool;
+#endif
+};
+
+#endif
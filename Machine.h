@@ -58,6 +58,9 @@ typedef unsigned short UWORD;
 typedef signed long SLONG;
 typedef unsigned long ULONG;
 
+// Cycle counts should be 64-bits wide so they never wrap
+typedef unsigned long long UCYCLE;
+
 // Read/Write Cycle definitions
 #define CPU_RDWR_CYC	5
 #define DMA_RDWR_CYC	4
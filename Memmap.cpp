@@ -89,12 +89,14 @@ CMemMap::CMemMap(CSystem& parent)
 void CMemMap::Reset(void)
 {
 
-	// Initialise ALL pointers to RAM then overload to correct
-	for(int loop=0;loop<SYSTEM_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRam;
+	// Initialise ALL pages to RAM then overload to correct
+	memset(mSystem.mMemoryPages,HANDLER_RAM,SYSTEM_PAGES);
+	memset(mSystem.mLastPageHandlers,HANDLER_RAM,SYSTEM_PAGES);
+	mSystem.mMemoryPages[SYSTEM_LAST_PAGE]=HANDLER_SPLIT;
 
 	// Special case for ourselves.
-	mSystem.mMemoryHandlers[0xFFF8]=mSystem.mRam;
-	mSystem.mMemoryHandlers[0xFFF9]=mSystem.mMemMap;
+	mSystem.mLastPageHandlers[0xF8]=HANDLER_RAM;
+	mSystem.mLastPageHandlers[0xF9]=HANDLER_MEMMAP;
 
 	mSusieEnabled=-1;
 	mMikieEnabled=-1;
@@ -157,11 +159,11 @@ bool CMemMap::ContextLoad(LSS_FILE *fp)
 	return 1;
 }
 
-inline void CMemMap::Poke(ULONG addr, UBYTE data)
+void CMemMap::Poke(ULONG addr, UBYTE data)
 {
 	TRACE_MEMMAP1("Poke() - Data %02x",data);
 
-	int newstate,loop;
+	int newstate;
 
 	// FC00-FCFF Susie area
 	newstate=(data&0x01)?FALSE:TRUE;
@@ -169,14 +171,7 @@ inline void CMemMap::Poke(ULONG addr, UBYTE data)
 	{
 		mSusieEnabled=newstate;
 
-		if(mSusieEnabled)
-		{
-			for(loop=SUSIE_START;loop<SUSIE_START+SUSIE_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mSusie;
-		}
-		else
-		{
-			for(loop=SUSIE_START;loop<SUSIE_START+SUSIE_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRam;
-		}
+		mSystem.mMemoryPages[SUSIE_START>>SYSTEM_PAGE_SHIFT]=(mSusieEnabled)?HANDLER_SUSIE:HANDLER_RAM;
 	}
 
 	// FD00-FCFF Mikie area
@@ -185,14 +180,7 @@ inline void CMemMap::Poke(ULONG addr, UBYTE data)
 	{
 		mMikieEnabled=newstate;
 
-		if(mMikieEnabled)
-		{
-			for(loop=MIKIE_START;loop<MIKIE_START+MIKIE_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mMikie;
-		}
-		else
-		{
-			for(loop=MIKIE_START;loop<MIKIE_START+MIKIE_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRam;
-		}
+		mSystem.mMemoryPages[MIKIE_START>>SYSTEM_PAGE_SHIFT]=(mMikieEnabled)?HANDLER_MIKIE:HANDLER_RAM;
 	}
 
 	// FE00-FFF7 Rom area
@@ -201,14 +189,10 @@ inline void CMemMap::Poke(ULONG addr, UBYTE data)
 	{
 		mRomEnabled=newstate;
 
-		if(mRomEnabled)
-		{
-			for(loop=BROM_START;loop<BROM_START+(BROM_SIZE-8);loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRom;
-		}
-		else
-		{
-			for(loop=BROM_START;loop<BROM_START+(BROM_SIZE-8);loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRam;
-		}
+		// The ROM covers a whole page and then most of the split page
+		UBYTE handler=(mRomEnabled)?HANDLER_ROM:HANDLER_RAM;
+		mSystem.mMemoryPages[BROM_START>>SYSTEM_PAGE_SHIFT]=handler;
+		memset(mSystem.mLastPageHandlers,handler,(BROM_SIZE-8)-SYSTEM_PAGES);
 	}
 
 	// FFFA-FFFF Vector area - Overload ROM space
@@ -217,20 +201,13 @@ inline void CMemMap::Poke(ULONG addr, UBYTE data)
 	{
 		mVectorsEnabled=newstate;
 
-		if(mVectorsEnabled)
-		{
-			for(loop=VECTOR_START;loop<VECTOR_START+VECTOR_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRom;
-		}
-		else
-		{
-			for(loop=VECTOR_START;loop<VECTOR_START+VECTOR_SIZE;loop++) mSystem.mMemoryHandlers[loop]=mSystem.mRam;
-		}
+		memset(&mSystem.mLastPageHandlers[VECTOR_START&SYSTEM_PAGE_MASK],(mVectorsEnabled)?HANDLER_ROM:HANDLER_RAM,VECTOR_SIZE);
 	}
 
 
 }
 
-inline UBYTE CMemMap::Peek(ULONG addr)
+UBYTE CMemMap::Peek(ULONG addr)
 {
 	UBYTE retval=0;
 
@@ -56,6 +56,7 @@
 #include "System.h"
 #include "Mikie.h"
 #include "lynxdef.h"
+#include "Display.h"
 
 #ifdef GZIP_STATE
 #include "./zlib-113/zlib.h"
@@ -84,15 +85,31 @@ CMikie::CMikie(CSystem& parent)
 
 	mDisplayRotate=MIKIE_BAD_MODE;
 	mDisplayFormat=MIKIE_PIXEL_FORMAT_16BPP_555;
+	mDisplayScale=1;
+	mpDisplayLine=NULL;
 	mpDisplayCallback=NULL;
 	mDisplayCallbackObject=0;
 
+	mDisplayDeferred=FALSE;
+	mDisplayHeadless=FALSE;
+	mFrameLineCount=0;
+	mFramePaletteCount=0;
+	mFramePaletteChanged=TRUE;
+	mRotateLineCount=0;
+
+	mDisplayTrackLines=FALSE;
+	mDisplaySameBuffer=FALSE;
+
 	mUART_CABLE_PRESENT=FALSE;
 	mpUART_TX_CALLBACK=NULL;
 
 	int loop;
 	for(loop=0;loop<16;loop++) mPalette[loop].Index=loop;
-	for(loop=0;loop<4096;loop++) mColourMap[loop]=0;
+	for(loop=0;loop<16;loop++) mDisplayPalette[loop]=0;
+	for(loop=0;loop<16;loop++) mFrameColours[loop]=0;
+	mFrameColoursSplit=FALSE;
+	for(loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mShownValid[loop]=FALSE;
+	for(loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mLineDirty[loop]=FALSE;
 
 	Reset();
 }
@@ -286,6 +303,7 @@ void CMikie::Reset(void)
 	{
 		mPalette[loop].Index=loop;
 	}
+	DisplayUpdatePalette();
 
 	// Initialise IODAT register
 
@@ -323,6 +341,152 @@ void CMikie::Reset(void)
 
 	mUART_PARITY_ENABLE=0;
 	mUART_PARITY_EVEN=0;
+
+	ResetEvents();
+}
+
+void CMikie::ResetEvents(void)
+{
+	TRACE_MIKIE0("ResetEvents()");
+
+	mEventCount=0;
+	for(int loop=0;loop<EVENT_COUNT;loop++) mEventSlot[loop]=EVENT_IDLE;
+
+	// Service every timer straight away, they schedule themselves from there on
+	for(int loop=EVENT_TIMER0;loop<EVENT_COUNT;loop++) ForceEvent(loop);
+	if(gCPUWakeupTime) ScheduleEvent(EVENT_WAKEUP,gCPUWakeupTime);
+	mAudioEventsEnabled=gAudioEnabled;
+
+	// Sound output picks up from here, the first update brings it up to
+	// the current channel outputs
+	mBlip.Reset(gSystemCycleCount);
+	mAudioLeft=0;
+	mAudioRight=0;
+}
+
+void CMikie::AudioSetSampleFreq(ULONG freq)
+{
+	// Samples up to now go out at the old rate
+	if(mAudioEventsEnabled) mBlip.Flush(gSystemCycleCount);
+	mBlip.SetSampleFreq(freq);
+}
+
+//
+// Work out when a free running timer of the Timer 1 -> 3 -> 5 -> 7 ->
+// Audio 0-3 chain next needs servicing. Its own borrows only matter if
+// they interrupt, otherwise we look down the timers linked to it for the
+// first that interrupts (or the first audio channel, which always makes
+// sound) and count how many of our borrows it takes to get there. When
+// nothing on the chain is ever seen the timer is otherwise only caught up
+// when it is next accessed. Returns FALSE if the timer isn't counting.
+//
+bool CMikie::ChainEvent(ULONG head,UCYCLE &cycle)
+{
+	ULONG current[8],backup[8],reload[8],running[8],observed[8],linked[8];
+	UCYCLE lastcount[4];
+	ULONG linking[4];
+
+	current[0]=mTIM_1_CURRENT;
+	backup[0]=mTIM_1_BKUP;
+	reload[0]=mTIM_1_ENABLE_RELOAD;
+	running[0]=mTIM_1_ENABLE_COUNT && (mTIM_1_ENABLE_RELOAD || !mTIM_1_TIMER_DONE);
+	observed[0]=mTimerInterruptMask&0x02;
+	linked[0]=(mTIM_1_LINKING==7);
+	lastcount[0]=mTIM_1_LAST_COUNT;
+	linking[0]=mTIM_1_LINKING;
+
+	current[1]=mTIM_3_CURRENT;
+	backup[1]=mTIM_3_BKUP;
+	reload[1]=mTIM_3_ENABLE_RELOAD;
+	running[1]=mTIM_3_ENABLE_COUNT && (mTIM_3_ENABLE_RELOAD || !mTIM_3_TIMER_DONE);
+	observed[1]=mTimerInterruptMask&0x08;
+	linked[1]=(mTIM_3_LINKING==7);
+	lastcount[1]=mTIM_3_LAST_COUNT;
+	linking[1]=mTIM_3_LINKING;
+
+	current[2]=mTIM_5_CURRENT;
+	backup[2]=mTIM_5_BKUP;
+	reload[2]=mTIM_5_ENABLE_RELOAD;
+	running[2]=mTIM_5_ENABLE_COUNT && (mTIM_5_ENABLE_RELOAD || !mTIM_5_TIMER_DONE);
+	observed[2]=mTimerInterruptMask&0x20;
+	linked[2]=(mTIM_5_LINKING==7);
+	lastcount[2]=mTIM_5_LAST_COUNT;
+	linking[2]=mTIM_5_LINKING;
+
+	current[3]=mTIM_7_CURRENT;
+	backup[3]=mTIM_7_BKUP;
+	reload[3]=mTIM_7_ENABLE_RELOAD;
+	running[3]=mTIM_7_ENABLE_COUNT && (mTIM_7_ENABLE_RELOAD || !mTIM_7_TIMER_DONE);
+	observed[3]=mTimerInterruptMask&0x80;
+	linked[3]=(mTIM_7_LINKING==7);
+	lastcount[3]=mTIM_7_LAST_COUNT;
+	linking[3]=mTIM_7_LINKING;
+
+	current[4]=mAUDIO_0_CURRENT;
+	backup[4]=mAUDIO_0_BKUP;
+	reload[4]=mAUDIO_0_ENABLE_RELOAD;
+	running[4]=gAudioEnabled && mAUDIO_0_ENABLE_COUNT && (mAUDIO_0_ENABLE_RELOAD || !mAUDIO_0_TIMER_DONE) && mAUDIO_0_VOLUME && mAUDIO_0_BKUP;
+	observed[4]=TRUE;
+	linked[4]=(mAUDIO_0_LINKING==7);
+
+	current[5]=mAUDIO_1_CURRENT;
+	backup[5]=mAUDIO_1_BKUP;
+	reload[5]=mAUDIO_1_ENABLE_RELOAD;
+	running[5]=gAudioEnabled && mAUDIO_1_ENABLE_COUNT && (mAUDIO_1_ENABLE_RELOAD || !mAUDIO_1_TIMER_DONE) && mAUDIO_1_VOLUME && mAUDIO_1_BKUP;
+	observed[5]=TRUE;
+	linked[5]=(mAUDIO_1_LINKING==7);
+
+	current[6]=mAUDIO_2_CURRENT;
+	backup[6]=mAUDIO_2_BKUP;
+	reload[6]=mAUDIO_2_ENABLE_RELOAD;
+	running[6]=gAudioEnabled && mAUDIO_2_ENABLE_COUNT && (mAUDIO_2_ENABLE_RELOAD || !mAUDIO_2_TIMER_DONE) && mAUDIO_2_VOLUME && mAUDIO_2_BKUP;
+	observed[6]=TRUE;
+	linked[6]=(mAUDIO_2_LINKING==7);
+
+	current[7]=mAUDIO_3_CURRENT;
+	backup[7]=mAUDIO_3_BKUP;
+	reload[7]=mAUDIO_3_ENABLE_RELOAD;
+	running[7]=gAudioEnabled && mAUDIO_3_ENABLE_COUNT && (mAUDIO_3_ENABLE_RELOAD || !mAUDIO_3_TIMER_DONE) && mAUDIO_3_VOLUME && mAUDIO_3_BKUP;
+	observed[7]=TRUE;
+	linked[7]=(mAUDIO_3_LINKING==7);
+
+	if(!running[head]) return FALSE;
+
+	// Find the first timer down the chain whose borrow anyone will see
+	ULONG seen=head;
+	while(!observed[seen] && seen<7 && linked[seen+1] && running[seen+1]) seen++;
+
+	// If nobody ever will we still look in now and again so that the
+	// ticks counted on the next update still fit in a long
+	ULONG wait=EVENT_MAX_WAIT;
+
+	if(observed[seen])
+	{
+		// Count back up the chain how many of our borrows that will take, a
+		// one-shot timer on the way can only ever pass on a single borrow
+		bool reached=TRUE;
+		ULONG borrows=1;
+		for(ULONG loop=seen;loop>head;loop--)
+		{
+			if(borrows>1 && !reload[loop]) reached=FALSE;
+			borrows=current[loop]+1+(borrows-1)*(backup[loop]+1);
+			if(borrows>EVENT_MAX_BORROWS) borrows=EVENT_MAX_BORROWS;
+		}
+		if(borrows>1 && !reload[head]) reached=FALSE;
+
+		// Don't look further ahead than we can count, we simply come back
+		// then and look again
+		if(reached)
+		{
+			ULONG divide=4+linking[head];
+			ULONG period=(backup[head]+1)<<divide;
+			wait=(current[head]+1)<<divide;
+			if(borrows-1>EVENT_MAX_WAIT/period) wait=EVENT_MAX_WAIT; else wait+=(borrows-1)*period;
+		}
+	}
+
+	cycle=lastcount[head]+wait;
+	return TRUE;
 }
 
 ULONG CMikie::GetLfsrNext(ULONG current)
@@ -371,7 +535,16 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTimerInterruptMask,sizeof(ULONG),1,fp)) return 0;
 
 	if(!fwrite(mPalette,sizeof(TPALETTE),16,fp)) return 0;
-	if(!fwrite(mColourMap,sizeof(ULONG),4096,fp)) return 0;
+
+	// The colour map is no longer kept, write it out for older versions
+	{
+		ULONG colours[256];
+		for(ULONG base=0;base<4096;base+=256)
+		{
+			for(ULONG loop=0;loop<256;loop++) colours[loop]=DisplayColour(base+loop);
+			if(!fwrite(colours,sizeof(ULONG),256,fp)) return 0;
+		}
+	}
 
 	if(!fwrite(&mIODAT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mIODAT_REST_SIGNAL,sizeof(ULONG),1,fp)) return 0;
@@ -392,7 +565,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_0_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_0_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_0_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_0_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_0_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_1_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_1_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -404,7 +577,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_1_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_1_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_1_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_1_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_1_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_2_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_2_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -416,7 +589,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_2_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_2_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_2_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_2_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_2_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_3_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_3_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -428,7 +601,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_3_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_3_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_3_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_3_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_3_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_4_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_4_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -440,7 +613,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_4_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_4_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_4_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_4_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_4_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_5_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_5_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -452,7 +625,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_5_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_5_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_5_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_5_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_5_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_6_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_6_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -464,7 +637,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_6_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_6_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_6_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_6_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_6_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mTIM_7_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_7_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -476,7 +649,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mTIM_7_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_7_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mTIM_7_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mTIM_7_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mTIM_7_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 
 	if(!fwrite(&mAUDIO_0_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_0_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -488,7 +661,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mAUDIO_0_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_0_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_0_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mAUDIO_0_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mAUDIO_0_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_0_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_0_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_0_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -504,7 +677,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mAUDIO_1_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_1_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_1_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mAUDIO_1_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mAUDIO_1_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_1_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_1_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_1_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -520,7 +693,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mAUDIO_2_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_2_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_2_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mAUDIO_2_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mAUDIO_2_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_2_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_2_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_2_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -536,7 +709,7 @@ bool CMikie::ContextSave(FILE *fp)
 	if(!fwrite(&mAUDIO_3_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_3_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_3_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!fwrite(&mAUDIO_3_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!fwrite(&mAUDIO_3_LAST_COUNT,sizeof(UCYCLE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_3_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_3_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!fwrite(&mAUDIO_3_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -583,7 +756,16 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTimerInterruptMask,sizeof(ULONG),1,fp)) return 0;
 
 	if(!lss_read(mPalette,sizeof(TPALETTE),16,fp)) return 0;
-	if(!lss_read(mColourMap,sizeof(ULONG),4096,fp)) return 0;
+
+	// Skip the saved colour map, it is rebuilt for the current display
+	{
+		ULONG colours[256];
+		for(ULONG base=0;base<4096;base+=256)
+		{
+			if(!lss_read(colours,sizeof(ULONG),256,fp)) return 0;
+		}
+	}
+	DisplayUpdatePalette();
 
 	if(!lss_read(&mIODAT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mIODAT_REST_SIGNAL,sizeof(ULONG),1,fp)) return 0;
@@ -604,7 +786,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_0_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_0_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_0_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_0_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_0_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_1_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_1_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -616,7 +798,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_1_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_1_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_1_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_1_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_1_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_2_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_2_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -628,7 +810,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_2_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_2_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_2_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_2_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_2_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_3_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_3_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -640,7 +822,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_3_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_3_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_3_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_3_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_3_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_4_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_4_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -652,7 +834,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_4_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_4_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_4_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_4_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_4_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_5_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_5_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -664,7 +846,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_5_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_5_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_5_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_5_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_5_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_6_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_6_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -676,7 +858,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_6_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_6_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_6_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_6_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_6_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mTIM_7_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_7_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -688,7 +870,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mTIM_7_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_7_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mTIM_7_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mTIM_7_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mTIM_7_LAST_COUNT,fp)) return 0;
 
 	if(!lss_read(&mAUDIO_0_BKUP,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_0_ENABLE_RELOAD,sizeof(ULONG),1,fp)) return 0;
@@ -700,7 +882,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mAUDIO_0_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_0_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_0_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mAUDIO_0_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mAUDIO_0_LAST_COUNT,fp)) return 0;
 	if(!lss_read(&mAUDIO_0_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_0_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_0_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -716,7 +898,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mAUDIO_1_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_1_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_1_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mAUDIO_1_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mAUDIO_1_LAST_COUNT,fp)) return 0;
 	if(!lss_read(&mAUDIO_1_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_1_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_1_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -732,7 +914,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mAUDIO_2_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_2_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_2_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mAUDIO_2_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mAUDIO_2_LAST_COUNT,fp)) return 0;
 	if(!lss_read(&mAUDIO_2_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_2_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_2_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -748,7 +930,7 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 	if(!lss_read(&mAUDIO_3_BORROW_IN,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_3_BORROW_OUT,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_3_LAST_LINK_CARRY,sizeof(ULONG),1,fp)) return 0;
-	if(!lss_read(&mAUDIO_3_LAST_COUNT,sizeof(ULONG),1,fp)) return 0;
+	if(!lss_read_cycle(&mAUDIO_3_LAST_COUNT,fp)) return 0;
 	if(!lss_read(&mAUDIO_3_VOLUME,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_3_OUTPUT,sizeof(SBYTE),1,fp)) return 0;
 	if(!lss_read(&mAUDIO_3_INTEGRATE_ENABLE,sizeof(ULONG),1,fp)) return 0;
@@ -772,6 +954,9 @@ bool CMikie::ContextLoad(LSS_FILE *fp)
 
 	if(!lss_read(&mUART_PARITY_ENABLE,sizeof(ULONG),1,fp)) return 0;
 	if(!lss_read(&mUART_PARITY_EVEN,sizeof(ULONG),1,fp)) return 0;
+
+	// The event queue isn't saved, rebuild it from the restored timers
+	ResetEvents();
 	return 1;
 }
 
@@ -811,7 +996,13 @@ void CMikie::ComLynxRxData(int data)
 	{
 		// Trigger incoming receive IF none waiting otherwise
 		// we NEVER get to receive it!!!
-		if(!mUART_Rx_waiting) mUART_RX_COUNTDOWN=UART_RX_TIME_PERIOD;
+		if(!mUART_Rx_waiting)
+		{
+			// The UART timer may have been left to count on its own
+			UpdateTimer4();
+			mUART_RX_COUNTDOWN=UART_RX_TIME_PERIOD;
+			ForceEvent(EVENT_TIMER4);
+		}
 
 		// Receive the byte
 		mUART_Rx_input_queue[mUART_Rx_input_ptr]=data;
@@ -833,7 +1024,11 @@ void CMikie::ComLynxTxLoopback(int data)
 	{
 		// Trigger incoming receive IF none waiting otherwise
 		// we NEVER get to receive it!!!
-		if(!mUART_Rx_waiting) mUART_RX_COUNTDOWN=UART_RX_TIME_PERIOD;
+		if(!mUART_Rx_waiting)
+		{
+			mUART_RX_COUNTDOWN=UART_RX_TIME_PERIOD;
+			ForceEvent(EVENT_TIMER4);
+		}
 
 		// Receive the byte - INSERT into front of queue
 		mUART_Rx_output_ptr=(--mUART_Rx_output_ptr)%UART_MAX_RX_QUEUE;
@@ -859,10 +1054,15 @@ void CMikie::DisplaySetAttributes(ULONG Rotate,ULONG Format,ULONG Pitch,UBYTE* (
 	mDisplayRotate=Rotate;
 	mDisplayFormat=Format;
 	mDisplayPitch=Pitch;
+	DisplaySelectLine();
 	mpDisplayCallback=RenderCallback;
 	mDisplayCallbackObject=objref;
 
 	mpDisplayCurrent=NULL;
+	mFrameLineCount=0;
+	mRotateLineCount=0;
+	mDisplaySameBuffer=FALSE;
+	for(ULONG loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mShownValid[loop]=FALSE;
 
 	if(mpDisplayCallback)
 	{
@@ -874,81 +1074,448 @@ void CMikie::DisplaySetAttributes(ULONG Rotate,ULONG Format,ULONG Pitch,UBYTE* (
 	}
 
 	//
-	// Calculate the colour lookup tabes for the relevant mode
+	// Recalculate the pen colours for the new mode
 	//
+	if(mDisplayFormat>MIKIE_PIXEL_FORMAT_INDEXED)
+	{
+		gError->Warning("CMikie::SetScreenAttributes() - Unrecognised display format");
+	}
+	DisplayUpdatePalette();
+
+	// Reset screen related counters/vars
+	mTIM_0_CURRENT=0;
+	mTIM_2_CURRENT=0;
+
+	// Fix lastcount so that timer update will definately occur
+	mTIM_0_LAST_COUNT-=(1<<(4+mTIM_0_LINKING))+1;
+	mTIM_2_LAST_COUNT-=(1<<(4+mTIM_2_LINKING))+1;
+
+	// Force immediate timer update
+	ForceEvent(EVENT_TIMER0);
+}
+
+
+//
+// Host colour for a 12 bit Lynx palette entry in the current pixel format
+//
+ULONG CMikie::DisplayColour(ULONG index)
+{
 	TPALETTE Spot;
+	ULONG colour;
+
+	Spot.Index=index;
 
 	switch(mDisplayFormat)
 	{
 		case MIKIE_PIXEL_FORMAT_8BPP:
-			for(Spot.Index=0;Spot.Index<4096;Spot.Index++)
-			{
-				mColourMap[Spot.Index]=(Spot.Colours.Red<<4)&0xe0;
-				mColourMap[Spot.Index]|=(Spot.Colours.Green<<1)&0x1c;
-				mColourMap[Spot.Index]|=(Spot.Colours.Blue>>2)&0x03;
-			}
+			colour=(Spot.Colours.Red<<4)&0xe0;
+			colour|=(Spot.Colours.Green<<1)&0x1c;
+			colour|=(Spot.Colours.Blue>>2)&0x03;
 			break;
 		case MIKIE_PIXEL_FORMAT_16BPP_555:
-			for(Spot.Index=0;Spot.Index<4096;Spot.Index++)
-			{
-				mColourMap[Spot.Index]=(Spot.Colours.Red<<11)&0x7c00;
-				mColourMap[Spot.Index]|=(Spot.Colours.Green<<6)&0x03e0;
-				mColourMap[Spot.Index]|=(Spot.Colours.Blue<<1)&0x001f;
-			}
+			colour=(Spot.Colours.Red<<11)&0x7c00;
+			colour|=(Spot.Colours.Green<<6)&0x03e0;
+			colour|=(Spot.Colours.Blue<<1)&0x001f;
 			break;
 		case MIKIE_PIXEL_FORMAT_16BPP_5551:
-			for(Spot.Index=0;Spot.Index<4096;Spot.Index++)
-			{
-				mColourMap[Spot.Index]=(Spot.Colours.Blue<<11)&0x7c00;
-				mColourMap[Spot.Index]|=(Spot.Colours.Green<<6)&0x03e0;
-				mColourMap[Spot.Index]|=(Spot.Colours.Red<<1)&0x001f;
-				mColourMap[Spot.Index]|=0x8000; // 1 bit Alpha set to opaque
-			}
+			colour=(Spot.Colours.Blue<<11)&0x7c00;
+			colour|=(Spot.Colours.Green<<6)&0x03e0;
+			colour|=(Spot.Colours.Red<<1)&0x001f;
+			colour|=0x8000; // 1 bit Alpha set to opaque
 			break;
 		case MIKIE_PIXEL_FORMAT_16BPP_565:
-			for(Spot.Index=0;Spot.Index<4096;Spot.Index++)
-			{
-				mColourMap[Spot.Index]=(Spot.Colours.Red<<12)&0xf800;
-				mColourMap[Spot.Index]|=(Spot.Colours.Green<<7)&0x07e0;
-				mColourMap[Spot.Index]|=(Spot.Colours.Blue<<1)&0x001f;
-			}
+			colour=(Spot.Colours.Red<<12)&0xf800;
+			colour|=(Spot.Colours.Green<<7)&0x07e0;
+			colour|=(Spot.Colours.Blue<<1)&0x001f;
 			break;
 		case MIKIE_PIXEL_FORMAT_24BPP:
 		case MIKIE_PIXEL_FORMAT_32BPP:
-			for(Spot.Index=0;Spot.Index<4096;Spot.Index++)
+			colour=(Spot.Colours.Red<<20)&0x00ff0000;
+			colour|=(Spot.Colours.Green<<12)&0x0000ff00;
+			colour|=(Spot.Colours.Blue<<4)&0x000000ff;
+			break;
+		default:
+			colour=0;
+			break;
+	}
+	return colour;
+}
+
+void CMikie::DisplayUpdatePen(ULONG pen)
+{
+	// Indexed output passes the pen straight through
+	if(mDisplayFormat==MIKIE_PIXEL_FORMAT_INDEXED)
+	{
+		mDisplayPalette[pen]=pen;
+	}
+	else
+	{
+		mDisplayPalette[pen]=DisplayColour(mPalette[pen].Index);
+	}
+	mFramePaletteChanged=TRUE;
+}
+
+void CMikie::DisplayUpdatePalette(void)
+{
+	for(ULONG loop=0;loop<16;loop++) DisplayUpdatePen(loop);
+}
+
+//
+// Give the Lynx colour of each pen for the frame just delivered, as the
+// GREEN register in bits 8-11 and BLUERED in bits 0-7. Returns FALSE if
+// the palette was changed while the frame was being displayed, in which
+// case these are the colours for the end of the frame.
+//
+ULONG CMikie::DisplayGetFramePalette(ULONG *palette)
+{
+	for(ULONG loop=0;loop<16;loop++) palette[loop]=mFrameColours[loop];
+	return !mFrameColoursSplit;
+}
+
+//
+// Fetch the next line of screen DMA from RAM, a flipped line is read
+// backwards and low nibble first so it is gathered into the buffer given
+//
+const UBYTE* CMikie::DisplayFetchLine(UBYTE *buffer)
+{
+	const UBYTE *source;
+
+	if(mDISPCTL_Flip)
+	{
+		for(ULONG loop=0;loop<DISPLAY_LINE_BYTES;loop++)
+		{
+			UBYTE data=mpRamPointer[mLynxAddr-loop];
+			buffer[loop]=(UBYTE)((data<<4)|(data>>4));
+		}
+		source=buffer;
+		mLynxAddr-=DISPLAY_LINE_BYTES;
+	}
+	else
+	{
+		source=mpRamPointer+mLynxAddr;
+		mLynxAddr+=DISPLAY_LINE_BYTES;
+	}
+	return source;
+}
+
+//
+// Render one line of screen DMA, 80 bytes of RAM giving 160 pixels. All
+// of the mode tests fold away at compile time so the loop is branch free.
+// Rotated lines are only converted here, DisplayFlushRotate() writes them
+// out once a block of them has been gathered.
+//
+template<ULONG Rotate,ULONG Format>
+void CMikie::DisplayLine(const UBYTE *source,const ULONG *palette)
+{
+	if(mDisplayScale==1)
+	{
+		if(Rotate==MIKIE_NO_ROTATE)
+		{
+			DisplayConvertLine<Format>(mpDisplayCurrent,source,palette);
+			mpDisplayCurrent+=mDisplayPitch;
+		}
+		else
+		{
+			DisplayConvertLine<Format>(mRotateLine[mRotateLineCount],source,palette);
+			if(++mRotateLineCount==DISPLAY_ROTATE_LINES) DisplayFlushRotate();
+		}
+	}
+	else
+	{
+		// Scaled output widens the line then repeats it, a rotated display
+		// turning the repeats into neighbouring columns
+		DisplayConvertLine<Format>(mScaleLine,source,palette);
+		if(Rotate==MIKIE_NO_ROTATE)
+		{
+			const ULONG bytes=HANDY_SCREEN_WIDTH*mDisplayScale*TDisplayPixel<Format>::Size;
+			DisplayScaleLine<Format>(mpDisplayCurrent,mScaleLine,mDisplayScale);
+			for(ULONG loop=1;loop<mDisplayScale;loop++) memcpy(mpDisplayCurrent+loop*mDisplayPitch,mpDisplayCurrent,bytes);
+			mpDisplayCurrent+=mDisplayPitch*mDisplayScale;
+		}
+		else
+		{
+			for(ULONG loop=0;loop<mDisplayScale;loop++)
 			{
-				mColourMap[Spot.Index]=(Spot.Colours.Red<<20)&0x00ff0000;
-				mColourMap[Spot.Index]|=(Spot.Colours.Green<<12)&0x0000ff00;
-				mColourMap[Spot.Index]|=(Spot.Colours.Blue<<4)&0x000000ff;
+				DisplayScaleLine<Format>(mRotateLine[mRotateLineCount],mScaleLine,mDisplayScale);
+				if(++mRotateLineCount==DISPLAY_ROTATE_LINES) DisplayFlushRotate();
 			}
+		}
+	}
+}
+
+ULONG CMikie::DisplayPixelSize(void)
+{
+	switch(mDisplayFormat)
+	{
+		case MIKIE_PIXEL_FORMAT_8BPP:
+		case MIKIE_PIXEL_FORMAT_INDEXED:
+			return 1;
+		case MIKIE_PIXEL_FORMAT_24BPP:
+			return 3;
+		case MIKIE_PIXEL_FORMAT_32BPP:
+			return 4;
+		default:
+			return 2;
+	}
+}
+
+//
+// Write out the gathered lines of a rotated display. Left rotation steps
+// down the bitmap columns with each line moving one pixel left, right
+// rotation steps up them with each line moving one pixel right.
+//
+void CMikie::DisplayFlushRotate(void)
+{
+	const UBYTE *rows[DISPLAY_ROTATE_LINES];
+	UBYTE *dest;
+	long pitch;
+	ULONG size=DisplayPixelSize();
+	ULONG width=HANDY_SCREEN_WIDTH*mDisplayScale;
+
+	if(!mRotateLineCount || !mpDisplayCurrent) return;
+
+	// Order the lines by destination address
+	if(mDisplayRotate==MIKIE_ROTATE_L)
+	{
+		for(ULONG loop=0;loop<mRotateLineCount;loop++) rows[loop]=mRotateLine[mRotateLineCount-1-loop];
+		dest=mpDisplayCurrent-(mRotateLineCount-1)*size;
+		pitch=mDisplayPitch;
+		mpDisplayCurrent-=mRotateLineCount*size;
+	}
+	else
+	{
+		for(ULONG loop=0;loop<mRotateLineCount;loop++) rows[loop]=mRotateLine[loop];
+		dest=mpDisplayCurrent;
+		pitch=-(long)mDisplayPitch;
+		mpDisplayCurrent+=mRotateLineCount*size;
+	}
+
+	switch(mDisplayFormat)
+	{
+		case MIKIE_PIXEL_FORMAT_8BPP:
+		case MIKIE_PIXEL_FORMAT_INDEXED:
+			DisplayRotateBlock<MIKIE_PIXEL_FORMAT_8BPP>(dest,pitch,rows,mRotateLineCount,width);
+			break;
+		case MIKIE_PIXEL_FORMAT_24BPP:
+			DisplayRotateBlock<MIKIE_PIXEL_FORMAT_24BPP>(dest,pitch,rows,mRotateLineCount,width);
+			break;
+		case MIKIE_PIXEL_FORMAT_32BPP:
+			DisplayRotateBlock<MIKIE_PIXEL_FORMAT_32BPP>(dest,pitch,rows,mRotateLineCount,width);
 			break;
 		default:
-			gError->Warning("CMikie::SetScreenAttributes() - Unrecognised display format");
-			for(Spot.Index=0;Spot.Index<4096;Spot.Index++) mColourMap[Spot.Index]=0;
+			DisplayRotateBlock<MIKIE_PIXEL_FORMAT_16BPP_555>(dest,pitch,rows,mRotateLineCount,width);
 			break;
 	}
+	mRotateLineCount=0;
+}
 
-	// Reset screen related counters/vars
-	mTIM_0_CURRENT=0;
-	mTIM_2_CURRENT=0;
+#define DISPLAY_ROTATION(rotate) \
+	{ \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_8BPP>, \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_16BPP_555>, \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_16BPP_555>, \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_16BPP_555>, \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_24BPP>, \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_32BPP>, \
+		&CMikie::DisplayLine<rotate,MIKIE_PIXEL_FORMAT_8BPP> \
+	}
 
-	// Fix lastcount so that timer update will definately occur
-	mTIM_0_LAST_COUNT-=(1<<(4+mTIM_0_LINKING))+1;
-	mTIM_2_LAST_COUNT-=(1<<(4+mTIM_2_LINKING))+1;
+void CMikie::DisplaySelectLine(void)
+{
+	static const TDisplayLine lines[3][MIKIE_PIXEL_FORMAT_INDEXED+1]=
+	{
+		DISPLAY_ROTATION(MIKIE_NO_ROTATE),
+		DISPLAY_ROTATION(MIKIE_ROTATE_L),
+		DISPLAY_ROTATION(MIKIE_ROTATE_R)
+	};
 
-	// Force immediate timer update
-	gNextTimerEvent=gSystemCycleCount;
+	if(mDisplayRotate<MIKIE_NO_ROTATE || mDisplayRotate>MIKIE_ROTATE_R || mDisplayFormat>MIKIE_PIXEL_FORMAT_INDEXED)
+	{
+		mpDisplayLine=NULL;
+	}
+	else
+	{
+		mpDisplayLine=lines[mDisplayRotate-MIKIE_NO_ROTATE][mDisplayFormat];
+	}
+}
+
+#undef DISPLAY_ROTATION
+
+void CMikie::DisplaySetDeferred(ULONG deferred)
+{
+	// Lines recorded so far belong to the old mode, drop them and start
+	// again with the next frame
+	mDisplayDeferred=deferred;
+	mFrameLineCount=0;
+	mRotateLineCount=0;
+	mpDisplayCurrent=NULL;
 }
 
+//
+// Where the first line of a frame goes, making any necessary adjustment
+// for rotation
+//
+UBYTE* CMikie::DisplayFrameStart(UBYTE *bits)
+{
+	switch(mDisplayRotate)
+	{
+		case MIKIE_ROTATE_L:
+			return bits+DisplayPixelSize()*(HANDY_SCREEN_HEIGHT*mDisplayScale-1);
+		case MIKIE_ROTATE_R:
+			return bits+(mDisplayPitch*(HANDY_SCREEN_WIDTH*mDisplayScale-1));
+		case MIKIE_NO_ROTATE:
+		default:
+			return bits;
+	}
+}
+
+//
+// In headless mode screen DMA keeps its timing, interrupts and REST signal
+// but nothing is converted, the host calls DisplayRenderFrame() for the
+// frames it wants to see
+//
+void CMikie::DisplaySetHeadless(ULONG headless)
+{
+	mDisplayHeadless=headless;
+	mFrameLineCount=0;
+	mRotateLineCount=0;
+	mpDisplayCurrent=NULL;
+	for(ULONG loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mShownValid[loop]=FALSE;
+}
+
+//
+// Write the display scaled up by a whole number, each Lynx pixel becoming
+// a square of scale by scale pixels. The pitch given to DisplaySetAttributes()
+// is that of the scaled image.
+//
+void CMikie::DisplaySetScale(ULONG scale)
+{
+	if(scale<1) scale=1;
+	if(scale>DISPLAY_MAX_SCALE) scale=DISPLAY_MAX_SCALE;
+
+	mDisplayScale=scale;
+	mFrameLineCount=0;
+	mRotateLineCount=0;
+	mpDisplayCurrent=NULL;
+	mDisplaySameBuffer=FALSE;
+	for(ULONG loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mShownValid[loop]=FALSE;
+}
+
+//
+// Build a whole frame into bits from the screen memory at DISPADR and the
+// current palette, using the rotation, format and pitch already set up
+//
+void CMikie::DisplayRenderFrame(UBYTE *bits)
+{
+	UBYTE flipped[DISPLAY_LINE_BYTES];
+
+	if(!bits || !mpDisplayLine) return;
+
+	// Finish any lines in progress before borrowing the line pointers
+	DisplayFlushRotate();
+
+	UBYTE *current=mpDisplayCurrent;
+	ULONG addr=mLynxAddr;
+
+	mpDisplayCurrent=DisplayFrameStart(bits);
+	mLynxAddr=mDisplayAddress&0xfffc;
+	if(mDISPCTL_Flip) mLynxAddr+=3;
+
+	for(ULONG line=0;line<HANDY_SCREEN_HEIGHT;line++)
+	{
+		(this->*mpDisplayLine)(DisplayFetchLine(flipped),mDisplayPalette);
+	}
+	DisplayFlushRotate();
+
+	mpDisplayCurrent=current;
+	mLynxAddr=addr;
+}
+
+void CMikie::DisplaySetLineTracking(ULONG track)
+{
+	mDisplayTrackLines=track;
+	for(ULONG loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mShownValid[loop]=FALSE;
+}
+
+//
+// Flag each line of the frame just delivered that differs from the frame
+// before, returning the number of them. Without line tracking every line
+// is reported as changed.
+//
+ULONG CMikie::DisplayGetDirtyLines(UBYTE *dirty)
+{
+	ULONG count=0;
+
+	for(ULONG loop=0;loop<HANDY_SCREEN_HEIGHT;loop++)
+	{
+		dirty[loop]=mDisplayTrackLines?mLineDirty[loop]:TRUE;
+		if(dirty[loop]) count++;
+	}
+	return count;
+}
+
+//
+// Compare a line of screen DMA and its pen colours with what was shown on
+// that line last time, remembering them for next time if they differ
+//
+ULONG CMikie::DisplayLineChanged(ULONG line,const UBYTE *source)
+{
+	if(mShownValid[line]
+		&& !memcmp(mShownLine[line],source,DISPLAY_LINE_BYTES)
+		&& !memcmp(mShownPalette[line],mDisplayPalette,sizeof(mDisplayPalette))) return FALSE;
+
+	memcpy(mShownLine[line],source,DISPLAY_LINE_BYTES);
+	memcpy(mShownPalette[line],mDisplayPalette,sizeof(mDisplayPalette));
+	mShownValid[line]=TRUE;
+	mLineDirty[line]=TRUE;
+	return TRUE;
+}
+
+//
+// Step over a line that is already in the display buffer
+//
+void CMikie::DisplaySkipLine(void)
+{
+	if(mDisplayRotate==MIKIE_NO_ROTATE)
+	{
+		mpDisplayCurrent+=mDisplayPitch*mDisplayScale;
+	}
+	else
+	{
+		DisplayFlushRotate();
+		if(mDisplayRotate==MIKIE_ROTATE_L) mpDisplayCurrent-=DisplayPixelSize()*mDisplayScale;
+		else mpDisplayCurrent+=DisplayPixelSize()*mDisplayScale;
+	}
+}
+
+//
+// Convert the lines recorded for a deferred frame, each with the pen colours
+// that were in force when its DMA happened
+//
+void CMikie::DisplayFlushFrame(void)
+{
+	if(mpDisplayLine && mpDisplayCurrent)
+	{
+		for(ULONG line=0;line<mFrameLineCount;line++)
+		{
+			if(mDisplayTrackLines && mDisplaySameBuffer && !mLineDirty[line]) DisplaySkipLine();
+			else (this->*mpDisplayLine)(mFrameLine[line],mFramePalette[mFrameLinePalette[line]]);
+		}
+	}
+	mFrameLineCount=0;
+	mFramePaletteCount=0;
+	mFramePaletteChanged=TRUE;
+}
 
 ULONG CMikie::DisplayRenderLine(void)
 {
-	UBYTE *bitmap_tmp=NULL;
-	ULONG source,loop;
 	ULONG work_done=0;
 
-	if(!mpDisplayBits) return 0;
-	if(!mpDisplayCurrent) return 0;
+	if(!mDisplayHeadless)
+	{
+		if(!mpDisplayBits) return 0;
+		if(!mpDisplayCurrent) return 0;
+	}
 	if(!mDISPCTL_DMAEnable) return 0;
 
 //	if(mLynxLine&0x80000000) return 0;
@@ -981,6 +1548,7 @@ ULONG CMikie::DisplayRenderLine(void)
 		}
 		// Trigger line rending to start
 		mLynxLineDMACounter=102;
+		mFrameColoursSplit=FALSE;
 	}
 
 	// Decrement line counter logic
@@ -998,345 +1566,42 @@ ULONG CMikie::DisplayRenderLine(void)
 		// Mikie screen DMA can only see the system RAM....
 		// (Step through bitmap, line at a time)
 
-		// Assign the temporary pointer;
-		bitmap_tmp=mpDisplayCurrent;
+		ULONG line=(HANDY_SCREEN_HEIGHT-1)-mLynxLineDMACounter;
 
-		switch(mDisplayRotate)
+		if(mDisplayHeadless)
 		{
-			case MIKIE_NO_ROTATE:
-				if(mDisplayFormat==MIKIE_PIXEL_FORMAT_8BPP)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=sizeof(UBYTE);
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=sizeof(UBYTE);
-						}
-						else
-						{
-							mLynxAddr++;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=sizeof(UBYTE);
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=sizeof(UBYTE);
-						}
-					}
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_555 
-				  || mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_565
-				  || mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_5551)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=sizeof(UWORD);
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=sizeof(UWORD);
-						}
-						else
-						{
-							mLynxAddr++;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=sizeof(UWORD);
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=sizeof(UWORD);
-						}
-					}	
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_24BPP)
-				{
-					ULONG pixel;
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							pixel=mColourMap[mPalette[source&0x0f].Index];
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;
-							pixel=mColourMap[mPalette[source>>4].Index];
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;
-						}
-						else
-						{
-							mLynxAddr++;
-							pixel=mColourMap[mPalette[source>>4].Index];
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;
-							pixel=mColourMap[mPalette[source&0x0f].Index];
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;	pixel>>=8;
-							*bitmap_tmp++=(UBYTE)pixel;
-						}
-					}	
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_32BPP)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=sizeof(ULONG);
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=sizeof(ULONG);
-						}
-						else
-						{
-							mLynxAddr++;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=sizeof(ULONG);
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=sizeof(ULONG);
-						}
-					}	
-				}
-				mpDisplayCurrent+=mDisplayPitch;
-				break;
-					case MIKIE_ROTATE_L:
-				if(mDisplayFormat==MIKIE_PIXEL_FORMAT_8BPP)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=mDisplayPitch;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=mDisplayPitch;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=mDisplayPitch;
-						}
-					}
-					mpDisplayCurrent-=sizeof(UBYTE);
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_555 
-				  || mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_5551
-				  || mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_565)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=mDisplayPitch;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=mDisplayPitch;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=mDisplayPitch;
-						}
-					}
-					mpDisplayCurrent-=sizeof(UWORD);
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_24BPP)
-				{
-					ULONG pixel;
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							pixel=mColourMap[mPalette[source&0x0f].Index];
-							*(bitmap_tmp)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp+=mDisplayPitch;
-							pixel=mColourMap[mPalette[source>>4].Index];
-							*(bitmap_tmp)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp+=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							pixel=mColourMap[mPalette[source>>4].Index];
-							*(bitmap_tmp)=(UBYTE)pixel;	pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp+=mDisplayPitch;
-							pixel=mColourMap[mPalette[source&0x0f].Index];
-							*(bitmap_tmp)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp+=mDisplayPitch;
-						}
-					}
-					mpDisplayCurrent-=3;
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_32BPP)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=mDisplayPitch;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp+=mDisplayPitch;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp+=mDisplayPitch;
-						}
-					}	
-					mpDisplayCurrent-=sizeof(ULONG);
-				}
-				break;
-			case MIKIE_ROTATE_R:
-				if(mDisplayFormat==MIKIE_PIXEL_FORMAT_8BPP)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp-=mDisplayPitch;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp-=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp-=mDisplayPitch;
-							*(bitmap_tmp)=(UBYTE)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp-=mDisplayPitch;
-						}
-					}
-					mpDisplayCurrent+=sizeof(UBYTE);
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_555 
-				  || mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_5551
-				  || mDisplayFormat==MIKIE_PIXEL_FORMAT_16BPP_565)
-				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp-=mDisplayPitch;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp-=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp-=mDisplayPitch;
-							*((UWORD*)(bitmap_tmp))=(UWORD)mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp-=mDisplayPitch;
-						}
-					}
-					mpDisplayCurrent+=sizeof(UWORD);
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_24BPP)
-				{
-					ULONG pixel;
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							pixel=mColourMap[mPalette[source&0x0f].Index];
-							*(bitmap_tmp)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp-=mDisplayPitch;
-							pixel=mColourMap[mPalette[source>>4].Index];
-							*(bitmap_tmp)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp-=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							pixel=mColourMap[mPalette[source>>4].Index];
-							*(bitmap_tmp)=(UBYTE)pixel;	pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp-=mDisplayPitch;
-							pixel=mColourMap[mPalette[source&0x0f].Index];
-							*(bitmap_tmp)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+1)=(UBYTE)pixel; pixel>>=8;
-							*(bitmap_tmp+2)=(UBYTE)pixel;
-							bitmap_tmp-=mDisplayPitch;
-						}
-					}
-					mpDisplayCurrent+=3;
-				}
-				else if(mDisplayFormat==MIKIE_PIXEL_FORMAT_32BPP)
+			// Only the DMA address moves, nothing is converted
+			if(mDISPCTL_Flip) mLynxAddr-=DISPLAY_LINE_BYTES;
+			else mLynxAddr+=DISPLAY_LINE_BYTES;
+		}
+		else if(mDisplayDeferred)
+		{
+			// Record the line and any change of colours for the end of frame
+			if(mFrameLineCount<HANDY_SCREEN_HEIGHT)
+			{
+				UBYTE *buffer=mFrameLine[mFrameLineCount];
+				const UBYTE *source=DisplayFetchLine(buffer);
+				if(source!=buffer) memcpy(buffer,source,DISPLAY_LINE_BYTES);
+				if(mDisplayTrackLines) DisplayLineChanged(line,buffer);
+
+				if(mFramePaletteChanged)
 				{
-					for(loop=0;loop<SCREEN_WIDTH/2;loop++)
-					{
-						source=mpRamPointer[mLynxAddr];
-						if(mDISPCTL_Flip)
-						{
-							mLynxAddr--;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp-=mDisplayPitch;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp-=mDisplayPitch;
-						}
-						else
-						{
-							mLynxAddr++;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source>>4].Index];
-							bitmap_tmp-=mDisplayPitch;
-							*((ULONG*)(bitmap_tmp))=mColourMap[mPalette[source&0x0f].Index];
-							bitmap_tmp-=mDisplayPitch;
-						}
-					}	
-					mpDisplayCurrent+=sizeof(ULONG);
+					memcpy(mFramePalette[mFramePaletteCount],mDisplayPalette,sizeof(mDisplayPalette));
+					mFramePaletteCount++;
+					mFramePaletteChanged=FALSE;
 				}
-				break;
-			default:
-				break;
+				mFrameLinePalette[mFrameLineCount]=mFramePaletteCount-1;
+				mFrameLineCount++;
+			}
+		}
+		else if(mpDisplayLine)
+		{
+			UBYTE flipped[DISPLAY_LINE_BYTES];
+			const UBYTE *source=DisplayFetchLine(flipped);
+
+			// Lines unchanged since the last frame are still in the buffer
+			if(mDisplayTrackLines && !DisplayLineChanged(line,source) && mDisplaySameBuffer) DisplaySkipLine();
+			else (this->*mpDisplayLine)(source,mDisplayPalette);
 		}
 	}
 	return work_done;
@@ -1348,6 +1613,9 @@ ULONG CMikie::DisplayEndOfFrame(void)
 	mLynxLineDMACounter=0;
 	mLynxLine=mTIM_2_BKUP;
 
+	// Let CSystem::RunFrame() know the frame is done
+	gEndOfFrame=TRUE;
+
 	// Set the timer status flag
 	if(mTimerInterruptMask&0x04)
 	{
@@ -1356,46 +1624,30 @@ ULONG CMikie::DisplayEndOfFrame(void)
 		gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
 	}
 
+	// A deferred frame is converted in one go before it is handed over,
+	// along with the last lines of a rotated display
+	if(mDisplayDeferred) DisplayFlushFrame();
+	DisplayFlushRotate();
+
+	// Keep the colours for DisplayGetFramePalette()
+	for(ULONG loop=0;loop<16;loop++)
+	{
+		mFrameColours[loop]=(mPalette[loop].Colours.Green<<8)|(mPalette[loop].Colours.Blue<<4)|mPalette[loop].Colours.Red;
+	}
+
 //	TRACE_MIKIE0("Update() - Frame end");
 	// Trigger the callback to the display sub-system to render the
 	// display and fetch the new pointer to be used for the lynx
 	// display buffer for the forthcoming frame
+	UBYTE *shown=mpDisplayBits;
 	if(mpDisplayCallback) mpDisplayBits=(*mpDisplayCallback)(mDisplayCallbackObject);
 
+	// Unchanged lines can only be skipped if the same buffer comes back
+	mDisplaySameBuffer=(mpDisplayBits==shown && shown!=NULL);
+	for(ULONG loop=0;loop<HANDY_SCREEN_HEIGHT;loop++) mLineDirty[loop]=FALSE;
+
 	// Reinitialise the screen buffer pointer
-	// Make any necessary adjustment for rotation
-	switch(mDisplayRotate)
-	{
-		case MIKIE_ROTATE_L:
-			mpDisplayCurrent=mpDisplayBits;
-			switch(mDisplayFormat)
-			{
-				case MIKIE_PIXEL_FORMAT_8BPP:
-					mpDisplayCurrent+=1*(HANDY_SCREEN_HEIGHT-1);
-					break;
-				case MIKIE_PIXEL_FORMAT_16BPP_555:
-				case MIKIE_PIXEL_FORMAT_16BPP_5551:
-				case MIKIE_PIXEL_FORMAT_16BPP_565:
-					mpDisplayCurrent+=2*(HANDY_SCREEN_HEIGHT-1);
-					break;
-				case MIKIE_PIXEL_FORMAT_24BPP:
-					mpDisplayCurrent+=3*(HANDY_SCREEN_HEIGHT-1);
-					break;
-				case MIKIE_PIXEL_FORMAT_32BPP:
-					mpDisplayCurrent+=4*(HANDY_SCREEN_HEIGHT-1);
-					break;
-				default:
-					break;
-			}
-			break;
-		case MIKIE_ROTATE_R:
-			mpDisplayCurrent=mpDisplayBits+(mDisplayPitch*(HANDY_SCREEN_WIDTH-1));
-			break;
-		case MIKIE_NO_ROTATE:
-			default:
-			mpDisplayCurrent=mpDisplayBits;
-			break;
-	}
+	mpDisplayCurrent=DisplayFrameStart(mpDisplayBits);
 	return 0;
 }
 
@@ -1403,6 +1655,10 @@ ULONG CMikie::DisplayEndOfFrame(void)
 
 void CMikie::Poke(ULONG addr,UBYTE data)
 {
+	// Timers nobody is watching are counted lazily, they must be up to
+	// date before any timer or audio register changes under them
+	if(addr<=AUD3MISC) SyncTimers();
+
 	switch(addr&0xff)
 	{
 		case (TIM0BKUP&0xff): 
@@ -1411,6 +1667,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (TIM1BKUP&0xff): 
 			mTIM_1_BKUP=data;
+			ForceEvent(EVENT_TIMER1);
 			TRACE_MIKIE2("Poke(TIM1BKUP,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM2BKUP&0xff): 
@@ -1419,6 +1676,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (TIM3BKUP&0xff): 
 			mTIM_3_BKUP=data;
+			ForceEvent(EVENT_TIMER3);
 			TRACE_MIKIE2("Poke(TIM3BKUP,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM4BKUP&0xff): 
@@ -1427,6 +1685,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (TIM5BKUP&0xff): 
 			mTIM_5_BKUP=data;
+			ForceEvent(EVENT_TIMER5);
 			TRACE_MIKIE2("Poke(TIM5BKUP,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM6BKUP&0xff): 
@@ -1435,6 +1694,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (TIM7BKUP&0xff):
 			mTIM_7_BKUP=data;
+			ForceEvent(EVENT_TIMER7);
 			TRACE_MIKIE2("Poke(TIM7BKUP,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 
@@ -1449,7 +1709,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_0_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER0);
 			}
 			TRACE_MIKIE2("Poke(TIM0CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1463,7 +1723,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_1_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER1);
 			}
 			TRACE_MIKIE2("Poke(TIM1CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1477,7 +1737,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_2_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER0);
 			}
 			TRACE_MIKIE2("Poke(TIM2CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1491,7 +1751,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_3_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER3);
 			}
 			TRACE_MIKIE2("Poke(TIM3CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1505,7 +1765,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_4_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER4);
 			}
 			TRACE_MIKIE2("Poke(TIM4CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1519,7 +1779,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_5_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER5);
 			}
 			TRACE_MIKIE2("Poke(TIM5CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1533,7 +1793,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_6_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER6);
 			}
 			TRACE_MIKIE2("Poke(TIM6CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1547,7 +1807,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mTIM_7_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_TIMER7);
 			}
 			TRACE_MIKIE2("Poke(TIM7CTLA,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1555,42 +1815,42 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 
 		case (TIM0CNT&0xff): 
 			mTIM_0_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER0);
 			TRACE_MIKIE2("Poke(TIM0CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM1CNT&0xff): 
 			mTIM_1_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER1);
 			TRACE_MIKIE2("Poke(TIM1CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM2CNT&0xff): 
 			mTIM_2_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER0);
 			TRACE_MIKIE2("Poke(TIM2CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM3CNT&0xff): 
 			mTIM_3_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER3);
 			TRACE_MIKIE2("Poke(TIM3CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM4CNT&0xff): 
 			mTIM_4_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER4);
 			TRACE_MIKIE2("Poke(TIM4CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM5CNT&0xff): 
 			mTIM_5_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER5);
 			TRACE_MIKIE2("Poke(TIM5CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM6CNT&0xff): 
 			mTIM_6_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER6);
 			TRACE_MIKIE2("Poke(TIM6CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (TIM7CNT&0xff): 
 			mTIM_7_CURRENT=data;
-			gNextTimerEvent=gSystemCycleCount;
+			ForceEvent(EVENT_TIMER7);
 			TRACE_MIKIE2("Poke(TIM7CNT ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 
@@ -1599,6 +1859,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_0_LAST_CLOCK=data&0x04;
 			mTIM_0_BORROW_IN=data&0x02;
 			mTIM_0_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER0);
 			TRACE_MIKIE2("Poke(TIM0CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1607,6 +1868,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_1_LAST_CLOCK=data&0x04;
 			mTIM_1_BORROW_IN=data&0x02;
 			mTIM_1_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER1);
 			TRACE_MIKIE2("Poke(TIM1CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1615,6 +1877,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_2_LAST_CLOCK=data&0x04;
 			mTIM_2_BORROW_IN=data&0x02;
 			mTIM_2_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER0);
 			TRACE_MIKIE2("Poke(TIM2CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1623,6 +1886,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_3_LAST_CLOCK=data&0x04;
 			mTIM_3_BORROW_IN=data&0x02;
 			mTIM_3_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER3);
 			TRACE_MIKIE2("Poke(TIM3CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1631,6 +1895,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_4_LAST_CLOCK=data&0x04;
 			mTIM_4_BORROW_IN=data&0x02;
 			mTIM_4_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER4);
 			TRACE_MIKIE2("Poke(TIM4CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1639,6 +1904,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_5_LAST_CLOCK=data&0x04;
 			mTIM_5_BORROW_IN=data&0x02;
 			mTIM_5_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER5);
 			TRACE_MIKIE2("Poke(TIM5CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1647,6 +1913,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_6_LAST_CLOCK=data&0x04;
 			mTIM_6_BORROW_IN=data&0x02;
 			mTIM_6_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER6);
 			TRACE_MIKIE2("Poke(TIM6CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1655,6 +1922,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			mTIM_7_LAST_CLOCK=data&0x04;
 			mTIM_7_BORROW_IN=data&0x02;
 			mTIM_7_BORROW_OUT=data&0x01;
+			ForceEvent(EVENT_TIMER7);
 			TRACE_MIKIE2("Poke(TIM7CTLB ,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 //			BlowOut();
 			break;
@@ -1665,7 +1933,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_0_VOLUME && data)
 			{
 				mAUDIO_0_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO0);
 			}
 			mAUDIO_0_VOLUME=(SBYTE)data;
 			TRACE_MIKIE2("Poke(AUD0VOL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1677,6 +1945,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (AUD0OUTVAL&0xff): 
 			mAUDIO_0_OUTPUT=data;
+			if(mAudioEventsEnabled) UpdateSound(gSystemCycleCount);
 			TRACE_MIKIE2("Poke(AUD0OUTVAL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (AUD0L8SHFT&0xff): 
@@ -1691,7 +1960,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_0_BKUP && data)
 			{
 				mAUDIO_0_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO0);
 			}
 			mAUDIO_0_BKUP=data;
 			TRACE_MIKIE2("Poke(AUD0TBACK,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1707,7 +1976,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mAUDIO_0_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO0);
 			}
 			TRACE_MIKIE2("Poke(AUD0CTL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1730,7 +1999,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_1_VOLUME && data)
 			{
 				mAUDIO_1_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO1);
 			}
 			mAUDIO_1_VOLUME=(SBYTE)data;
 			TRACE_MIKIE2("Poke(AUD1VOL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1742,6 +2011,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (AUD1OUTVAL&0xff): 
 			mAUDIO_1_OUTPUT=data;
+			if(mAudioEventsEnabled) UpdateSound(gSystemCycleCount);
 			TRACE_MIKIE2("Poke(AUD1OUTVAL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (AUD1L8SHFT&0xff): 
@@ -1756,7 +2026,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_1_BKUP && data)
 			{
 				mAUDIO_1_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO1);
 			}
 			mAUDIO_1_BKUP=data;
 			TRACE_MIKIE2("Poke(AUD1TBACK,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1772,7 +2042,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mAUDIO_1_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO1);
 			}
 			TRACE_MIKIE2("Poke(AUD1CTL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1795,7 +2065,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_2_VOLUME && data)
 			{
 				mAUDIO_2_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO2);
 			}
 			mAUDIO_2_VOLUME=(SBYTE)data;
 			TRACE_MIKIE2("Poke(AUD2VOL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1807,6 +2077,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (AUD2OUTVAL&0xff): 
 			mAUDIO_2_OUTPUT=data;
+			if(mAudioEventsEnabled) UpdateSound(gSystemCycleCount);
 			TRACE_MIKIE2("Poke(AUD2OUTVAL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (AUD2L8SHFT&0xff): 
@@ -1821,7 +2092,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_2_BKUP && data)
 			{
 				mAUDIO_2_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO2);
 			}
 			mAUDIO_2_BKUP=data;
 			TRACE_MIKIE2("Poke(AUD2TBACK,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1837,7 +2108,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mAUDIO_2_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO2);
 			}
 			TRACE_MIKIE2("Poke(AUD2CTL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1860,7 +2131,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_3_VOLUME && data)
 			{
 				mAUDIO_3_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO3);
 			}
 			mAUDIO_3_VOLUME=(SBYTE)data;
 			TRACE_MIKIE2("Poke(AUD3VOL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1872,6 +2143,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			break;
 		case (AUD3OUTVAL&0xff): 
 			mAUDIO_3_OUTPUT=data;
+			if(mAudioEventsEnabled) UpdateSound(gSystemCycleCount);
 			TRACE_MIKIE2("Poke(AUD3OUTVAL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 		case (AUD3L8SHFT&0xff): 
@@ -1886,7 +2158,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(!mAUDIO_3_BKUP && data)
 			{
 				mAUDIO_3_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO3);
 			}
 			mAUDIO_3_BKUP=data;
 			TRACE_MIKIE2("Poke(AUD3TBACK,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
@@ -1902,7 +2174,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(data&0x48)
 			{
 				mAUDIO_3_LAST_COUNT=gSystemCycleCount;
-				gNextTimerEvent=gSystemCycleCount;
+				ForceEvent(EVENT_AUDIO3);
 			}
 			TRACE_MIKIE2("Poke(AUD3CTL,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
@@ -1950,13 +2222,15 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 //				gNextTimerEvent=gSystemCycleCount;
 //			}
 			mSTEREO=data;
+			if(mAudioEventsEnabled) UpdateSound(gSystemCycleCount);
 			TRACE_MIKIE2("Poke(MSTEREO,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			break;
 
 		case (INTRST&0xff):
 			data^=0xff;
 			mTimerStatusFlags&=data;
-			gNextTimerEvent=gSystemCycleCount;
+			// Force an update so a level sensitive UART IRQ is re-asserted
+			ForceEvent(EVENT_TIMER4);
 // 22/09/06 Fix to championship rally, IRQ not getting cleared with edge triggered system
 			gSystemIRQ=(mTimerStatusFlags&mTimerInterruptMask)?TRUE:FALSE;
 // 22/09/06 Fix to championship rally, IRQ not getting cleared with edge triggered system
@@ -1969,7 +2243,8 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 // 22/09/06 Fix to championship rally, IRQ not getting cleared with edge triggered system
 			gSystemIRQ=(mTimerStatusFlags&mTimerInterruptMask)?TRUE:FALSE;
 // 22/09/06 Fix to championship rally, IRQ not getting cleared with edge triggered system
-			gNextTimerEvent=gSystemCycleCount;
+			// Force an update so a level sensitive UART IRQ is re-asserted
+			ForceEvent(EVENT_TIMER4);
 			break;
 
 		case (SYSCTL1&0xff):
@@ -2022,7 +2297,9 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			if(mUART_SENDBREAK)
 			{
 				// Trigger send break, it will self sustain as long as sendbreak is set
+				UpdateTimer4();
 				mUART_TX_COUNTDOWN=UART_TX_TIME_PERIOD;
+				ForceEvent(EVENT_TIMER4);
 				// Loop back what we transmitted
 				ComLynxTxLoopback(UART_BREAK_CODE);
 			}
@@ -2048,8 +2325,11 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 				// If disabled then the PAREVEN bit is sent
 				if(mUART_PARITY_EVEN) data|=0x0100;
 			}
-			// Set countdown to transmission
+			// Set countdown to transmission, the UART timer may have been
+			// left to count on its own until now
+			UpdateTimer4();
 			mUART_TX_COUNTDOWN=UART_TX_TIME_PERIOD;
+			ForceEvent(EVENT_TIMER4);
 			// Loop back what we transmitted
 			ComLynxTxLoopback(mUART_TX_DATA);
 			break;
@@ -2070,6 +2350,7 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 				TRACE_MIKIE0("*********************************************************");
 				SLONG cycles_used=(SLONG)mSystem.PaintSprites();
 				gCPUWakeupTime=gSystemCycleCount+cycles_used;
+				ScheduleEvent(EVENT_WAKEUP,gCPUWakeupTime);
 				SetCPUSleep();
 				TRACE_MIKIE2("Poke(CPUSLEEP,%02x) wakeup at cycle =%012d",data,gCPUWakeupTime);
 			}
@@ -2132,6 +2413,8 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 		case (GREENF&0xff):
 			TRACE_MIKIE2("Poke(GREENPAL0-F,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			mPalette[addr&0x0f].Colours.Green=data&0x0f;
+			DisplayUpdatePen(addr&0x0f);
+			if(mLynxLineDMACounter) mFrameColoursSplit=TRUE;
 			break;
 
 		case (BLUERED0&0xff): 
@@ -2153,6 +2436,8 @@ void CMikie::Poke(ULONG addr,UBYTE data)
 			TRACE_MIKIE2("Poke(BLUEREDPAL0-F,%02x) at PC=%04x",data,mSystem.mCpu->GetPC());
 			mPalette[addr&0x0f].Colours.Blue=(data&0xf0)>>4;
 			mPalette[addr&0x0f].Colours.Red=data&0x0f;
+			DisplayUpdatePen(addr&0x0f);
+			if(mLynxLineDMACounter) mFrameColoursSplit=TRUE;
 			break;
 
 // Errors on read only register accesses
@@ -2304,42 +2589,44 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 
 		case (TIM0CNT&0xff): 
+			ForceEvent(EVENT_TIMER0);
 			Update();
 			TRACE_MIKIE2("Peek(TIM0CNT  ,%02x) at PC=%04x",mTIM_0_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_0_CURRENT;
 			break;
 		case (TIM1CNT&0xff): 
-			Update();
+			SyncTimers();
 			TRACE_MIKIE2("Peek(TIM1CNT  ,%02x) at PC=%04x",mTIM_1_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_1_CURRENT;
 			break;
 		case (TIM2CNT&0xff): 
+			ForceEvent(EVENT_TIMER0);
 			Update();
 			TRACE_MIKIE2("Peek(TIM2CNT  ,%02x) at PC=%04x",mTIM_2_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_2_CURRENT;
 			break;
 		case (TIM3CNT&0xff): 
-			Update();
+			SyncTimers();
 			TRACE_MIKIE2("Peek(TIM3CNT  ,%02x) at PC=%04x",mTIM_3_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_3_CURRENT;
 			break;
 		case (TIM4CNT&0xff): 
-			Update();
+			SyncTimers();
 			TRACE_MIKIE2("Peek(TIM4CNT  ,%02x) at PC=%04x",mTIM_4_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_4_CURRENT;
 			break;
 		case (TIM5CNT&0xff): 
-			Update();
+			SyncTimers();
 			TRACE_MIKIE2("Peek(TIM5CNT  ,%02x) at PC=%04x",mTIM_5_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_5_CURRENT;
 			break;
 		case (TIM6CNT&0xff): 
-			Update();
+			SyncTimers();
 			TRACE_MIKIE2("Peek(TIM6CNT  ,%02x) at PC=%04x",mTIM_6_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_6_CURRENT;
 			break;
 		case (TIM7CNT&0xff): 
-			Update();
+			SyncTimers();
 			TRACE_MIKIE2("Peek(TIM7CNT  ,%02x) at PC=%04x",mTIM_7_CURRENT,mSystem.mCpu->GetPC());
 			return (UBYTE)mTIM_7_CURRENT;
 			break;
@@ -2358,6 +2645,7 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 		case (TIM1CTLB&0xff): 
 			{
+				SyncTimers();
 				UBYTE retval=0;
 				retval|=(mTIM_1_TIMER_DONE)?0x08:0x00;
 				retval|=(mTIM_1_LAST_CLOCK)?0x04:0x00;
@@ -2382,6 +2670,7 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 		case (TIM3CTLB&0xff): 
 			{
+				SyncTimers();
 				UBYTE retval=0;
 				retval|=(mTIM_3_TIMER_DONE)?0x08:0x00;
 				retval|=(mTIM_3_LAST_CLOCK)?0x04:0x00;
@@ -2394,6 +2683,7 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 		case (TIM4CTLB&0xff): 
 			{
+				SyncTimers();
 				UBYTE retval=0;
 				retval|=(mTIM_4_TIMER_DONE)?0x08:0x00;
 				retval|=(mTIM_4_LAST_CLOCK)?0x04:0x00;
@@ -2406,6 +2696,7 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 		case (TIM5CTLB&0xff): 
 			{
+				SyncTimers();
 				UBYTE retval=0;
 				retval|=(mTIM_5_TIMER_DONE)?0x08:0x00;
 				retval|=(mTIM_5_LAST_CLOCK)?0x04:0x00;
@@ -2418,6 +2709,7 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 		case (TIM6CTLB&0xff): 
 			{
+				SyncTimers();
 				UBYTE retval=0;
 				retval|=(mTIM_6_TIMER_DONE)?0x08:0x00;
 				retval|=(mTIM_6_LAST_CLOCK)?0x04:0x00;
@@ -2430,6 +2722,7 @@ UBYTE CMikie::Peek(ULONG addr)
 			break;
 		case (TIM7CTLB&0xff):
 			{
+				SyncTimers();
 				UBYTE retval=0;
 				retval|=(mTIM_7_TIMER_DONE)?0x08:0x00;
 				retval|=(mTIM_7_LAST_CLOCK)?0x04:0x00;
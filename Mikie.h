@@ -73,6 +73,12 @@ class CSystem;
 #define MIKIE_START	0xfd00
 #define MIKIE_SIZE	0x100
 
+// Lines of a rotated display gathered before being written as columns
+#define DISPLAY_ROTATE_LINES	8
+
+// Largest integer scaling of the display output
+#define DISPLAY_MAX_SCALE		4
+
 //
 // Define counter types and defines
 //
@@ -102,6 +108,29 @@ class CSystem;
 #define UART_RX_TIME_PERIOD	(11)
 #define UART_RX_NEXT_DELAY	(44)
 
+//
+// Timer events, numbered in group order so that events falling due on
+// the same cycle are serviced in the order the hardware chains them
+//
+
+#define EVENT_WAKEUP	0
+#define EVENT_TIMER0	1
+#define EVENT_TIMER4	2
+#define EVENT_TIMER1	3
+#define EVENT_TIMER3	4
+#define EVENT_TIMER5	5
+#define EVENT_TIMER7	6
+#define EVENT_TIMER6	7
+#define EVENT_AUDIO0	8
+#define EVENT_AUDIO1	9
+#define EVENT_AUDIO2	10
+#define EVENT_AUDIO3	11
+#define EVENT_COUNT		12
+#define EVENT_IDLE		0xff
+
+#define EVENT_MAX_BORROWS	0x10000
+#define EVENT_MAX_WAIT		0x10000000
+
 typedef struct
 {
 	UBYTE	backup;
@@ -179,6 +208,7 @@ enum
 	MIKIE_PIXEL_FORMAT_16BPP_565,
 	MIKIE_PIXEL_FORMAT_24BPP,
 	MIKIE_PIXEL_FORMAT_32BPP,
+	MIKIE_PIXEL_FORMAT_INDEXED,		// 8 bit pen numbers, see DisplayGetFramePalette()
 };
 
 class CMikie : public CLynxBase
@@ -206,6 +236,18 @@ class CMikie : public CLynxBase
 		
 		void	DisplaySetAttributes(ULONG Rotate, ULONG Format, ULONG Pitch, UBYTE* (*DisplayCallback)(ULONG objref),ULONG objref);
     ULONG DisplayGetRotation()  { return mDisplayRotate; }
+		void	DisplaySetDeferred(ULONG deferred);
+		ULONG	DisplayGetFramePalette(ULONG *palette);
+		void	DisplaySetLineTracking(ULONG track);
+		void	DisplaySetHeadless(ULONG headless);
+		void	DisplaySetScale(ULONG scale);
+		ULONG	DisplayGetScale(void) { return mDisplayScale; };
+		void	DisplayRenderFrame(UBYTE *bits);
+		ULONG	DisplayGetDirtyLines(UBYTE *dirty);
+		ULONG	DisplayGetDeferred(void) { return mDisplayDeferred; };
+
+		void	AudioSetSampleFreq(ULONG freq);
+		ULONG	AudioGetSampleFreq(void) { return mBlip.GetSampleFreq(); };
 		
 		void	BlowOut(void);
 
@@ -217,65 +259,37 @@ class CMikie : public CLynxBase
 
 		inline void	Update(void)
 		{
-			SLONG divide;
-			SLONG decval;
-			ULONG tmp;
 			ULONG mikie_work_done=0;
 
-			//
-			// To stop problems with cycle count wrap we will check and then correct the
-			// cycle counter.
-			//
-
 //			TRACE_MIKIE0("Update()");
 
-			if(gSystemCycleCount>0xf0000000)
-			{
-				gSystemCycleCount-=0x80000000;
-				gThrottleNextCycleCheckpoint-=0x80000000;
-				gAudioLastUpdateCycle-=0x80000000;
-				mTIM_0_LAST_COUNT-=0x80000000;
-				mTIM_1_LAST_COUNT-=0x80000000;
-				mTIM_2_LAST_COUNT-=0x80000000;
-				mTIM_3_LAST_COUNT-=0x80000000;
-				mTIM_4_LAST_COUNT-=0x80000000;
-				mTIM_5_LAST_COUNT-=0x80000000;
-				mTIM_6_LAST_COUNT-=0x80000000;
-				mTIM_7_LAST_COUNT-=0x80000000;
-				mAUDIO_0_LAST_COUNT-=0x80000000;
-				mAUDIO_1_LAST_COUNT-=0x80000000;
-				mAUDIO_2_LAST_COUNT-=0x80000000;
-				mAUDIO_3_LAST_COUNT-=0x80000000;
-				// Only correct if sleep is active
-				if(gCPUWakeupTime)
-				{
-					gCPUWakeupTime-=0x80000000;
-					gIRQEntryCycle-=0x80000000;
-				}
-			}
-
-			gNextTimerEvent=0xffffffff;
-
 			//
-			// Check if the CPU needs to be woken up from sleep mode
+			// If sound has just come back on then the synthesiser starts
+			// again from here, steps in the channel outputs are fed to it
+			// as each event is serviced.
 			//
-			if(gCPUWakeupTime)
+			if(gAudioEnabled)
 			{
-				if(gSystemCycleCount>=gCPUWakeupTime)
-				{
-					TRACE_MIKIE0("*********************************************************");
-					TRACE_MIKIE0("****              CPU SLEEP COMPLETED                ****");
-					TRACE_MIKIE0("*********************************************************");
-					ClearCPUSleep();
-					gCPUWakeupTime=0;			
-				}
-				else
+				// Audio channels are not serviced while sound is off so
+				// restart them all when it comes back on, including any
+				// clocked from a timer that nobody else was watching
+				if(!mAudioEventsEnabled)
 				{
-					if(gCPUWakeupTime>gSystemCycleCount) gNextTimerEvent=gCPUWakeupTime;
+					mBlip.Reset(gSystemCycleCount);
+					mAudioLeft=0;
+					mAudioRight=0;
+					ForceEvent(EVENT_AUDIO0);
+					ForceEvent(EVENT_AUDIO1);
+					ForceEvent(EVENT_AUDIO2);
+					ForceEvent(EVENT_AUDIO3);
+					SyncTimers();
 				}
 			}
+			mAudioEventsEnabled=gAudioEnabled;
 
-			//	Timer updates, rolled out flat in group order
+			//
+			// Service every event that has fallen due, earliest first and in group
+			// order on a tie.
 			//
 			//	Group A:
 			//	Timer 0 -> Timer 2 -> Timer 4. 
@@ -283,27 +297,289 @@ class CMikie : public CLynxBase
 			//	Group B:
 			//	Timer 1 -> Timer 3 -> Timer 5 -> Timer 7 -> Audio 0 -> Audio 1-> Audio 2 -> Audio 3 -> Timer 1. 
 			//
-
-			//
-			// Within each timer code block we will predict the cycle count number of
-			// the next timer event
-			//
-			// We don't need to count linked timers as the timer they are linked
-			// from will always generate earlier events.
-			//
-			// As Timer 4 (UART) will generate many events we will ignore it
-			//
-			// We set the next event to the end of time at first and let the timers
-			// overload it. Any writes to timer controls will force next event to
-			// be immediate and hence a new preidction will be done. The prediction
-			// causes overflow as opposed to zero i.e. current+1
+			// Linked timers have no event of their own, they can only count when
+			// the timer they are linked to borrows so they are clocked from that
+			// timer's service, forcing one of their events resyncs the chains.
+			// Every free running timer reschedules itself for the exact cycle
+			// of its next borrow that anyone will see, any writes to timer
+			// controls will force an immediate event and hence a new schedule.
 			// (In reality T0 line counter should always be running.)
 			//
+			while(mEventCount && mEventTime[mEventHeap[0]]<=gSystemCycleCount)
+			{
+				UCYCLE when=mEventTime[mEventHeap[0]];
 
-			
-			//
-			// Timer 0 of Group A
-			//
+				switch(PopEvent())
+				{
+					case EVENT_WAKEUP:
+						//
+						// Check if the CPU needs to be woken up from sleep mode
+						//
+						if(gCPUWakeupTime)
+						{
+							if(gSystemCycleCount>=gCPUWakeupTime)
+							{
+								TRACE_MIKIE0("*********************************************************");
+								TRACE_MIKIE0("****              CPU SLEEP COMPLETED                ****");
+								TRACE_MIKIE0("*********************************************************");
+								ClearCPUSleep();
+								gCPUWakeupTime=0;			
+							}
+							else
+							{
+								// An RTI back into sleep will have pushed the wakeup out
+								ScheduleEvent(EVENT_WAKEUP,gCPUWakeupTime);
+							}
+						}
+						break;
+					case EVENT_TIMER0:
+						mikie_work_done+=UpdateTimer0();
+						break;
+					case EVENT_TIMER4:
+						UpdateTimer4();
+						break;
+					case EVENT_TIMER1:
+						UpdateTimer1();
+						break;
+					case EVENT_TIMER3:
+						if(mTIM_3_LINKING!=7) UpdateTimer3(0); else SyncTimers();
+						break;
+					case EVENT_TIMER5:
+						if(mTIM_5_LINKING!=7) UpdateTimer5(0); else SyncTimers();
+						break;
+					case EVENT_TIMER7:
+						if(mTIM_7_LINKING!=7) UpdateTimer7(0); else SyncTimers();
+						break;
+					case EVENT_TIMER6:
+						UpdateTimer6();
+						break;
+					case EVENT_AUDIO0:
+						if(gAudioEnabled && mAUDIO_0_LINKING!=7) UpdateAudio0(0); else SyncTimers();
+						break;
+					case EVENT_AUDIO1:
+						if(gAudioEnabled && mAUDIO_1_LINKING!=7) UpdateAudio1(0); else SyncTimers();
+						break;
+					case EVENT_AUDIO2:
+						if(gAudioEnabled && mAUDIO_2_LINKING!=7) UpdateAudio2(0); else SyncTimers();
+						break;
+					case EVENT_AUDIO3:
+						if(gAudioEnabled && mAUDIO_3_LINKING!=7) UpdateAudio3(0); else SyncTimers();
+						break;
+					default:
+						break;
+				}
+
+				// Any output change happened on the borrow that raised the event
+				if(gAudioEnabled) UpdateSound(when);
+			}
+
+			// Everything up to now is final, let the host have it
+			if(gAudioEnabled) mBlip.Flush(gSystemCycleCount);
+
+			// Emulate the UART bug where UART IRQ is level sensitive
+			// in that it will continue to generate interrupts as long
+			// as they are enabled and the interrupt condition is true
+
+			// If Tx is inactive i.e ready for a byte to eat and the
+			// IRQ is enabled then generate it always
+			if((mUART_TX_COUNTDOWN&UART_TX_INACTIVE) && mUART_TX_IRQ_ENABLE)
+			{
+				TRACE_MIKIE0("Update() - UART TX IRQ Triggered");
+				mTimerStatusFlags|=0x10;
+				gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
+			}
+			// Is data waiting and the interrupt enabled, if so then
+			// what are we waiting for....
+			if(mUART_RX_READY && mUART_RX_IRQ_ENABLE)
+			{
+				TRACE_MIKIE0("Update() - UART RX IRQ Triggered");
+				mTimerStatusFlags|=0x10;
+				gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
+			}
+		
+			gNextTimerEvent=(mEventCount)?mEventTime[mEventHeap[0]]:HANDY_CYCLE_NEVER;
+
+//			if(gSystemCycleCount==gNextTimerEvent) gError->Warning("CMikie::Update() - gSystemCycleCount==gNextTimerEvent, system lock likely");
+//			TRACE_MIKIE1("Update() - NextTimerEvent = %012d",gNextTimerEvent);
+
+			// Now all the timer updates are done we can increment the system
+			// counter for any work done within the Update() function, gSystemCycleCounter
+			// cannot be updated until this point otherwise it screws up the counters.
+			gSystemCycleCount+=mikie_work_done;
+		}
+
+		//
+		// Schedule (or reschedule) an event for the given absolute cycle
+		//
+		inline void	ScheduleEvent(ULONG event,UCYCLE cycle)
+		{
+			mEventTime[event]=cycle;
+			if(mEventSlot[event]==EVENT_IDLE)
+			{
+				mEventHeap[mEventCount]=event;
+				mEventSlot[event]=mEventCount++;
+			}
+			EventSiftUp(mEventSlot[event]);
+			EventSiftDown(mEventSlot[event]);
+			gNextTimerEvent=mEventTime[mEventHeap[0]];
+		}
+
+		inline void	ForceEvent(ULONG event) {ScheduleEvent(event,gSystemCycleCount);};
+
+		inline void	CancelEvent(ULONG event)
+		{
+			ULONG slot=mEventSlot[event];
+			if(slot==EVENT_IDLE) return;
+			mEventSlot[event]=EVENT_IDLE;
+			if(slot!=--mEventCount)
+			{
+				ULONG moved=mEventHeap[mEventCount];
+				mEventHeap[slot]=moved;
+				mEventSlot[moved]=slot;
+				EventSiftUp(slot);
+				EventSiftDown(mEventSlot[moved]);
+			}
+			gNextTimerEvent=(mEventCount)?mEventTime[mEventHeap[0]]:HANDY_CYCLE_NEVER;
+		}
+
+		//
+		// Pass any step in the mixed outputs to the synthesiser, MSTEREO has
+		// an enable per channel for each ear, left in the top nibble.
+		//
+		inline void	UpdateSound(UCYCLE cycle)
+		{
+			SLONG left=0,right=0;
+
+			if(mSTEREO&0x10) left+=mAUDIO_0_OUTPUT;
+			if(mSTEREO&0x20) left+=mAUDIO_1_OUTPUT;
+			if(mSTEREO&0x40) left+=mAUDIO_2_OUTPUT;
+			if(mSTEREO&0x80) left+=mAUDIO_3_OUTPUT;
+			if(mSTEREO&0x01) right+=mAUDIO_0_OUTPUT;
+			if(mSTEREO&0x02) right+=mAUDIO_1_OUTPUT;
+			if(mSTEREO&0x04) right+=mAUDIO_2_OUTPUT;
+			if(mSTEREO&0x08) right+=mAUDIO_3_OUTPUT;
+
+			if(left!=mAudioLeft || right!=mAudioRight)
+			{
+				mBlip.AddDelta(cycle,left-mAudioLeft,right-mAudioRight);
+				mAudioLeft=left;
+				mAudioRight=right;
+			}
+		}
+
+		//
+		// Timers whose borrows nobody sees are not serviced to time, bring
+		// them all up to date (and so reschedule them) before they are
+		// read or any timer or audio register is written.
+		//
+		inline void	SyncTimers(void)
+		{
+			UpdateTimer1();
+			if(mTIM_3_LINKING!=7) UpdateTimer3(0);
+			if(mTIM_5_LINKING!=7) UpdateTimer5(0);
+			if(mTIM_7_LINKING!=7) UpdateTimer7(0);
+			UpdateTimer6();
+			UpdateTimer4();
+		}
+
+	private:
+		void	ResetEvents(void);
+		bool	ChainEvent(ULONG head,UCYCLE &cycle);
+
+		//
+		// One screen DMA line renderer is instantiated for each rotation and
+		// pixel format, the current one being picked by DisplaySelectLine()
+		// whenever either changes. DisplayFetchLine() undoes any flip so the
+		// renderers always see the line in display order.
+		//
+		typedef void (CMikie::*TDisplayLine)(const UBYTE *source,const ULONG *palette);
+
+		template<ULONG Rotate,ULONG Format> void DisplayLine(const UBYTE *source,const ULONG *palette);
+		void	DisplaySelectLine(void);
+		const UBYTE* DisplayFetchLine(UBYTE *buffer);
+		void	DisplayFlushFrame(void);
+		void	DisplayFlushRotate(void);
+		ULONG	DisplayPixelSize(void);
+		UBYTE*	DisplayFrameStart(UBYTE *bits);
+		ULONG	DisplayLineChanged(ULONG line,const UBYTE *source);
+		void	DisplaySkipLine(void);
+
+		//
+		// The host colour of each pen is kept in mDisplayPalette, refreshed
+		// by the palette register pokes and on any change of pixel format.
+		//
+		ULONG	DisplayColour(ULONG index);
+		void	DisplayUpdatePen(ULONG pen);
+		void	DisplayUpdatePalette(void);
+
+		//
+		// The event queue is a binary heap of event numbers ordered on their
+		// due cycle, ties going to the lowest event number.
+		//
+		inline bool	EventBefore(ULONG first,ULONG second)
+		{
+			if(mEventTime[first]!=mEventTime[second]) return mEventTime[first]<mEventTime[second];
+			return first<second;
+		}
+
+		inline void	EventSiftUp(ULONG slot)
+		{
+			ULONG event=mEventHeap[slot];
+			while(slot)
+			{
+				ULONG parent=(slot-1)>>1;
+				if(!EventBefore(event,mEventHeap[parent])) break;
+				mEventHeap[slot]=mEventHeap[parent];
+				mEventSlot[mEventHeap[slot]]=slot;
+				slot=parent;
+			}
+			mEventHeap[slot]=event;
+			mEventSlot[event]=slot;
+		}
+
+		inline void	EventSiftDown(ULONG slot)
+		{
+			ULONG event=mEventHeap[slot];
+			for(;;)
+			{
+				ULONG child=(slot<<1)+1;
+				if(child>=mEventCount) break;
+				if(child+1<mEventCount && EventBefore(mEventHeap[child+1],mEventHeap[child])) child++;
+				if(!EventBefore(mEventHeap[child],event)) break;
+				mEventHeap[slot]=mEventHeap[child];
+				mEventSlot[mEventHeap[slot]]=slot;
+				slot=child;
+			}
+			mEventHeap[slot]=event;
+			mEventSlot[event]=slot;
+		}
+
+		inline ULONG	PopEvent(void)
+		{
+			ULONG event=mEventHeap[0];
+			mEventSlot[event]=EVENT_IDLE;
+			if(--mEventCount)
+			{
+				mEventHeap[0]=mEventHeap[mEventCount];
+				EventSiftDown(0);
+			}
+			return event;
+		}
+
+		//
+		// Timer updates, each free running timer services itself and then
+		// clocks whatever is linked to it.
+		//
+
+		//
+		// Timer 0 of Group A
+		//
+		inline ULONG	UpdateTimer0(void)
+		{
+			SLONG divide;
+			SLONG decval;
+			UCYCLE tmp;
+			ULONG mikie_work_done=0;
 
 			//
 			// Optimisation, assume T0 (Line timer) is never in one-shot,
@@ -372,26 +648,30 @@ class CMikie : public CLynxBase
 
 //				if(mTIM_0_LINKING!=7)
 				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_0_CURRENT&0x80000000)?1:((mTIM_0_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-//						TRACE_MIKIE1("Update() - TIMER 0 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					// Schedule the exact cycle this timer next borrows out, if CURRENT
+					// is still negative after a long gap we just want another update ASAP
+					tmp=(mTIM_0_CURRENT&0x80000000)?gSystemCycleCount+1:mTIM_0_LAST_COUNT+((mTIM_0_CURRENT+1)<<divide);
+					ScheduleEvent(EVENT_TIMER0,tmp);
+					TRACE_MIKIE1("Update() - TIMER 0 event scheduled for %012d",tmp);
 				}
 //				TRACE_MIKIE1("Update() - mTIM_0_CURRENT = %012d",mTIM_0_CURRENT);
 //				TRACE_MIKIE1("Update() - mTIM_0_BKUP    = %012d",mTIM_0_BKUP);
 //				TRACE_MIKIE1("Update() - mTIM_0_LASTCNT = %012d",mTIM_0_LAST_COUNT);
 //				TRACE_MIKIE1("Update() - mTIM_0_LINKING = %012d",mTIM_0_LINKING);
+
+				// Timer 2 is always clocked by the line timer
+				mikie_work_done+=UpdateTimer2();
 			}
-	
-			//
-			// Timer 2 of Group A
-			//
+			return mikie_work_done;
+		}
+
+		//
+		// Timer 2 of Group A
+		//
+		inline ULONG	UpdateTimer2(void)
+		{
+			SLONG decval;
+			ULONG mikie_work_done=0;
 
 			//
 			// Optimisation, assume T2 (Frame timer) is never in one-shot
@@ -469,15 +749,22 @@ class CMikie : public CLynxBase
 //				TRACE_MIKIE1("Update() - mTIM_2_LASTCNT = %012d",mTIM_2_LAST_COUNT);
 //				TRACE_MIKIE1("Update() - mTIM_2_LINKING = %012d",mTIM_2_LINKING);
 			}
-		
-			//
-			// Timer 4 of Group A
-			//
-			// For the sake of speed it is assumed that Timer 4 (UART timer)
-			// never uses one-shot mode, never uses linking, hence the code
-			// is commented out. Timer 4 is at the end of a chain and seems
-			// no reason to update its carry in-out variables
-			//
+			return mikie_work_done;
+		}
+
+		//
+		// Timer 4 of Group A
+		//
+		// For the sake of speed it is assumed that Timer 4 (UART timer)
+		// never uses one-shot mode, never uses linking, hence the code
+		// is commented out. Timer 4 is at the end of a chain and seems
+		// no reason to update its carry in-out variables
+		//
+		inline void	UpdateTimer4(void)
+		{
+			SLONG divide;
+			SLONG decval;
+			UCYCLE tmp;
 
 			// KW bugfix 13/4/99 added (mTIM_x_ENABLE_RELOAD ||  ..) 
 //			if(mTIM_4_ENABLE_COUNT && (mTIM_4_ENABLE_RELOAD || !mTIM_4_TIMER_DONE))
@@ -503,8 +790,7 @@ class CMikie : public CLynxBase
 				if(decval)
 				{
 					mTIM_4_LAST_COUNT+=decval<<divide;
-					mTIM_4_CURRENT-=decval;
-					if(mTIM_4_CURRENT&0x80000000)
+					if((ULONG)decval>mTIM_4_CURRENT)
 					{
 						// Set carry out
 						mTIM_4_BORROW_OUT=TRUE;
@@ -598,15 +884,11 @@ class CMikie : public CLynxBase
 						// Reload if neccessary
 //						if(mTIM_4_ENABLE_RELOAD)
 //						{
-							mTIM_4_CURRENT+=mTIM_4_BKUP+1;
-							// The low reload values on TIM4 coupled with a longer
-							// timer service delay can sometimes cause
-							// an underun, check and fix
-							if(mTIM_4_CURRENT&0x80000000)
-							{
-								mTIM_4_CURRENT=mTIM_4_BKUP;
-								mTIM_4_LAST_COUNT=gSystemCycleCount;
-							}
+							// While the UART is idle nobody services us so we
+							// may have wrapped several times, work out where we
+							// are in one go
+							decval-=mTIM_4_CURRENT+1;
+							mTIM_4_CURRENT=mTIM_4_BKUP-decval%(mTIM_4_BKUP+1);
 //						}
 //						else
 //						{
@@ -614,10 +896,11 @@ class CMikie : public CLynxBase
 //						}
 //						mTIM_4_TIMER_DONE=TRUE;
 					}
-//					else
-//					{
+					else
+					{
+						mTIM_4_CURRENT-=decval;
 //						mTIM_4_BORROW_OUT=FALSE;
-//					}
+					}
 //					// Set carry in as we did a count
 //					mTIM_4_BORROW_IN=TRUE;
 				}
@@ -633,47 +916,35 @@ class CMikie : public CLynxBase
 //
 //				if(mTIM_4_LINKING!=7)
 //				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_4_CURRENT&0x80000000)?1:((mTIM_4_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-						TRACE_MIKIE1("Update() - TIMER 4 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					// Only run to time while a byte is being shifted in or out,
+					// an idle UART timer is caught up when it is next accessed
+					// and just looks in now and again so its tick count fits a long
+					if(!(mUART_RX_COUNTDOWN&UART_RX_INACTIVE) || !(mUART_TX_COUNTDOWN&UART_TX_INACTIVE))
+						tmp=mTIM_4_LAST_COUNT+((mTIM_4_CURRENT+1)<<divide);
+					else
+						tmp=mTIM_4_LAST_COUNT+EVENT_MAX_WAIT;
+					ScheduleEvent(EVENT_TIMER4,tmp);
+					TRACE_MIKIE1("Update() - TIMER 4 event scheduled for %012d",tmp);
 //				}
 //				TRACE_MIKIE1("Update() - mTIM_4_CURRENT = %012d",mTIM_4_CURRENT);
 //				TRACE_MIKIE1("Update() - mTIM_4_BKUP    = %012d",mTIM_4_BKUP);
 //				TRACE_MIKIE1("Update() - mTIM_4_LASTCNT = %012d",mTIM_4_LAST_COUNT);
 //				TRACE_MIKIE1("Update() - mTIM_4_LINKING = %012d",mTIM_4_LINKING);
 			}
+		}
 
-			// Emulate the UART bug where UART IRQ is level sensitive
-			// in that it will continue to generate interrupts as long
-			// as they are enabled and the interrupt condition is true
+		//
+		// Timer 1 of Group B
+		//
+		// Timer 1 heads the chain, the Audio 3 -> Timer 1 link is not emulated
+		//
+		inline void	UpdateTimer1(void)
+		{
+			SLONG divide;
+			SLONG decval=0;
+			ULONG borrows=0;
+			UCYCLE tmp;
 
-			// If Tx is inactive i.e ready for a byte to eat and the
-			// IRQ is enabled then generate it always
-			if((mUART_TX_COUNTDOWN&UART_TX_INACTIVE) && mUART_TX_IRQ_ENABLE)
-			{
-				TRACE_MIKIE0("Update() - UART TX IRQ Triggered");
-				mTimerStatusFlags|=0x10;
-				gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
-			}
-			// Is data waiting and the interrupt enabled, if so then
-			// what are we waiting for....
-			if(mUART_RX_READY && mUART_RX_IRQ_ENABLE)
-			{
-				TRACE_MIKIE0("Update() - UART RX IRQ Triggered");
-				mTimerStatusFlags|=0x10;
-				gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
-			}
-		
-			//
-			// Timer 1 of Group B
-			//
 			// KW bugfix 13/4/99 added (mTIM_x_ENABLE_RELOAD ||  ..) 
 			if(mTIM_1_ENABLE_COUNT && (mTIM_1_ENABLE_RELOAD || !mTIM_1_TIMER_DONE))
 			{
@@ -683,84 +954,92 @@ class CMikie : public CLynxBase
 					// 16MHz clock downto 1us == cyclecount >> 4 
 					divide=(4+mTIM_1_LINKING);
 					decval=(gSystemCycleCount-mTIM_1_LAST_COUNT)>>divide;
-		
-					if(decval)
+					mTIM_1_LAST_COUNT+=decval<<divide;
+				}
+
+				if(decval)
+				{
+					if((ULONG)decval>mTIM_1_CURRENT)
 					{
-						mTIM_1_LAST_COUNT+=decval<<divide;
-						mTIM_1_CURRENT-=decval;
-						if(mTIM_1_CURRENT&0x80000000)
+						// Set carry out
+						mTIM_1_BORROW_OUT=TRUE;
+
+						// Set the timer status flag
+						if(mTimerInterruptMask&0x02)
 						{
-							// Set carry out
-							mTIM_1_BORROW_OUT=TRUE;
-		
-							// Set the timer status flag
-							if(mTimerInterruptMask&0x02)
-							{
-								TRACE_MIKIE0("Update() - TIMER1 IRQ Triggered");
-								mTimerStatusFlags|=0x02;
-								gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
-							}
-		
-							// Reload if neccessary
-							if(mTIM_1_ENABLE_RELOAD)
-							{
-								mTIM_1_CURRENT+=mTIM_1_BKUP+1;
-							}
-							else
-							{
-								mTIM_1_CURRENT=0;
-							}
-							mTIM_1_TIMER_DONE=TRUE;
+							TRACE_MIKIE0("Update() - TIMER1 IRQ Triggered");
+							mTimerStatusFlags|=0x02;
+							gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
+						}
+
+						// Reload if neccessary, we are only serviced when someone
+						// is looking so may have borrowed many times since last time
+						decval-=mTIM_1_CURRENT+1;
+						if(mTIM_1_ENABLE_RELOAD)
+						{
+							borrows=1+decval/(mTIM_1_BKUP+1);
+							mTIM_1_CURRENT=mTIM_1_BKUP-decval%(mTIM_1_BKUP+1);
 						}
 						else
 						{
-							mTIM_1_BORROW_OUT=FALSE;
+							borrows=1;
+							mTIM_1_CURRENT=0;
 						}
-						// Set carry in as we did a count
-						mTIM_1_BORROW_IN=TRUE;
+						mTIM_1_TIMER_DONE=TRUE;
 					}
 					else
 					{
-						// Clear carry in as we didn't count
-						mTIM_1_BORROW_IN=FALSE;
-						// Clear carry out
+						mTIM_1_CURRENT-=decval;
 						mTIM_1_BORROW_OUT=FALSE;
 					}
+					// Set carry in as we did a count
+					mTIM_1_BORROW_IN=TRUE;
+				}
+				else
+				{
+					// Clear carry in as we didn't count
+					mTIM_1_BORROW_IN=FALSE;
+					// Clear carry out
+					mTIM_1_BORROW_OUT=FALSE;
 				}
 
-				// Prediction for next timer event cycle number
+				// Clock the timer linked to us with all of our borrows
+				if(mTIM_3_LINKING==7) UpdateTimer3(borrows);
+			}
 
-				if(mTIM_1_LINKING!=7)
+			// Schedule the next borrow that anyone can see, see ChainEvent()
+			if(mTIM_1_LINKING!=7)
+			{
+				if(ChainEvent(0,tmp))
 				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_1_CURRENT&0x80000000)?1:((mTIM_1_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-						TRACE_MIKIE1("Update() - TIMER 1 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					ScheduleEvent(EVENT_TIMER1,tmp);
+					TRACE_MIKIE1("Update() - TIMER 1 event scheduled for %012d",tmp);
+				}
+				else
+				{
+					CancelEvent(EVENT_TIMER1);
 				}
-//				TRACE_MIKIE1("Update() - mTIM_1_CURRENT = %012d",mTIM_1_CURRENT);
-//				TRACE_MIKIE1("Update() - mTIM_1_BKUP    = %012d",mTIM_1_BKUP);
-//				TRACE_MIKIE1("Update() - mTIM_1_LASTCNT = %012d",mTIM_1_LAST_COUNT);
-//				TRACE_MIKIE1("Update() - mTIM_1_LINKING = %012d",mTIM_1_LINKING);
 			}
-		
-			//
-			// Timer 3 of Group A
-			//
+		}
+
+		//
+		// Timer 3 of Group B
+		//
+		inline void	UpdateTimer3(ULONG linkval)
+		{
+			SLONG divide;
+			SLONG decval=0;
+			ULONG borrows=0;
+			UCYCLE tmp;
+
 			// KW bugfix 13/4/99 added (mTIM_x_ENABLE_RELOAD ||  ..) 
 			if(mTIM_3_ENABLE_COUNT && (mTIM_3_ENABLE_RELOAD || !mTIM_3_TIMER_DONE))
 			{
-				decval=0;
-		
 				if(mTIM_3_LINKING==0x07)
 				{
-					if(mTIM_1_BORROW_OUT) decval=1;
-					mTIM_3_LAST_LINK_CARRY=mTIM_1_BORROW_OUT;
+					// Counted by every borrow out of Timer 1
+					decval=linkval;
+					mTIM_3_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
 				}
 				else
 				{
@@ -768,17 +1047,16 @@ class CMikie : public CLynxBase
 					// 16MHz clock downto 1us == cyclecount >> 4 
 					divide=(4+mTIM_3_LINKING);
 					decval=(gSystemCycleCount-mTIM_3_LAST_COUNT)>>divide;
+					mTIM_3_LAST_COUNT+=decval<<divide;
 				}
-		
+
 				if(decval)
 				{
-					mTIM_3_LAST_COUNT+=decval<<divide;
-					mTIM_3_CURRENT-=decval;
-					if(mTIM_3_CURRENT&0x80000000)
+					if((ULONG)decval>mTIM_3_CURRENT)
 					{
 						// Set carry out
 						mTIM_3_BORROW_OUT=TRUE;
-		
+
 						// Set the timer status flag
 						if(mTimerInterruptMask&0x08)
 						{
@@ -786,20 +1064,25 @@ class CMikie : public CLynxBase
 							mTimerStatusFlags|=0x08;
 							gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
 						}
-		
-						// Reload if neccessary
+
+						// Reload if neccessary, we are only serviced when someone
+						// is looking so may have borrowed many times since last time
+						decval-=mTIM_3_CURRENT+1;
 						if(mTIM_3_ENABLE_RELOAD)
 						{
-							mTIM_3_CURRENT+=mTIM_3_BKUP+1;
+							borrows=1+decval/(mTIM_3_BKUP+1);
+							mTIM_3_CURRENT=mTIM_3_BKUP-decval%(mTIM_3_BKUP+1);
 						}
 						else
 						{
+							borrows=1;
 							mTIM_3_CURRENT=0;
 						}
 						mTIM_3_TIMER_DONE=TRUE;
 					}
 					else
 					{
+						mTIM_3_CURRENT-=decval;
 						mTIM_3_BORROW_OUT=FALSE;
 					}
 					// Set carry in as we did a count
@@ -813,39 +1096,43 @@ class CMikie : public CLynxBase
 					mTIM_3_BORROW_OUT=FALSE;
 				}
 
-				// Prediction for next timer event cycle number
+				// Clock the timer linked to us with all of our borrows
+				if(mTIM_5_LINKING==7) UpdateTimer5(borrows);
+			}
 
-				if(mTIM_3_LINKING!=7)
+			// Schedule the next borrow that anyone can see, see ChainEvent()
+			if(mTIM_3_LINKING!=7)
+			{
+				if(ChainEvent(1,tmp))
 				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_3_CURRENT&0x80000000)?1:((mTIM_3_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-						TRACE_MIKIE1("Update() - TIMER 3 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					ScheduleEvent(EVENT_TIMER3,tmp);
+					TRACE_MIKIE1("Update() - TIMER 3 event scheduled for %012d",tmp);
+				}
+				else
+				{
+					CancelEvent(EVENT_TIMER3);
 				}
-//				TRACE_MIKIE1("Update() - mTIM_3_CURRENT = %012d",mTIM_3_CURRENT);
-//				TRACE_MIKIE1("Update() - mTIM_3_BKUP    = %012d",mTIM_3_BKUP);
-//				TRACE_MIKIE1("Update() - mTIM_3_LASTCNT = %012d",mTIM_3_LAST_COUNT);
-//				TRACE_MIKIE1("Update() - mTIM_3_LINKING = %012d",mTIM_3_LINKING);
 			}
-		
-			//
-			// Timer 5 of Group A
-			//
+		}
+
+		//
+		// Timer 5 of Group B
+		//
+		inline void	UpdateTimer5(ULONG linkval)
+		{
+			SLONG divide;
+			SLONG decval=0;
+			ULONG borrows=0;
+			UCYCLE tmp;
+
 			// KW bugfix 13/4/99 added (mTIM_x_ENABLE_RELOAD ||  ..) 
 			if(mTIM_5_ENABLE_COUNT && (mTIM_5_ENABLE_RELOAD || !mTIM_5_TIMER_DONE))
 			{
-				decval=0;
-		
 				if(mTIM_5_LINKING==0x07)
 				{
-					if(mTIM_3_BORROW_OUT) decval=1;
-					mTIM_5_LAST_LINK_CARRY=mTIM_3_BORROW_OUT;
+					// Counted by every borrow out of Timer 3
+					decval=linkval;
+					mTIM_5_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
 				}
 				else
 				{
@@ -853,17 +1140,16 @@ class CMikie : public CLynxBase
 					// 16MHz clock downto 1us == cyclecount >> 4 
 					divide=(4+mTIM_5_LINKING);
 					decval=(gSystemCycleCount-mTIM_5_LAST_COUNT)>>divide;
+					mTIM_5_LAST_COUNT+=decval<<divide;
 				}
-		
+
 				if(decval)
 				{
-					mTIM_5_LAST_COUNT+=decval<<divide;
-					mTIM_5_CURRENT-=decval;
-					if(mTIM_5_CURRENT&0x80000000)
+					if((ULONG)decval>mTIM_5_CURRENT)
 					{
 						// Set carry out
 						mTIM_5_BORROW_OUT=TRUE;
-		
+
 						// Set the timer status flag
 						if(mTimerInterruptMask&0x20)
 						{
@@ -871,20 +1157,25 @@ class CMikie : public CLynxBase
 							mTimerStatusFlags|=0x20;
 							gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
 						}
-		
-						// Reload if neccessary
+
+						// Reload if neccessary, we are only serviced when someone
+						// is looking so may have borrowed many times since last time
+						decval-=mTIM_5_CURRENT+1;
 						if(mTIM_5_ENABLE_RELOAD)
 						{
-							mTIM_5_CURRENT+=mTIM_5_BKUP+1;
+							borrows=1+decval/(mTIM_5_BKUP+1);
+							mTIM_5_CURRENT=mTIM_5_BKUP-decval%(mTIM_5_BKUP+1);
 						}
 						else
 						{
+							borrows=1;
 							mTIM_5_CURRENT=0;
 						}
 						mTIM_5_TIMER_DONE=TRUE;
 					}
 					else
 					{
+						mTIM_5_CURRENT-=decval;
 						mTIM_5_BORROW_OUT=FALSE;
 					}
 					// Set carry in as we did a count
@@ -898,39 +1189,43 @@ class CMikie : public CLynxBase
 					mTIM_5_BORROW_OUT=FALSE;
 				}
 
-				// Prediction for next timer event cycle number
+				// Clock the timer linked to us with all of our borrows
+				if(mTIM_7_LINKING==7) UpdateTimer7(borrows);
+			}
 
-				if(mTIM_5_LINKING!=7)
+			// Schedule the next borrow that anyone can see, see ChainEvent()
+			if(mTIM_5_LINKING!=7)
+			{
+				if(ChainEvent(2,tmp))
 				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_5_CURRENT&0x80000000)?1:((mTIM_5_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-						TRACE_MIKIE1("Update() - TIMER 5 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					ScheduleEvent(EVENT_TIMER5,tmp);
+					TRACE_MIKIE1("Update() - TIMER 5 event scheduled for %012d",tmp);
+				}
+				else
+				{
+					CancelEvent(EVENT_TIMER5);
 				}
-//				TRACE_MIKIE1("Update() - mTIM_5_CURRENT = %012d",mTIM_5_CURRENT);
-//				TRACE_MIKIE1("Update() - mTIM_5_BKUP    = %012d",mTIM_5_BKUP);
-//				TRACE_MIKIE1("Update() - mTIM_5_LASTCNT = %012d",mTIM_5_LAST_COUNT);
-//				TRACE_MIKIE1("Update() - mTIM_5_LINKING = %012d",mTIM_5_LINKING);
 			}
-		
-			//
-			// Timer 7 of Group A
-			//
+		}
+
+		//
+		// Timer 7 of Group B
+		//
+		inline void	UpdateTimer7(ULONG linkval)
+		{
+			SLONG divide;
+			SLONG decval=0;
+			ULONG borrows=0;
+			UCYCLE tmp;
+
 			// KW bugfix 13/4/99 added (mTIM_x_ENABLE_RELOAD ||  ..) 
 			if(mTIM_7_ENABLE_COUNT && (mTIM_7_ENABLE_RELOAD || !mTIM_7_TIMER_DONE))
 			{
-				decval=0;
-		
 				if(mTIM_7_LINKING==0x07)
 				{
-					if(mTIM_5_BORROW_OUT) decval=1;
-					mTIM_7_LAST_LINK_CARRY=mTIM_5_BORROW_OUT;
+					// Counted by every borrow out of Timer 5
+					decval=linkval;
+					mTIM_7_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
 				}
 				else
 				{
@@ -938,17 +1233,16 @@ class CMikie : public CLynxBase
 					// 16MHz clock downto 1us == cyclecount >> 4 
 					divide=(4+mTIM_7_LINKING);
 					decval=(gSystemCycleCount-mTIM_7_LAST_COUNT)>>divide;
+					mTIM_7_LAST_COUNT+=decval<<divide;
 				}
-		
+
 				if(decval)
 				{
-					mTIM_7_LAST_COUNT+=decval<<divide;
-					mTIM_7_CURRENT-=decval;
-					if(mTIM_7_CURRENT&0x80000000)
+					if((ULONG)decval>mTIM_7_CURRENT)
 					{
 						// Set carry out
 						mTIM_7_BORROW_OUT=TRUE;
-		
+
 						// Set the timer status flag
 						if(mTimerInterruptMask&0x80)
 						{
@@ -956,21 +1250,25 @@ class CMikie : public CLynxBase
 							mTimerStatusFlags|=0x80;
 							gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
 						}
-		
-						// Reload if neccessary
+
+						// Reload if neccessary, we are only serviced when someone
+						// is looking so may have borrowed many times since last time
+						decval-=mTIM_7_CURRENT+1;
 						if(mTIM_7_ENABLE_RELOAD)
 						{
-							mTIM_7_CURRENT+=mTIM_7_BKUP+1;
+							borrows=1+decval/(mTIM_7_BKUP+1);
+							mTIM_7_CURRENT=mTIM_7_BKUP-decval%(mTIM_7_BKUP+1);
 						}
 						else
 						{
+							borrows=1;
 							mTIM_7_CURRENT=0;
 						}
 						mTIM_7_TIMER_DONE=TRUE;
-		
 					}
 					else
 					{
+						mTIM_7_CURRENT-=decval;
 						mTIM_7_BORROW_OUT=FALSE;
 					}
 					// Set carry in as we did a count
@@ -984,30 +1282,34 @@ class CMikie : public CLynxBase
 					mTIM_7_BORROW_OUT=FALSE;
 				}
 
-				// Prediction for next timer event cycle number
+				// Clock the timer linked to us with all of our borrows
+				if(gAudioEnabled && mAUDIO_0_LINKING==7) UpdateAudio0(borrows);
+			}
 
-				if(mTIM_7_LINKING!=7)
+			// Schedule the next borrow that anyone can see, see ChainEvent()
+			if(mTIM_7_LINKING!=7)
+			{
+				if(ChainEvent(3,tmp))
 				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_7_CURRENT&0x80000000)?1:((mTIM_7_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-						TRACE_MIKIE1("Update() - TIMER 7 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					ScheduleEvent(EVENT_TIMER7,tmp);
+					TRACE_MIKIE1("Update() - TIMER 7 event scheduled for %012d",tmp);
+				}
+				else
+				{
+					CancelEvent(EVENT_TIMER7);
 				}
-//				TRACE_MIKIE1("Update() - mTIM_7_CURRENT = %012d",mTIM_7_CURRENT);
-//				TRACE_MIKIE1("Update() - mTIM_7_BKUP    = %012d",mTIM_7_BKUP);
-//				TRACE_MIKIE1("Update() - mTIM_7_LASTCNT = %012d",mTIM_7_LAST_COUNT);
-//				TRACE_MIKIE1("Update() - mTIM_7_LINKING = %012d",mTIM_7_LINKING);
 			}
-		
-			//
-			// Timer 6 has no group
-			//
+		}
+
+		//
+		// Timer 6 has no group
+		//
+		inline void	UpdateTimer6(void)
+		{
+			SLONG divide;
+			SLONG decval=0;
+			UCYCLE tmp;
+
 			// KW bugfix 13/4/99 added (mTIM_x_ENABLE_RELOAD ||  ..) 
 			if(mTIM_6_ENABLE_COUNT && (mTIM_6_ENABLE_RELOAD || !mTIM_6_TIMER_DONE))
 			{
@@ -1017,523 +1319,481 @@ class CMikie : public CLynxBase
 					// 16MHz clock downto 1us == cyclecount >> 4 
 					divide=(4+mTIM_6_LINKING);
 					decval=(gSystemCycleCount-mTIM_6_LAST_COUNT)>>divide;
-		
-					if(decval)
+					mTIM_6_LAST_COUNT+=decval<<divide;
+				}
+
+				if(decval)
+				{
+					if((ULONG)decval>mTIM_6_CURRENT)
 					{
-						mTIM_6_LAST_COUNT+=decval<<divide;
-						mTIM_6_CURRENT-=decval;
-						if(mTIM_6_CURRENT&0x80000000)
+						// Set carry out
+						mTIM_6_BORROW_OUT=TRUE;
+
+						// Set the timer status flag
+						if(mTimerInterruptMask&0x40)
 						{
-							// Set carry out
-							mTIM_6_BORROW_OUT=TRUE;
-		
-							// Set the timer status flag
-							if(mTimerInterruptMask&0x40)
-							{
-								TRACE_MIKIE0("Update() - TIMER6 IRQ Triggered");
-								mTimerStatusFlags|=0x40;
-								gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
-							}
-		
-							// Reload if neccessary
-							if(mTIM_6_ENABLE_RELOAD)
-							{
-								mTIM_6_CURRENT+=mTIM_6_BKUP+1;
-							}
-							else
-							{
-								mTIM_6_CURRENT=0;
-							}
-							mTIM_6_TIMER_DONE=TRUE;
+							TRACE_MIKIE0("Update() - TIMER6 IRQ Triggered");
+							mTimerStatusFlags|=0x40;
+							gSystemIRQ=TRUE;	// Added 19/09/06 fix for IRQ issue
+						}
+
+						// Reload if neccessary, we are only serviced when someone
+						// is looking so may have borrowed many times since last time
+						decval-=mTIM_6_CURRENT+1;
+						if(mTIM_6_ENABLE_RELOAD)
+						{
+							mTIM_6_CURRENT=mTIM_6_BKUP-decval%(mTIM_6_BKUP+1);
 						}
 						else
 						{
-							mTIM_6_BORROW_OUT=FALSE;
+							mTIM_6_CURRENT=0;
 						}
-						// Set carry in as we did a count
-						mTIM_6_BORROW_IN=TRUE;
+						mTIM_6_TIMER_DONE=TRUE;
 					}
 					else
 					{
-						// Clear carry in as we didn't count
-						mTIM_6_BORROW_IN=FALSE;
-						// Clear carry out
+						mTIM_6_CURRENT-=decval;
 						mTIM_6_BORROW_OUT=FALSE;
 					}
+					// Set carry in as we did a count
+					mTIM_6_BORROW_IN=TRUE;
 				}
-
-				// Prediction for next timer event cycle number
-				// (Timer 6 doesn't support linking)
-
-//				if(mTIM_6_LINKING!=7)
+				else
 				{
-					// Sometimes timeupdates can be >2x rollover in which case
-					// then CURRENT may still be negative and we can use it to
-					// calc the next timer value, we just want another update ASAP
-					tmp=(mTIM_6_CURRENT&0x80000000)?1:((mTIM_6_CURRENT+1)<<divide);
-					tmp+=gSystemCycleCount;
-					if(tmp<gNextTimerEvent)
-					{
-						gNextTimerEvent=tmp;
-						TRACE_MIKIE1("Update() - TIMER 6 Set NextTimerEvent = %012d",gNextTimerEvent);
-					}
+					// Clear carry in as we didn't count
+					mTIM_6_BORROW_IN=FALSE;
+					// Clear carry out
+					mTIM_6_BORROW_OUT=FALSE;
 				}
-//				TRACE_MIKIE1("Update() - mTIM_6_CURRENT = %012d",mTIM_6_CURRENT);
-//				TRACE_MIKIE1("Update() - mTIM_6_BKUP    = %012d",mTIM_6_BKUP);
-//				TRACE_MIKIE1("Update() - mTIM_6_LASTCNT = %012d",mTIM_6_LAST_COUNT);
-//				TRACE_MIKIE1("Update() - mTIM_6_LINKING = %012d",mTIM_6_LINKING);
 			}
 
-			//
-			// If sound is enabled then update the sound subsystem
-			//
-			if(gAudioEnabled)
+			// Timer 6 only has to run to time if it interrupts, otherwise
+			// it is caught up when it is next accessed and we just look in
+			// now and again so that its tick count still fits a long
+			if(mTIM_6_ENABLE_COUNT && (mTIM_6_ENABLE_RELOAD || !mTIM_6_TIMER_DONE))
 			{
-				static SLONG sample=0;
-				ULONG mix=0;
-				
-				//
-				// Catch audio buffer up to current time
-				//
-				
-				// Mix the sample
-				sample=0;
-				if(mSTEREO&0x11) { sample+=mAUDIO_0_OUTPUT; mix++; }
-				if(mSTEREO&0x22) { sample+=mAUDIO_1_OUTPUT; mix++; }
-				if(mSTEREO&0x44) { sample+=mAUDIO_2_OUTPUT; mix++; }
-				if(mSTEREO&0x88) { sample+=mAUDIO_3_OUTPUT; mix++; }
-				if(mix)
-				{
-					sample+=128*mix; // Correct for sign
-					sample/=mix;	// Keep the audio volume at max
-				}
+				if(mTimerInterruptMask&0x40)
+					tmp=mTIM_6_LAST_COUNT+((mTIM_6_CURRENT+1)<<(4+mTIM_6_LINKING));
 				else
-				{
-					sample=128;
-				}
+					tmp=mTIM_6_LAST_COUNT+EVENT_MAX_WAIT;
+				ScheduleEvent(EVENT_TIMER6,tmp);
+				TRACE_MIKIE1("Update() - TIMER 6 event scheduled for %012d",tmp);
+			}
+			else
+			{
+				CancelEvent(EVENT_TIMER6);
+			}
+		}
 
-//				sample+=(mSTEREO&0x11)?mAUDIO_0_OUTPUT:0;
-//				sample+=(mSTEREO&0x22)?mAUDIO_1_OUTPUT:0;
-//				sample+=(mSTEREO&0x44)?mAUDIO_2_OUTPUT:0;
-//				sample+=(mSTEREO&0x88)?mAUDIO_3_OUTPUT:0;
-//				sample=sample>>2;
-//				sample+=128;
+		//
+		// Audio 0 
+		//
+		inline void	UpdateAudio0(ULONG linkval)
+		{
+			SLONG divide=0;
+			SLONG decval;
+			UCYCLE tmp;
 
-				for(;gAudioLastUpdateCycle+HANDY_AUDIO_SAMPLE_PERIOD<gSystemCycleCount;gAudioLastUpdateCycle+=HANDY_AUDIO_SAMPLE_PERIOD)
+//			if(mAUDIO_0_ENABLE_COUNT && !mAUDIO_0_TIMER_DONE && mAUDIO_0_VOLUME && mAUDIO_0_BKUP)
+			if(mAUDIO_0_ENABLE_COUNT && (mAUDIO_0_ENABLE_RELOAD || !mAUDIO_0_TIMER_DONE) && mAUDIO_0_VOLUME && mAUDIO_0_BKUP)
+			{
+				decval=0;
+	
+				if(mAUDIO_0_LINKING==0x07)
 				{
-					// Output audio sample
-					gAudioBuffer[gAudioBufferPointer++]=(UBYTE)sample;
-
-					// Check buffer overflow condition, stick at the endpoint
-					// teh audio output system will reset the input pointer
-					// when it reads out the data.
-
-					// We should NEVER overflow, this buffer holds 0.25 seconds
-					// of data if this happens the the multimedia system above
-					// has failed so the corruption of the buffer contents wont matter
-
-					gAudioBufferPointer%=HANDY_AUDIO_BUFFER_SIZE;
+					// Counted by every borrow out of Timer 7
+					decval=linkval;
+					mAUDIO_0_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
 				}
-
-				//
-				// Audio 0 
-				//
-//				if(mAUDIO_0_ENABLE_COUNT && !mAUDIO_0_TIMER_DONE && mAUDIO_0_VOLUME && mAUDIO_0_BKUP)
-				if(mAUDIO_0_ENABLE_COUNT && (mAUDIO_0_ENABLE_RELOAD || !mAUDIO_0_TIMER_DONE) && mAUDIO_0_VOLUME && mAUDIO_0_BKUP)
+				else
 				{
-					decval=0;
-		
-					if(mAUDIO_0_LINKING==0x07)
-					{
-						if(mTIM_7_BORROW_OUT) decval=1;
-						mAUDIO_0_LAST_LINK_CARRY=mTIM_7_BORROW_OUT;
-					}
-					else
-					{
-						// Ordinary clocked mode as opposed to linked mode
-						// 16MHz clock downto 1us == cyclecount >> 4 
-						divide=(4+mAUDIO_0_LINKING);
-						decval=(gSystemCycleCount-mAUDIO_0_LAST_COUNT)>>divide;
-					}
-		
-					if(decval)
+					// Ordinary clocked mode as opposed to linked mode
+					// 16MHz clock downto 1us == cyclecount >> 4 
+					divide=(4+mAUDIO_0_LINKING);
+					decval=(gSystemCycleCount-mAUDIO_0_LAST_COUNT)>>divide;
+				}
+	
+				if(decval)
+				{
+					mAUDIO_0_LAST_COUNT+=decval<<divide;
+					mAUDIO_0_CURRENT-=decval;
+					if(mAUDIO_0_CURRENT&0x80000000)
 					{
-						mAUDIO_0_LAST_COUNT+=decval<<divide;
-						mAUDIO_0_CURRENT-=decval;
-						if(mAUDIO_0_CURRENT&0x80000000)
+						// Set carry out
+						mAUDIO_0_BORROW_OUT=TRUE;
+	
+						// Reload if neccessary
+						if(mAUDIO_0_ENABLE_RELOAD)
 						{
-							// Set carry out
-							mAUDIO_0_BORROW_OUT=TRUE;
-		
-							// Reload if neccessary
-							if(mAUDIO_0_ENABLE_RELOAD)
-							{
-								mAUDIO_0_CURRENT+=mAUDIO_0_BKUP+1;
-								if(mAUDIO_0_CURRENT&0x80000000) mAUDIO_0_CURRENT=0;
-							}
-							else
-							{
-								// Set timer done
-								mAUDIO_0_TIMER_DONE=TRUE;
-								mAUDIO_0_CURRENT=0;
-							}
+							mAUDIO_0_CURRENT+=mAUDIO_0_BKUP+1;
+							if(mAUDIO_0_CURRENT&0x80000000) mAUDIO_0_CURRENT=0;
+						}
+						else
+						{
+							// Set timer done
+							mAUDIO_0_TIMER_DONE=TRUE;
+							mAUDIO_0_CURRENT=0;
+						}
 
-							//
-							// Update audio circuitry
-							//
-							mAUDIO_0_WAVESHAPER=GetLfsrNext(mAUDIO_0_WAVESHAPER);
+						//
+						// Update audio circuitry
+						//
+						mAUDIO_0_WAVESHAPER=GetLfsrNext(mAUDIO_0_WAVESHAPER);
 
-							if(mAUDIO_0_INTEGRATE_ENABLE)
-							{
-								SLONG temp=mAUDIO_0_OUTPUT;
-								if(mAUDIO_0_WAVESHAPER&0x0001) temp+=mAUDIO_0_VOLUME; else temp-=mAUDIO_0_VOLUME;
-								if(temp>127) temp=127;
-								if(temp<-128) temp=-128;
-								mAUDIO_0_OUTPUT=(SBYTE)temp;
-							}
-							else
-							{
-								if(mAUDIO_0_WAVESHAPER&0x0001) mAUDIO_0_OUTPUT=mAUDIO_0_VOLUME; else mAUDIO_0_OUTPUT=-mAUDIO_0_VOLUME;
-							}
+						if(mAUDIO_0_INTEGRATE_ENABLE)
+						{
+							SLONG temp=mAUDIO_0_OUTPUT;
+							if(mAUDIO_0_WAVESHAPER&0x0001) temp+=mAUDIO_0_VOLUME; else temp-=mAUDIO_0_VOLUME;
+							if(temp>127) temp=127;
+							if(temp<-128) temp=-128;
+							mAUDIO_0_OUTPUT=(SBYTE)temp;
 						}
 						else
 						{
-							mAUDIO_0_BORROW_OUT=FALSE;
+							if(mAUDIO_0_WAVESHAPER&0x0001) mAUDIO_0_OUTPUT=mAUDIO_0_VOLUME; else mAUDIO_0_OUTPUT=-mAUDIO_0_VOLUME;
 						}
-						// Set carry in as we did a count
-						mAUDIO_0_BORROW_IN=TRUE;
 					}
 					else
 					{
-						// Clear carry in as we didn't count
-						mAUDIO_0_BORROW_IN=FALSE;
-						// Clear carry out
 						mAUDIO_0_BORROW_OUT=FALSE;
 					}
+					// Set carry in as we did a count
+					mAUDIO_0_BORROW_IN=TRUE;
+				}
+				else
+				{
+					// Clear carry in as we didn't count
+					mAUDIO_0_BORROW_IN=FALSE;
+					// Clear carry out
+					mAUDIO_0_BORROW_OUT=FALSE;
+				}
 
-					// Prediction for next timer event cycle number
+				// Prediction for next timer event cycle number
 
-					if(mAUDIO_0_LINKING!=7)
-					{
-						// Sometimes timeupdates can be >2x rollover in which case
-						// then CURRENT may still be negative and we can use it to
-						// calc the next timer value, we just want another update ASAP
-						tmp=(mAUDIO_0_CURRENT&0x80000000)?1:((mAUDIO_0_CURRENT+1)<<divide);
-						tmp+=gSystemCycleCount;
-						if(tmp<gNextTimerEvent)
-						{
-							gNextTimerEvent=tmp;
-							TRACE_MIKIE1("Update() - AUDIO 0 Set NextTimerEvent = %012d",gNextTimerEvent);
-						}
-					}
-//					TRACE_MIKIE1("Update() - mAUDIO_0_CURRENT = %012d",mAUDIO_0_CURRENT);
-//					TRACE_MIKIE1("Update() - mAUDIO_0_BKUP    = %012d",mAUDIO_0_BKUP);
-//					TRACE_MIKIE1("Update() - mAUDIO_0_LASTCNT = %012d",mAUDIO_0_LAST_COUNT);
-//					TRACE_MIKIE1("Update() - mAUDIO_0_LINKING = %012d",mAUDIO_0_LINKING);
+				if(mAUDIO_0_LINKING!=7)
+				{
+					// Schedule the exact cycle this timer next borrows out, if CURRENT
+					// is still negative after a long gap we just want another update ASAP
+					tmp=(mAUDIO_0_CURRENT&0x80000000)?gSystemCycleCount+1:mAUDIO_0_LAST_COUNT+((mAUDIO_0_CURRENT+1)<<divide);
+					ScheduleEvent(EVENT_AUDIO0,tmp);
+					TRACE_MIKIE1("Update() - AUDIO 0 event scheduled for %012d",tmp);
 				}
+//				TRACE_MIKIE1("Update() - mAUDIO_0_CURRENT = %012d",mAUDIO_0_CURRENT);
+//				TRACE_MIKIE1("Update() - mAUDIO_0_BKUP    = %012d",mAUDIO_0_BKUP);
+//				TRACE_MIKIE1("Update() - mAUDIO_0_LASTCNT = %012d",mAUDIO_0_LAST_COUNT);
+//				TRACE_MIKIE1("Update() - mAUDIO_0_LINKING = %012d",mAUDIO_0_LINKING);
+
+				// Clock the timer linked to us with our borrow out
+				if(mAUDIO_1_LINKING==7) UpdateAudio1(mAUDIO_0_BORROW_OUT);
+			}
+		}
 
-				//
-				// Audio 1 
-				//
-//				if(mAUDIO_1_ENABLE_COUNT && !mAUDIO_1_TIMER_DONE && mAUDIO_1_VOLUME && mAUDIO_1_BKUP)
-				if(mAUDIO_1_ENABLE_COUNT && (mAUDIO_1_ENABLE_RELOAD || !mAUDIO_1_TIMER_DONE) && mAUDIO_1_VOLUME && mAUDIO_1_BKUP)
+		//
+		// Audio 1 
+		//
+		inline void	UpdateAudio1(ULONG linkval)
+		{
+			SLONG divide=0;
+			SLONG decval;
+			UCYCLE tmp;
+
+//			if(mAUDIO_1_ENABLE_COUNT && !mAUDIO_1_TIMER_DONE && mAUDIO_1_VOLUME && mAUDIO_1_BKUP)
+			if(mAUDIO_1_ENABLE_COUNT && (mAUDIO_1_ENABLE_RELOAD || !mAUDIO_1_TIMER_DONE) && mAUDIO_1_VOLUME && mAUDIO_1_BKUP)
+			{
+				decval=0;
+	
+				if(mAUDIO_1_LINKING==0x07)
 				{
-					decval=0;
-		
-					if(mAUDIO_1_LINKING==0x07)
-					{
-						if(mAUDIO_0_BORROW_OUT) decval=1;
-						mAUDIO_1_LAST_LINK_CARRY=mAUDIO_0_BORROW_OUT;
-					}
-					else
-					{
-						// Ordinary clocked mode as opposed to linked mode
-						// 16MHz clock downto 1us == cyclecount >> 4 
-						divide=(4+mAUDIO_1_LINKING);
-						decval=(gSystemCycleCount-mAUDIO_1_LAST_COUNT)>>divide;
-					}
-		
-					if(decval)
+					// Counted by every borrow out of Audio 0
+					decval=linkval;
+					mAUDIO_1_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
+				}
+				else
+				{
+					// Ordinary clocked mode as opposed to linked mode
+					// 16MHz clock downto 1us == cyclecount >> 4 
+					divide=(4+mAUDIO_1_LINKING);
+					decval=(gSystemCycleCount-mAUDIO_1_LAST_COUNT)>>divide;
+				}
+	
+				if(decval)
+				{
+					mAUDIO_1_LAST_COUNT+=decval<<divide;
+					mAUDIO_1_CURRENT-=decval;
+					if(mAUDIO_1_CURRENT&0x80000000)
 					{
-						mAUDIO_1_LAST_COUNT+=decval<<divide;
-						mAUDIO_1_CURRENT-=decval;
-						if(mAUDIO_1_CURRENT&0x80000000)
+						// Set carry out
+						mAUDIO_1_BORROW_OUT=TRUE;
+	
+						// Reload if neccessary
+						if(mAUDIO_1_ENABLE_RELOAD)
 						{
-							// Set carry out
-							mAUDIO_1_BORROW_OUT=TRUE;
-		
-							// Reload if neccessary
-							if(mAUDIO_1_ENABLE_RELOAD)
-							{
-								mAUDIO_1_CURRENT+=mAUDIO_1_BKUP+1;
-								if(mAUDIO_1_CURRENT&0x80000000) mAUDIO_1_CURRENT=0;
-							}
-							else
-							{
-								// Set timer done
-								mAUDIO_1_TIMER_DONE=TRUE;
-								mAUDIO_1_CURRENT=0;
-							}
+							mAUDIO_1_CURRENT+=mAUDIO_1_BKUP+1;
+							if(mAUDIO_1_CURRENT&0x80000000) mAUDIO_1_CURRENT=0;
+						}
+						else
+						{
+							// Set timer done
+							mAUDIO_1_TIMER_DONE=TRUE;
+							mAUDIO_1_CURRENT=0;
+						}
 
-							//
-							// Update audio circuitry
-							//
-							mAUDIO_1_WAVESHAPER=GetLfsrNext(mAUDIO_1_WAVESHAPER);
+						//
+						// Update audio circuitry
+						//
+						mAUDIO_1_WAVESHAPER=GetLfsrNext(mAUDIO_1_WAVESHAPER);
 
-							if(mAUDIO_1_INTEGRATE_ENABLE)
-							{
-								SLONG temp=mAUDIO_1_OUTPUT;
-								if(mAUDIO_1_WAVESHAPER&0x0001) temp+=mAUDIO_1_VOLUME; else temp-=mAUDIO_1_VOLUME;
-								if(temp>127) temp=127;
-								if(temp<-128) temp=-128;
-								mAUDIO_1_OUTPUT=(SBYTE)temp;
-							}
-							else
-							{
-								if(mAUDIO_1_WAVESHAPER&0x0001) mAUDIO_1_OUTPUT=mAUDIO_1_VOLUME; else mAUDIO_1_OUTPUT=-mAUDIO_1_VOLUME;
-							}
+						if(mAUDIO_1_INTEGRATE_ENABLE)
+						{
+							SLONG temp=mAUDIO_1_OUTPUT;
+							if(mAUDIO_1_WAVESHAPER&0x0001) temp+=mAUDIO_1_VOLUME; else temp-=mAUDIO_1_VOLUME;
+							if(temp>127) temp=127;
+							if(temp<-128) temp=-128;
+							mAUDIO_1_OUTPUT=(SBYTE)temp;
 						}
 						else
 						{
-							mAUDIO_1_BORROW_OUT=FALSE;
+							if(mAUDIO_1_WAVESHAPER&0x0001) mAUDIO_1_OUTPUT=mAUDIO_1_VOLUME; else mAUDIO_1_OUTPUT=-mAUDIO_1_VOLUME;
 						}
-						// Set carry in as we did a count
-						mAUDIO_1_BORROW_IN=TRUE;
 					}
 					else
 					{
-						// Clear carry in as we didn't count
-						mAUDIO_1_BORROW_IN=FALSE;
-						// Clear carry out
 						mAUDIO_1_BORROW_OUT=FALSE;
 					}
+					// Set carry in as we did a count
+					mAUDIO_1_BORROW_IN=TRUE;
+				}
+				else
+				{
+					// Clear carry in as we didn't count
+					mAUDIO_1_BORROW_IN=FALSE;
+					// Clear carry out
+					mAUDIO_1_BORROW_OUT=FALSE;
+				}
 
-					// Prediction for next timer event cycle number
+				// Prediction for next timer event cycle number
 
-					if(mAUDIO_1_LINKING!=7)
-					{
-						// Sometimes timeupdates can be >2x rollover in which case
-						// then CURRENT may still be negative and we can use it to
-						// calc the next timer value, we just want another update ASAP
-						tmp=(mAUDIO_1_CURRENT&0x80000000)?1:((mAUDIO_1_CURRENT+1)<<divide);
-						tmp+=gSystemCycleCount;
-						if(tmp<gNextTimerEvent)
-						{
-							gNextTimerEvent=tmp;
-							TRACE_MIKIE1("Update() - AUDIO 1 Set NextTimerEvent = %012d",gNextTimerEvent);
-						}
-					}
-//					TRACE_MIKIE1("Update() - mAUDIO_1_CURRENT = %012d",mAUDIO_1_CURRENT);
-//					TRACE_MIKIE1("Update() - mAUDIO_1_BKUP    = %012d",mAUDIO_1_BKUP);
-//					TRACE_MIKIE1("Update() - mAUDIO_1_LASTCNT = %012d",mAUDIO_1_LAST_COUNT);
-//					TRACE_MIKIE1("Update() - mAUDIO_1_LINKING = %012d",mAUDIO_1_LINKING);
+				if(mAUDIO_1_LINKING!=7)
+				{
+					// Schedule the exact cycle this timer next borrows out, if CURRENT
+					// is still negative after a long gap we just want another update ASAP
+					tmp=(mAUDIO_1_CURRENT&0x80000000)?gSystemCycleCount+1:mAUDIO_1_LAST_COUNT+((mAUDIO_1_CURRENT+1)<<divide);
+					ScheduleEvent(EVENT_AUDIO1,tmp);
+					TRACE_MIKIE1("Update() - AUDIO 1 event scheduled for %012d",tmp);
 				}
+//				TRACE_MIKIE1("Update() - mAUDIO_1_CURRENT = %012d",mAUDIO_1_CURRENT);
+//				TRACE_MIKIE1("Update() - mAUDIO_1_BKUP    = %012d",mAUDIO_1_BKUP);
+//				TRACE_MIKIE1("Update() - mAUDIO_1_LASTCNT = %012d",mAUDIO_1_LAST_COUNT);
+//				TRACE_MIKIE1("Update() - mAUDIO_1_LINKING = %012d",mAUDIO_1_LINKING);
+
+				// Clock the timer linked to us with our borrow out
+				if(mAUDIO_2_LINKING==7) UpdateAudio2(mAUDIO_1_BORROW_OUT);
+			}
+		}
+
+		//
+		// Audio 2 
+		//
+		inline void	UpdateAudio2(ULONG linkval)
+		{
+			SLONG divide=0;
+			SLONG decval;
+			UCYCLE tmp;
 
-				//
-				// Audio 2 
-				//
-//				if(mAUDIO_2_ENABLE_COUNT && !mAUDIO_2_TIMER_DONE && mAUDIO_2_VOLUME && mAUDIO_2_BKUP)
-				if(mAUDIO_2_ENABLE_COUNT && (mAUDIO_2_ENABLE_RELOAD || !mAUDIO_2_TIMER_DONE) && mAUDIO_2_VOLUME && mAUDIO_2_BKUP)
+//			if(mAUDIO_2_ENABLE_COUNT && !mAUDIO_2_TIMER_DONE && mAUDIO_2_VOLUME && mAUDIO_2_BKUP)
+			if(mAUDIO_2_ENABLE_COUNT && (mAUDIO_2_ENABLE_RELOAD || !mAUDIO_2_TIMER_DONE) && mAUDIO_2_VOLUME && mAUDIO_2_BKUP)
+			{
+				decval=0;
+	
+				if(mAUDIO_2_LINKING==0x07)
 				{
-					decval=0;
-		
-					if(mAUDIO_2_LINKING==0x07)
-					{
-						if(mAUDIO_1_BORROW_OUT) decval=1;
-						mAUDIO_2_LAST_LINK_CARRY=mAUDIO_1_BORROW_OUT;
-					}
-					else
-					{
-						// Ordinary clocked mode as opposed to linked mode
-						// 16MHz clock downto 1us == cyclecount >> 4 
-						divide=(4+mAUDIO_2_LINKING);
-						decval=(gSystemCycleCount-mAUDIO_2_LAST_COUNT)>>divide;
-					}
-		
-					if(decval)
+					// Counted by every borrow out of Audio 1
+					decval=linkval;
+					mAUDIO_2_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
+				}
+				else
+				{
+					// Ordinary clocked mode as opposed to linked mode
+					// 16MHz clock downto 1us == cyclecount >> 4 
+					divide=(4+mAUDIO_2_LINKING);
+					decval=(gSystemCycleCount-mAUDIO_2_LAST_COUNT)>>divide;
+				}
+	
+				if(decval)
+				{
+					mAUDIO_2_LAST_COUNT+=decval<<divide;
+					mAUDIO_2_CURRENT-=decval;
+					if(mAUDIO_2_CURRENT&0x80000000)
 					{
-						mAUDIO_2_LAST_COUNT+=decval<<divide;
-						mAUDIO_2_CURRENT-=decval;
-						if(mAUDIO_2_CURRENT&0x80000000)
+						// Set carry out
+						mAUDIO_2_BORROW_OUT=TRUE;
+	
+						// Reload if neccessary
+						if(mAUDIO_2_ENABLE_RELOAD)
 						{
-							// Set carry out
-							mAUDIO_2_BORROW_OUT=TRUE;
-		
-							// Reload if neccessary
-							if(mAUDIO_2_ENABLE_RELOAD)
-							{
-								mAUDIO_2_CURRENT+=mAUDIO_2_BKUP+1;
-								if(mAUDIO_2_CURRENT&0x80000000) mAUDIO_2_CURRENT=0;
-							}
-							else
-							{
-								// Set timer done
-								mAUDIO_2_TIMER_DONE=TRUE;
-								mAUDIO_2_CURRENT=0;
-							}
+							mAUDIO_2_CURRENT+=mAUDIO_2_BKUP+1;
+							if(mAUDIO_2_CURRENT&0x80000000) mAUDIO_2_CURRENT=0;
+						}
+						else
+						{
+							// Set timer done
+							mAUDIO_2_TIMER_DONE=TRUE;
+							mAUDIO_2_CURRENT=0;
+						}
 
-							//
-							// Update audio circuitry
-							//
-							mAUDIO_2_WAVESHAPER=GetLfsrNext(mAUDIO_2_WAVESHAPER);
+						//
+						// Update audio circuitry
+						//
+						mAUDIO_2_WAVESHAPER=GetLfsrNext(mAUDIO_2_WAVESHAPER);
 
-							if(mAUDIO_2_INTEGRATE_ENABLE)
-							{
-								SLONG temp=mAUDIO_2_OUTPUT;
-								if(mAUDIO_2_WAVESHAPER&0x0001) temp+=mAUDIO_2_VOLUME; else temp-=mAUDIO_2_VOLUME;
-								if(temp>127) temp=127;
-								if(temp<-128) temp=-128;
-								mAUDIO_2_OUTPUT=(SBYTE)temp;
-							}
-							else
-							{
-								if(mAUDIO_2_WAVESHAPER&0x0001) mAUDIO_2_OUTPUT=mAUDIO_2_VOLUME; else mAUDIO_2_OUTPUT=-mAUDIO_2_VOLUME;
-							}
+						if(mAUDIO_2_INTEGRATE_ENABLE)
+						{
+							SLONG temp=mAUDIO_2_OUTPUT;
+							if(mAUDIO_2_WAVESHAPER&0x0001) temp+=mAUDIO_2_VOLUME; else temp-=mAUDIO_2_VOLUME;
+							if(temp>127) temp=127;
+							if(temp<-128) temp=-128;
+							mAUDIO_2_OUTPUT=(SBYTE)temp;
 						}
 						else
 						{
-							mAUDIO_2_BORROW_OUT=FALSE;
+							if(mAUDIO_2_WAVESHAPER&0x0001) mAUDIO_2_OUTPUT=mAUDIO_2_VOLUME; else mAUDIO_2_OUTPUT=-mAUDIO_2_VOLUME;
 						}
-						// Set carry in as we did a count
-						mAUDIO_2_BORROW_IN=TRUE;
 					}
 					else
 					{
-						// Clear carry in as we didn't count
-						mAUDIO_2_BORROW_IN=FALSE;
-						// Clear carry out
 						mAUDIO_2_BORROW_OUT=FALSE;
 					}
+					// Set carry in as we did a count
+					mAUDIO_2_BORROW_IN=TRUE;
+				}
+				else
+				{
+					// Clear carry in as we didn't count
+					mAUDIO_2_BORROW_IN=FALSE;
+					// Clear carry out
+					mAUDIO_2_BORROW_OUT=FALSE;
+				}
 
-					// Prediction for next timer event cycle number
+				// Prediction for next timer event cycle number
 
-					if(mAUDIO_2_LINKING!=7)
-					{
-						// Sometimes timeupdates can be >2x rollover in which case
-						// then CURRENT may still be negative and we can use it to
-						// calc the next timer value, we just want another update ASAP
-						tmp=(mAUDIO_2_CURRENT&0x80000000)?1:((mAUDIO_2_CURRENT+1)<<divide);
-						tmp+=gSystemCycleCount;
-						if(tmp<gNextTimerEvent)
-						{
-							gNextTimerEvent=tmp;
-							TRACE_MIKIE1("Update() - AUDIO 2 Set NextTimerEvent = %012d",gNextTimerEvent);
-						}
-					}
-//					TRACE_MIKIE1("Update() - mAUDIO_2_CURRENT = %012d",mAUDIO_2_CURRENT);
-//					TRACE_MIKIE1("Update() - mAUDIO_2_BKUP    = %012d",mAUDIO_2_BKUP);
-//					TRACE_MIKIE1("Update() - mAUDIO_2_LASTCNT = %012d",mAUDIO_2_LAST_COUNT);
-//					TRACE_MIKIE1("Update() - mAUDIO_2_LINKING = %012d",mAUDIO_2_LINKING);
+				if(mAUDIO_2_LINKING!=7)
+				{
+					// Schedule the exact cycle this timer next borrows out, if CURRENT
+					// is still negative after a long gap we just want another update ASAP
+					tmp=(mAUDIO_2_CURRENT&0x80000000)?gSystemCycleCount+1:mAUDIO_2_LAST_COUNT+((mAUDIO_2_CURRENT+1)<<divide);
+					ScheduleEvent(EVENT_AUDIO2,tmp);
+					TRACE_MIKIE1("Update() - AUDIO 2 event scheduled for %012d",tmp);
 				}
+//				TRACE_MIKIE1("Update() - mAUDIO_2_CURRENT = %012d",mAUDIO_2_CURRENT);
+//				TRACE_MIKIE1("Update() - mAUDIO_2_BKUP    = %012d",mAUDIO_2_BKUP);
+//				TRACE_MIKIE1("Update() - mAUDIO_2_LASTCNT = %012d",mAUDIO_2_LAST_COUNT);
+//				TRACE_MIKIE1("Update() - mAUDIO_2_LINKING = %012d",mAUDIO_2_LINKING);
 
-				//
-				// Audio 3
-				//
-//				if(mAUDIO_3_ENABLE_COUNT && !mAUDIO_3_TIMER_DONE && mAUDIO_3_VOLUME && mAUDIO_3_BKUP)
-				if(mAUDIO_3_ENABLE_COUNT && (mAUDIO_3_ENABLE_RELOAD || !mAUDIO_3_TIMER_DONE) && mAUDIO_3_VOLUME && mAUDIO_3_BKUP)
+				// Clock the timer linked to us with our borrow out
+				if(mAUDIO_3_LINKING==7) UpdateAudio3(mAUDIO_2_BORROW_OUT);
+			}
+		}
+
+		//
+		// Audio 3
+		//
+		inline void	UpdateAudio3(ULONG linkval)
+		{
+			SLONG divide=0;
+			SLONG decval;
+			UCYCLE tmp;
+
+//			if(mAUDIO_3_ENABLE_COUNT && !mAUDIO_3_TIMER_DONE && mAUDIO_3_VOLUME && mAUDIO_3_BKUP)
+			if(mAUDIO_3_ENABLE_COUNT && (mAUDIO_3_ENABLE_RELOAD || !mAUDIO_3_TIMER_DONE) && mAUDIO_3_VOLUME && mAUDIO_3_BKUP)
+			{
+				decval=0;
+	
+				if(mAUDIO_3_LINKING==0x07)
 				{
-					decval=0;
-		
-					if(mAUDIO_3_LINKING==0x07)
-					{
-						if(mAUDIO_2_BORROW_OUT) decval=1;
-						mAUDIO_3_LAST_LINK_CARRY=mAUDIO_2_BORROW_OUT;
-					}
-					else
-					{
-						// Ordinary clocked mode as opposed to linked mode
-						// 16MHz clock downto 1us == cyclecount >> 4 
-						divide=(4+mAUDIO_3_LINKING);
-						decval=(gSystemCycleCount-mAUDIO_3_LAST_COUNT)>>divide;
-					}
-		
-					if(decval)
+					// Counted by every borrow out of Audio 2
+					decval=linkval;
+					mAUDIO_3_LAST_LINK_CARRY=(linkval)?TRUE:FALSE;
+				}
+				else
+				{
+					// Ordinary clocked mode as opposed to linked mode
+					// 16MHz clock downto 1us == cyclecount >> 4 
+					divide=(4+mAUDIO_3_LINKING);
+					decval=(gSystemCycleCount-mAUDIO_3_LAST_COUNT)>>divide;
+				}
+	
+				if(decval)
+				{
+					mAUDIO_3_LAST_COUNT+=decval<<divide;
+					mAUDIO_3_CURRENT-=decval;
+					if(mAUDIO_3_CURRENT&0x80000000)
 					{
-						mAUDIO_3_LAST_COUNT+=decval<<divide;
-						mAUDIO_3_CURRENT-=decval;
-						if(mAUDIO_3_CURRENT&0x80000000)
+						// Set carry out
+						mAUDIO_3_BORROW_OUT=TRUE;
+	
+						// Reload if neccessary
+						if(mAUDIO_3_ENABLE_RELOAD)
 						{
-							// Set carry out
-							mAUDIO_3_BORROW_OUT=TRUE;
-		
-							// Reload if neccessary
-							if(mAUDIO_3_ENABLE_RELOAD)
-							{
-								mAUDIO_3_CURRENT+=mAUDIO_3_BKUP+1;
-								if(mAUDIO_3_CURRENT&0x80000000) mAUDIO_3_CURRENT=0;
-							}
-							else
-							{
-								// Set timer done
-								mAUDIO_3_TIMER_DONE=TRUE;
-								mAUDIO_3_CURRENT=0;
-							}
+							mAUDIO_3_CURRENT+=mAUDIO_3_BKUP+1;
+							if(mAUDIO_3_CURRENT&0x80000000) mAUDIO_3_CURRENT=0;
+						}
+						else
+						{
+							// Set timer done
+							mAUDIO_3_TIMER_DONE=TRUE;
+							mAUDIO_3_CURRENT=0;
+						}
 
-							//
-							// Update audio circuitry
-							//
-							mAUDIO_3_WAVESHAPER=GetLfsrNext(mAUDIO_3_WAVESHAPER);
+						//
+						// Update audio circuitry
+						//
+						mAUDIO_3_WAVESHAPER=GetLfsrNext(mAUDIO_3_WAVESHAPER);
 
-							if(mAUDIO_3_INTEGRATE_ENABLE)
-							{
-								SLONG temp=mAUDIO_3_OUTPUT;
-								if(mAUDIO_3_WAVESHAPER&0x0001) temp+=mAUDIO_3_VOLUME; else temp-=mAUDIO_3_VOLUME;
-								if(temp>127) temp=127;
-								if(temp<-128) temp=-128;
-								mAUDIO_3_OUTPUT=(SBYTE)temp;
-							}
-							else
-							{
-								if(mAUDIO_3_WAVESHAPER&0x0001) mAUDIO_3_OUTPUT=mAUDIO_3_VOLUME; else mAUDIO_3_OUTPUT=-mAUDIO_3_VOLUME;
-							}
+						if(mAUDIO_3_INTEGRATE_ENABLE)
+						{
+							SLONG temp=mAUDIO_3_OUTPUT;
+							if(mAUDIO_3_WAVESHAPER&0x0001) temp+=mAUDIO_3_VOLUME; else temp-=mAUDIO_3_VOLUME;
+							if(temp>127) temp=127;
+							if(temp<-128) temp=-128;
+							mAUDIO_3_OUTPUT=(SBYTE)temp;
 						}
 						else
 						{
-							mAUDIO_3_BORROW_OUT=FALSE;
+							if(mAUDIO_3_WAVESHAPER&0x0001) mAUDIO_3_OUTPUT=mAUDIO_3_VOLUME; else mAUDIO_3_OUTPUT=-mAUDIO_3_VOLUME;
 						}
-						// Set carry in as we did a count
-						mAUDIO_3_BORROW_IN=TRUE;
 					}
 					else
 					{
-						// Clear carry in as we didn't count
-						mAUDIO_3_BORROW_IN=FALSE;
-						// Clear carry out
 						mAUDIO_3_BORROW_OUT=FALSE;
 					}
+					// Set carry in as we did a count
+					mAUDIO_3_BORROW_IN=TRUE;
+				}
+				else
+				{
+					// Clear carry in as we didn't count
+					mAUDIO_3_BORROW_IN=FALSE;
+					// Clear carry out
+					mAUDIO_3_BORROW_OUT=FALSE;
+				}
 
-					// Prediction for next timer event cycle number
+				// Prediction for next timer event cycle number
 
-					if(mAUDIO_3_LINKING!=7)
-					{
-						// Sometimes timeupdates can be >2x rollover in which case
-						// then CURRENT may still be negative and we can use it to
-						// calc the next timer value, we just want another update ASAP
-						tmp=(mAUDIO_3_CURRENT&0x80000000)?1:((mAUDIO_3_CURRENT+1)<<divide);
-						tmp+=gSystemCycleCount;
-						if(tmp<gNextTimerEvent)
-						{
-							gNextTimerEvent=tmp;
-							TRACE_MIKIE1("Update() - AUDIO 3 Set NextTimerEvent = %012d",gNextTimerEvent);
-						}
-					}
-//					TRACE_MIKIE1("Update() - mAUDIO_3_CURRENT = %012d",mAUDIO_3_CURRENT);
-//					TRACE_MIKIE1("Update() - mAUDIO_3_BKUP    = %012d",mAUDIO_3_BKUP);
-//					TRACE_MIKIE1("Update() - mAUDIO_3_LASTCNT = %012d",mAUDIO_3_LAST_COUNT);
-//					TRACE_MIKIE1("Update() - mAUDIO_3_LINKING = %012d",mAUDIO_3_LINKING);
+				if(mAUDIO_3_LINKING!=7)
+				{
+					// Schedule the exact cycle this timer next borrows out, if CURRENT
+					// is still negative after a long gap we just want another update ASAP
+					tmp=(mAUDIO_3_CURRENT&0x80000000)?gSystemCycleCount+1:mAUDIO_3_LAST_COUNT+((mAUDIO_3_CURRENT+1)<<divide);
+					ScheduleEvent(EVENT_AUDIO3,tmp);
+					TRACE_MIKIE1("Update() - AUDIO 3 event scheduled for %012d",tmp);
 				}
+//				TRACE_MIKIE1("Update() - mAUDIO_3_CURRENT = %012d",mAUDIO_3_CURRENT);
+//				TRACE_MIKIE1("Update() - mAUDIO_3_BKUP    = %012d",mAUDIO_3_BKUP);
+//				TRACE_MIKIE1("Update() - mAUDIO_3_LASTCNT = %012d",mAUDIO_3_LAST_COUNT);
+//				TRACE_MIKIE1("Update() - mAUDIO_3_LINKING = %012d",mAUDIO_3_LINKING);
 			}
-
-//			if(gSystemCycleCount==gNextTimerEvent) gError->Warning("CMikie::Update() - gSystemCycleCount==gNextTimerEvent, system lock likely");
-//			TRACE_MIKIE1("Update() - NextTimerEvent = %012d",gNextTimerEvent);
-
-			// Now all the timer updates are done we can increment the system
-			// counter for any work done within the Update() function, gSystemCycleCounter
-			// cannot be updated until this point otherwise it screws up the counters.
-			gSystemCycleCount+=mikie_work_done;
 		}
 
-	private:
 		CSystem		&mSystem;
 
 		// Hardware storage
@@ -1544,7 +1804,9 @@ class CMikie : public CLynxBase
 		ULONG		mTimerInterruptMask;
 
 		TPALETTE	mPalette[16];
-		ULONG		mColourMap[4096];
+		ULONG		mDisplayPalette[16];
+		ULONG		mFrameColours[16];
+		ULONG		mFrameColoursSplit;
 
 		ULONG		mIODAT;
 		ULONG		mIODIR;
@@ -1565,7 +1827,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_0_BORROW_IN;
 		ULONG		mTIM_0_BORROW_OUT;
 		ULONG		mTIM_0_LAST_LINK_CARRY;
-		ULONG		mTIM_0_LAST_COUNT;
+		UCYCLE		mTIM_0_LAST_COUNT;
 
 		ULONG		mTIM_1_BKUP;
 		ULONG		mTIM_1_ENABLE_RELOAD;
@@ -1577,7 +1839,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_1_BORROW_IN;
 		ULONG		mTIM_1_BORROW_OUT;
 		ULONG		mTIM_1_LAST_LINK_CARRY;
-		ULONG		mTIM_1_LAST_COUNT;
+		UCYCLE		mTIM_1_LAST_COUNT;
 
 		ULONG		mTIM_2_BKUP;
 		ULONG		mTIM_2_ENABLE_RELOAD;
@@ -1589,7 +1851,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_2_BORROW_IN;
 		ULONG		mTIM_2_BORROW_OUT;
 		ULONG		mTIM_2_LAST_LINK_CARRY;
-		ULONG		mTIM_2_LAST_COUNT;
+		UCYCLE		mTIM_2_LAST_COUNT;
 
 		ULONG		mTIM_3_BKUP;
 		ULONG		mTIM_3_ENABLE_RELOAD;
@@ -1601,7 +1863,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_3_BORROW_IN;
 		ULONG		mTIM_3_BORROW_OUT;
 		ULONG		mTIM_3_LAST_LINK_CARRY;
-		ULONG		mTIM_3_LAST_COUNT;
+		UCYCLE		mTIM_3_LAST_COUNT;
 
 		ULONG		mTIM_4_BKUP;
 		ULONG		mTIM_4_ENABLE_RELOAD;
@@ -1613,7 +1875,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_4_BORROW_IN;
 		ULONG		mTIM_4_BORROW_OUT;
 		ULONG		mTIM_4_LAST_LINK_CARRY;
-		ULONG		mTIM_4_LAST_COUNT;
+		UCYCLE		mTIM_4_LAST_COUNT;
 
 		ULONG		mTIM_5_BKUP;
 		ULONG		mTIM_5_ENABLE_RELOAD;
@@ -1625,7 +1887,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_5_BORROW_IN;
 		ULONG		mTIM_5_BORROW_OUT;
 		ULONG		mTIM_5_LAST_LINK_CARRY;
-		ULONG		mTIM_5_LAST_COUNT;
+		UCYCLE		mTIM_5_LAST_COUNT;
 
 		ULONG		mTIM_6_BKUP;
 		ULONG		mTIM_6_ENABLE_RELOAD;
@@ -1637,7 +1899,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_6_BORROW_IN;
 		ULONG		mTIM_6_BORROW_OUT;
 		ULONG		mTIM_6_LAST_LINK_CARRY;
-		ULONG		mTIM_6_LAST_COUNT;
+		UCYCLE		mTIM_6_LAST_COUNT;
 
 		ULONG		mTIM_7_BKUP;
 		ULONG		mTIM_7_ENABLE_RELOAD;
@@ -1649,7 +1911,7 @@ class CMikie : public CLynxBase
 		ULONG		mTIM_7_BORROW_IN;
 		ULONG		mTIM_7_BORROW_OUT;
 		ULONG		mTIM_7_LAST_LINK_CARRY;
-		ULONG		mTIM_7_LAST_COUNT;
+		UCYCLE		mTIM_7_LAST_COUNT;
 
 		ULONG		mAUDIO_0_BKUP;
 		ULONG		mAUDIO_0_ENABLE_RELOAD;
@@ -1661,7 +1923,7 @@ class CMikie : public CLynxBase
 		ULONG		mAUDIO_0_BORROW_IN;
 		ULONG		mAUDIO_0_BORROW_OUT;
 		ULONG		mAUDIO_0_LAST_LINK_CARRY;
-		ULONG		mAUDIO_0_LAST_COUNT;
+		UCYCLE		mAUDIO_0_LAST_COUNT;
 		SBYTE		mAUDIO_0_VOLUME;
 		SBYTE		mAUDIO_0_OUTPUT;
 		ULONG		mAUDIO_0_INTEGRATE_ENABLE;
@@ -1677,7 +1939,7 @@ class CMikie : public CLynxBase
 		ULONG		mAUDIO_1_BORROW_IN;
 		ULONG		mAUDIO_1_BORROW_OUT;
 		ULONG		mAUDIO_1_LAST_LINK_CARRY;
-		ULONG		mAUDIO_1_LAST_COUNT;
+		UCYCLE		mAUDIO_1_LAST_COUNT;
 		SBYTE		mAUDIO_1_VOLUME;
 		SBYTE		mAUDIO_1_OUTPUT;
 		ULONG		mAUDIO_1_INTEGRATE_ENABLE;
@@ -1693,7 +1955,7 @@ class CMikie : public CLynxBase
 		ULONG		mAUDIO_2_BORROW_IN;
 		ULONG		mAUDIO_2_BORROW_OUT;
 		ULONG		mAUDIO_2_LAST_LINK_CARRY;
-		ULONG		mAUDIO_2_LAST_COUNT;
+		UCYCLE		mAUDIO_2_LAST_COUNT;
 		SBYTE		mAUDIO_2_VOLUME;
 		SBYTE		mAUDIO_2_OUTPUT;
 		ULONG		mAUDIO_2_INTEGRATE_ENABLE;
@@ -1709,7 +1971,7 @@ class CMikie : public CLynxBase
 		ULONG		mAUDIO_3_BORROW_IN;
 		ULONG		mAUDIO_3_BORROW_OUT;
 		ULONG		mAUDIO_3_LAST_LINK_CARRY;
-		ULONG		mAUDIO_3_LAST_COUNT;
+		UCYCLE		mAUDIO_3_LAST_COUNT;
 		SBYTE		mAUDIO_3_VOLUME;
 		SBYTE		mAUDIO_3_OUTPUT;
 		ULONG		mAUDIO_3_INTEGRATE_ENABLE;
@@ -1759,8 +2021,62 @@ class CMikie : public CLynxBase
 		ULONG		mDisplayRotate;
 		ULONG		mDisplayFormat;
 		ULONG		mDisplayPitch;
+		ULONG		mDisplayScale;
+		TDisplayLine	mpDisplayLine;
 		UBYTE*		(*mpDisplayCallback)(ULONG objref);
 		ULONG		mDisplayCallbackObject;
+
+		//
+		// Deferred display, each line of screen DMA is recorded along with
+		// the pen colours in force and the frame converted in one pass at
+		// the end of the frame
+		//
+		ULONG		mDisplayDeferred;
+		ULONG		mDisplayHeadless;
+		ULONG		mFrameLineCount;
+		UBYTE		mFrameLine[HANDY_SCREEN_HEIGHT][HANDY_SCREEN_WIDTH/2];
+		ULONG		mFrameLinePalette[HANDY_SCREEN_HEIGHT];
+		ULONG		mFramePalette[HANDY_SCREEN_HEIGHT][16];
+		ULONG		mFramePaletteCount;
+		ULONG		mFramePaletteChanged;
+
+		//
+		// Rotated displays gather this many converted lines before writing
+		// them out as columns
+		//
+		UBYTE		mRotateLine[DISPLAY_ROTATE_LINES][HANDY_SCREEN_WIDTH*4*DISPLAY_MAX_SCALE];
+		ULONG		mRotateLineCount;
+
+		// A converted line waiting to be scaled
+		UBYTE		mScaleLine[HANDY_SCREEN_WIDTH*4];
+
+		//
+		// Line tracking, what was last shown on each line so lines that
+		// have not changed since the last frame can be reported and, when
+		// the display hands back the same buffer, left alone
+		//
+		ULONG		mDisplayTrackLines;
+		ULONG		mDisplaySameBuffer;
+		UBYTE		mShownLine[HANDY_SCREEN_HEIGHT][HANDY_SCREEN_WIDTH/2];
+		ULONG		mShownPalette[HANDY_SCREEN_HEIGHT][16];
+		ULONG		mShownValid[HANDY_SCREEN_HEIGHT];
+		UBYTE		mLineDirty[HANDY_SCREEN_HEIGHT];
+
+		//
+		// Timer event queue
+		//
+		UCYCLE		mEventTime[EVENT_COUNT];
+		ULONG		mEventHeap[EVENT_COUNT];
+		ULONG		mEventSlot[EVENT_COUNT];
+		ULONG		mEventCount;
+		ULONG		mAudioEventsEnabled;
+
+		//
+		// Sound output
+		//
+		CBlip		mBlip;
+		SLONG		mAudioLeft;
+		SLONG		mAudioRight;
 };
 
 
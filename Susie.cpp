@@ -60,6 +60,11 @@
 #include "./zlib-113/zlib.h"
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SUSIE_SSE2
+#endif
+
 
 //
 // As the Susie sprite engine only ever sees system RAM
@@ -72,20 +77,75 @@
 
 #define RAM_PEEK(m)				(mRamPointer[(m)])
 #define RAM_PEEKW(m)			(mRamPointer[(m)]+(mRamPointer[(m)+1]<<8))
+#if defined(HANDY_BLOCK_CACHE) && defined(HANDY_SPRITE_THREADS)
+// The bands only note the pages they write, see SpriteListFlush()
+#define RAM_POKE(m1,m2)			{mRamPointer[(m1)]=(m2);if(mBand) mBandCodeWrites[(m1)>>8]=TRUE; else mSystem.mCpu->CodeWrite(m1);}
+#elif defined(HANDY_BLOCK_CACHE)
+#define RAM_POKE(m1,m2)			{mRamPointer[(m1)]=(m2);mSystem.mCpu->CodeWrite(m1);}
+#else
 #define RAM_POKE(m1,m2)			{mRamPointer[(m1)]=(m2);}
-
-ULONG cycles_used=0;
+#endif
 
 CSusie::CSusie(CSystem& parent)
 	:mSystem(parent)
 {
 	TRACE_SUSIE0("CSusie()");
+	mThreads=1;
+	mVQuadOff=0;
+	mHQuadOff=0;
+#ifdef HANDY_SPRITE_THREADS
+#ifdef HANDY_BLOCK_CACHE
+	mBand=FALSE;
+	memset(mBandCodeWrites,0,sizeof(mBandCodeWrites));
+#endif
+	mSpriteListActive=FALSE;
+	mpSpriteListSprite=NULL;
+	mpSpriteListLine=NULL;
+	mpSpriteListSpan=NULL;
+	mpSpriteListPending=NULL;
+	mpSpriteListCollision=NULL;
+	for(int loop=0;loop<SPRITE_MAX_THREADS;loop++) mpBand[loop]=NULL;
+#endif
 	Reset();
 }
 
 CSusie::~CSusie()
 {
 	TRACE_SUSIE0("~CSusie()");
+#ifdef HANDY_SPRITE_THREADS
+	StopThreads();
+#endif
+}
+
+void CSusie::SetThreads(ULONG threads)
+{
+#ifdef HANDY_SPRITE_THREADS
+	StopThreads();
+	if(threads>SPRITE_MAX_THREADS) threads=SPRITE_MAX_THREADS;
+	if(threads<2) return;
+
+	mpSpriteListSprite=new TSPRITELISTSPRITE[SPRITE_LIST_SPRITES];
+	mpSpriteListLine=new TSPRITELISTLINE[SPRITE_LIST_LINES];
+	mpSpriteListSpan=new TSPRITELISTSPAN[SPRITE_LIST_SPANS];
+	mpSpriteListPending=new UBYTE[0x10000/8];
+	mpSpriteListCollision=new UBYTE[SPRITE_MAX_THREADS*SPRITE_LIST_SPRITES];
+	memset(mpSpriteListPending,0,0x10000/8);
+	mSpriteListSprites=0;
+	mSpriteListLines=0;
+	mSpriteListSpans=0;
+	mSpriteListPendings=0;
+
+	// Band 0 is always drawn by the caller, the workers don't look at
+	// their band until the first list is drawn
+	mThreads=mPool.Start(threads,BandEntry,this);
+	for(ULONG loop=0;loop<mThreads;loop++)
+	{
+		mpBand[loop]=new CSusie(mSystem);
+#ifdef HANDY_BLOCK_CACHE
+		mpBand[loop]->mBand=TRUE;
+#endif
+	}
+#endif
 }
 
 void CSusie::Reset(void)
@@ -173,6 +233,11 @@ void CSusie::Reset(void)
 	mEVERON=FALSE;
 
 	for(int loop=0;loop<16;loop++) mPenIndex[loop]=loop;
+	mLineRuns=0;
+	mLineSpan=FALSE;
+	mCyclesUsed=0;
+	memset(mLineSpanPen,0,sizeof(mLineSpanPen));
+	memset(mLineSpanCollision,0,sizeof(mLineSpanCollision));
 
 	mJOYSTICK.Byte=0;
 	mSWITCHES.Byte=0;
@@ -497,9 +562,13 @@ ULONG CSusie::PaintSprites(void)
 		return 0;
 	}
 
-	cycles_used=0;
+	mCyclesUsed=0;
 	everonscreen=0;
 
+#ifdef HANDY_SPRITE_THREADS
+	mSpriteListActive=SpriteListUsable();
+#endif
+
 	do
 	{
 		TRACE_SUSIE1("PaintSprites() ************ Rendering Sprite %03d ************",sprcount);
@@ -520,6 +589,11 @@ ULONG CSusie::PaintSprites(void)
 			mSPRSYS_Status=1;
 		}
 
+#ifdef HANDY_SPRITE_THREADS
+		// The SCB up to the end of the palette
+		if(mSpriteListActive) SpriteListCheck(mSCBNEXT.Word,32);
+#endif
+
 		mTMPADR.Word=mSCBNEXT.Word;	// Copy SCB pointer
 		mSCBADR.Word=mSCBNEXT.Word;	// Copy SCB pointer
 		TRACE_SUSIE1("PaintSprites() SCBADDR $%04x",mSCBADR.Word);
@@ -553,7 +627,7 @@ ULONG CSusie::PaintSprites(void)
 		TRACE_SUSIE1("PaintSprites() SCBNEXT $%04x",mSCBNEXT.Word);
 		mTMPADR.Word+=2;
 
-		cycles_used+=5*SPR_RDWR_CYC;
+		mCyclesUsed+=5*SPR_RDWR_CYC;
 
 		// Initialise the collision depositary
 
@@ -565,6 +639,10 @@ ULONG CSusie::PaintSprites(void)
 //		}
 		mCollision=0;
 
+#ifdef HANDY_SPRITE_THREADS
+		if(mSpriteListActive) SpriteListOpen();
+#endif
+
 		// Check if this is a skip sprite
 
 		if(!mSPRCTL1_SkipSprite)
@@ -582,7 +660,7 @@ ULONG CSusie::PaintSprites(void)
 			TRACE_SUSIE1("PaintSprites() VPOSSTRT $%04x",mVPOSSTRT.Word);
 			mTMPADR.Word+=2;
 
-			cycles_used+=6*SPR_RDWR_CYC;
+			mCyclesUsed+=6*SPR_RDWR_CYC;
 
 			bool enable_sizing=FALSE;
 			bool enable_stretch=FALSE;
@@ -603,7 +681,7 @@ ULONG CSusie::PaintSprites(void)
 					mSPRVSIZ.Word=RAM_PEEKW(mTMPADR.Word);	// Sprite Verticalal size
 					mTMPADR.Word+=2;
 
-					cycles_used+=4*SPR_RDWR_CYC;
+					mCyclesUsed+=4*SPR_RDWR_CYC;
 					break;
 
 				case 2:
@@ -621,7 +699,7 @@ ULONG CSusie::PaintSprites(void)
 					mSTRETCH.Word=RAM_PEEKW(mTMPADR.Word);	// Sprite stretch
 					mTMPADR.Word+=2;
 
-					cycles_used+=6*SPR_RDWR_CYC;
+					mCyclesUsed+=6*SPR_RDWR_CYC;
 					break;
 
 				case 3:
@@ -644,7 +722,7 @@ ULONG CSusie::PaintSprites(void)
 					mTILT.Word=RAM_PEEKW(mTMPADR.Word);		// Sprite tilt
 					mTMPADR.Word+=2;
 
-					cycles_used+=8*SPR_RDWR_CYC;
+					mCyclesUsed+=8*SPR_RDWR_CYC;
 					break;
 
 				default:
@@ -669,9 +747,12 @@ ULONG CSusie::PaintSprites(void)
 					mPenIndex[(loop*2)+1]=data&0x0f;
 				}
 				// Increment cycle count for the reads
-				cycles_used+=8*SPR_RDWR_CYC;
+				mCyclesUsed+=8*SPR_RDWR_CYC;
 			}
 
+			// Pick the line renderers for this sprite
+			const TSpriteLine *spriteline=SpriteSelectLine();
+
 			// Now we can start painting
 		
 			// Quadrant drawing order is: SE,NE,NW,SW
@@ -810,14 +891,9 @@ ULONG CSusie::PaintSprites(void)
 
 				TRACE_SUSIE1("PaintSprites() Render status %d",render);
 
-				static int pixel_height=0;
-				static int pixel_width=0;
-				static int pixel=0;
-				static int hoff=0,voff=0;
-				static int hloop=0,vloop=0;
-				static bool onscreen=0;
-				static int vquadoff=0;
-				static int hquadoff=0;
+				int pixel_height=0;
+				int hoff=0,voff=0;
+				int vloop=0;
 
 				if(render)
 				{
@@ -835,8 +911,8 @@ ULONG CSusie::PaintSprites(void)
 					// get offset by 1 pixel in the other direction, this
 					// fixes the squashed look on the multi-quad sprites.
 //					if(vsign==-1 && loop>0) voff+=vsign;
-					if(loop==0)	vquadoff=vsign;
-					if(vsign!=vquadoff) voff+=vsign;
+					if(loop==0)	mVQuadOff=vsign;
+					if(vsign!=mVQuadOff) voff+=vsign;
 					
 					for(;;)
 					{
@@ -884,36 +960,14 @@ ULONG CSusie::PaintSprites(void)
 								// get offset by 1 pixel in the other direction, this
 								// fixes the squashed look on the multi-quad sprites.
 //								if(hsign==-1 && loop>0) hoff+=hsign;
-								if(loop==0)	hquadoff=hsign;
-								if(hsign!=hquadoff) hoff+=hsign;
+								if(loop==0)	mHQuadOff=hsign;
+								if(hsign!=mHQuadOff) hoff+=hsign;
 
 								// Initialise our line
 								LineInit(voff);
-								onscreen=FALSE;
 
 								// Now render an individual destination line
-								while((pixel=LineGetPixel())!=LINE_END)
-								{
-									// This is allowed to update every pixel
-									mHSIZACUM.Word+=mSPRHSIZ.Word;
-									pixel_width=mHSIZACUM.Byte.High;
-									mHSIZACUM.Byte.High=0;
-
-									for(hloop=0;hloop<pixel_width;hloop++)
-									{
-										// Draw if onscreen but break loop on transition to offscreen
-										if(hoff>=0 && hoff<SCREEN_WIDTH)
-										{
-											ProcessPixel(hoff,pixel);
-											onscreen=everonscreen=TRUE;
-										}
-										else
-										{
-											if(onscreen) break;
-										}
-										hoff+=hsign;
-									}
-								}
+								if((this->*spriteline[hsign>0])(hoff)) everonscreen=TRUE;
 							}
 							voff+=vsign;
 
@@ -967,36 +1021,15 @@ ULONG CSusie::PaintSprites(void)
 			}
 
 			// Write the collision depositary if required
-
-			if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)
+#ifdef HANDY_SPRITE_THREADS
+			if(mSpriteListActive)
 			{
-				switch(mSPRCTL0_Type)
-				{
-					case sprite_xor_shadow:
-					case sprite_boundary:
-					case sprite_normal:
-					case sprite_boundary_shadow:
-					case sprite_shadow:
-						{
-							UWORD coldep=mSCBADR.Word+mCOLLOFF.Word;
-							RAM_POKE(coldep,(UBYTE)mCollision);
-							TRACE_SUSIE2("PaintSprites() COLLOFF=$%04x SCBADR=$%04x",mCOLLOFF.Word,mSCBADR.Word);
-							TRACE_SUSIE2("PaintSprites() Wrote $%02x to SCB collision depositary at $%04x",(UBYTE)mCollision,coldep);
-						}
-						break;
-					default:
-						break;
-				}
+				SpriteListClose(everonscreen);
 			}
-
-			if(mEVERON)
+			else
+#endif
 			{
-				UWORD coldep=mSCBADR.Word+mCOLLOFF.Word;
-				UBYTE coldat=RAM_PEEK(coldep);
-				if(!everonscreen) coldat|=0x80; else coldat&=0x7f;
-				RAM_POKE(coldep,coldat);
-				TRACE_SUSIE0("PaintSprites() EVERON IS ACTIVE");
-				TRACE_SUSIE2("PaintSprites() Wrote $%02x to SCB collision depositary at $%04x",coldat,coldep);
+				WriteDepositary(mSPRCTL0_Type,!mSPRCOLL_Collide && !mSPRSYS_NoCollide,mSCBADR.Word+mCOLLOFF.Word,everonscreen);
 			}
 
 			// Perform Sprite debugging if required, single step on sprite draw
@@ -1029,6 +1062,9 @@ ULONG CSusie::PaintSprites(void)
 		{
 			// Stop the system, otherwise we may just come straight back in.....
 			gSystemHalt=TRUE;
+#ifdef HANDY_SPRITE_THREADS
+			if(mSpriteListActive) SpriteListFlush();
+#endif
 			// Display warning message
 			gError->Warning("CSusie:PaintSprites(): Single draw sprite limit exceeded (>4096). The SCB is most likely looped back on itself. Reset/Exit is recommended");
 			// Signal error to the caller
@@ -1037,11 +1073,48 @@ ULONG CSusie::PaintSprites(void)
 	}
 	while(1);
 
+#ifdef HANDY_SPRITE_THREADS
+	if(mSpriteListActive) SpriteListFlush();
+#endif
+
 	// Fudge factor to fix many flickering issues, also the keypress
 	// problem with Hard Drivin and the strange pause in Dirty Larry.
-//	cycles_used>>=2;
+//	mCyclesUsed>>=2;
 
-	return cycles_used;
+	return mCyclesUsed;
+}
+
+//
+// Write the collision of the sprite just painted to its depositary, and
+// the everon flag
+//
+void CSusie::WriteDepositary(ULONG type,ULONG collide,UWORD coldep,int everonscreen)
+{
+	if(collide)
+	{
+		switch(type)
+		{
+			case sprite_xor_shadow:
+			case sprite_boundary:
+			case sprite_normal:
+			case sprite_boundary_shadow:
+			case sprite_shadow:
+				RAM_POKE(coldep,(UBYTE)mCollision);
+				TRACE_SUSIE2("WriteDepositary() Wrote $%02x to SCB collision depositary at $%04x",(UBYTE)mCollision,coldep);
+				break;
+			default:
+				break;
+		}
+	}
+
+	if(mEVERON)
+	{
+		UBYTE coldat=RAM_PEEK(coldep);
+		if(!everonscreen) coldat|=0x80; else coldat&=0x7f;
+		RAM_POKE(coldep,coldat);
+		TRACE_SUSIE0("WriteDepositary() EVERON IS ACTIVE");
+		TRACE_SUSIE2("WriteDepositary() Wrote $%02x to SCB collision depositary at $%04x",coldat,coldep);
+	}
 }
 
 //
@@ -1068,9 +1141,9 @@ ULONG CSusie::PaintSprites(void)
 //                        1 0 0 0 0 0 0 0   exclusive-or the data 
 //
 
-inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
+template<int Type,int Collide> inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 {
-	switch(mSPRCTL0_Type)
+	switch(Type)
 	{
 		// BACKGROUND SHADOW
 		// 1   F is opaque 
@@ -1080,8 +1153,8 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		// 1   allow coll. buffer access 
 		// 0   exclusive-or the data 
 		case sprite_background_shadow:
-			WritePixel(hoff,pixel);
-			if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide && pixel!=0x0e)
+			WritePixel<0>(hoff,pixel);
+			if(Collide && pixel!=0x0e)
 			{
 				WriteCollision(hoff,mSPRCOLL_Number);
 			}
@@ -1095,7 +1168,7 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		// 0   allow coll. buffer access 
 		// 0   exclusive-or the data 
 		case sprite_background_noncollide:
-			WritePixel(hoff,pixel);
+			WritePixel<0>(hoff,pixel);
 			break;
 
 		// NOCOLLIDE
@@ -1106,7 +1179,7 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		// 0   allow coll. buffer access 
 		// 0   exclusive-or the data 
 		case sprite_noncollide:
-			if(pixel!=0x00) WritePixel(hoff,pixel);
+			if(pixel!=0x00) WritePixel<0>(hoff,pixel);
 			break;
 
 		// BOUNDARY
@@ -1119,11 +1192,11 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		case sprite_boundary:
 			if(pixel!=0x00 && pixel!=0x0f)
 			{
-				WritePixel(hoff,pixel);
+				WritePixel<0>(hoff,pixel);
 			}
 			if(pixel!=0x00)
 			{
-				if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)
+				if(Collide)
 				{
 					int collision=ReadCollision(hoff);
 					if(collision>mCollision)
@@ -1148,8 +1221,8 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		case sprite_normal:
 			if(pixel!=0x00)
 			{
-				WritePixel(hoff,pixel);
-				if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)
+				WritePixel<0>(hoff,pixel);
+				if(Collide)
 				{
 					int collision=ReadCollision(hoff);
 					if(collision>mCollision)
@@ -1174,11 +1247,11 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		case sprite_boundary_shadow:
 			if(pixel!=0x00 && pixel!=0x0e && pixel!=0x0f)
 			{
-				WritePixel(hoff,pixel);
+				WritePixel<0>(hoff,pixel);
 			}
 			if(pixel!=0x00 && pixel!=0x0e)
 			{
-				if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)
+				if(Collide)
 				{
 					int collision=ReadCollision(hoff);
 					if(collision>mCollision)
@@ -1203,11 +1276,11 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		case sprite_shadow:
 			if(pixel!=0x00)
 			{
-				WritePixel(hoff,pixel);
+				WritePixel<0>(hoff,pixel);
 			}
 			if(pixel!=0x00 && pixel!=0x0e)
 			{
-				if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)
+				if(Collide)
 				{
 					int collision=ReadCollision(hoff);
 					if(collision>mCollision)
@@ -1232,11 +1305,11 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 		case sprite_xor_shadow:
 			if(pixel!=0x00)
 			{
-				WritePixel(hoff,ReadPixel(hoff)^pixel);
+				WritePixel<0>(hoff,ReadPixel(hoff)^pixel);
 			}
 			if(pixel!=0x00 && pixel!=0x0e)
 			{
-				if(!mSPRCOLL_Collide && !mSPRSYS_NoCollide && pixel!=0x0e)
+				if(Collide && pixel!=0x0e)
 				{
 					int collision=ReadCollision(hoff);
 					if(collision>mCollision)
@@ -1256,27 +1329,35 @@ inline void CSusie::ProcessPixel(ULONG hoff,ULONG pixel)
 	}
 }
 
-inline void CSusie::WritePixel(ULONG hoff,ULONG pixel)
+template<int Span> inline void CSusie::WritePixel(ULONG hoff,ULONG pixel)
 {
-	ULONG scr_addr=mLineBaseAddress+(hoff/2);
-	
-	UBYTE dest=RAM_PEEK(scr_addr);
-	if(!(hoff&0x01))
+	if(Span)
 	{
-		// Upper nibble screen write
-		dest&=0x0f;
-		dest|=pixel<<4;
+		// Held until LineCommit()
+		mLineSpanPen[hoff]=(UBYTE)(pixel|LINE_SPAN_SET);
 	}
 	else
 	{
-		// Lower nibble screen write
-		dest&=0xf0;
-		dest|=pixel;
+		ULONG scr_addr=mLineBaseAddress+(hoff/2);
+
+		UBYTE dest=RAM_PEEK(scr_addr);
+		if(!(hoff&0x01))
+		{
+			// Upper nibble screen write
+			dest&=0x0f;
+			dest|=pixel<<4;
+		}
+		else
+		{
+			// Lower nibble screen write
+			dest&=0xf0;
+			dest|=pixel;
+		}
+		RAM_POKE(scr_addr,dest);
 	}
-	RAM_POKE(scr_addr,dest);
 
 	// Increment cycle count for the read/modify/write
-	cycles_used+=2*SPR_RDWR_CYC;
+	mCyclesUsed+=2*SPR_RDWR_CYC;
 }
 
 inline ULONG CSusie::ReadPixel(ULONG hoff)
@@ -1296,7 +1377,7 @@ inline ULONG CSusie::ReadPixel(ULONG hoff)
 	}
 
 	// Increment cycle count for the read/modify/write
-	cycles_used+=SPR_RDWR_CYC;
+	mCyclesUsed+=SPR_RDWR_CYC;
 
 	return data;
 }
@@ -1321,7 +1402,7 @@ inline void CSusie::WriteCollision(ULONG hoff,ULONG pixel)
 	RAM_POKE(col_addr,dest);
 
 	// Increment cycle count for the read/modify/write
-	cycles_used+=2*SPR_RDWR_CYC;
+	mCyclesUsed+=2*SPR_RDWR_CYC;
 }
 
 inline ULONG CSusie::ReadCollision(ULONG hoff)
@@ -1341,11 +1422,65 @@ inline ULONG CSusie::ReadCollision(ULONG hoff)
 	}
 
 	// Increment cycle count for the read/modify/write
-	cycles_used+=SPR_RDWR_CYC;
+	mCyclesUsed+=SPR_RDWR_CYC;
 
 	return data;
 }
 
+//
+// The highest collision number from left to right on the collision line,
+// the same as a ReadCollision() of every pixel
+//
+ULONG CSusie::ReadCollisionSpan(int left,int right)
+{
+	mCyclesUsed+=(right-left+1)*SPR_RDWR_CYC;
+
+	ULONG collision=0;
+	if(left&0x01)
+	{
+		collision=RAM_PEEK(mLineCollisionAddress+(left/2))&0x0f;
+		left++;
+	}
+	if(!(right&0x01))
+	{
+		ULONG data=RAM_PEEK(mLineCollisionAddress+(right/2))>>4;
+		if(data>collision) collision=data;
+		right--;
+	}
+
+	// Whole bytes are left, both nibbles count
+	ULONG col_addr=mLineCollisionAddress+(left/2);
+	ULONG count=(right-left+1)/2;
+
+#ifdef SUSIE_SSE2
+	if(count>=16 && col_addr+count<=0x10000)
+	{
+		const __m128i nibble=_mm_set1_epi8(0x0f);
+		__m128i high=_mm_setzero_si128();
+		for(;count>=16;count-=16,col_addr+=16)
+		{
+			__m128i data=_mm_loadu_si128((const __m128i*)(mRamPointer+col_addr));
+			high=_mm_max_epu8(high,_mm_and_si128(data,nibble));
+			high=_mm_max_epu8(high,_mm_and_si128(_mm_srli_epi16(data,4),nibble));
+		}
+		high=_mm_max_epu8(high,_mm_srli_si128(high,8));
+		high=_mm_max_epu8(high,_mm_srli_si128(high,4));
+		high=_mm_max_epu8(high,_mm_srli_si128(high,2));
+		high=_mm_max_epu8(high,_mm_srli_si128(high,1));
+		ULONG data=_mm_cvtsi128_si32(high)&0x0f;
+		if(data>collision) collision=data;
+	}
+#endif
+
+	for(;count && collision<0x0f;count--,col_addr++)
+	{
+		ULONG data=RAM_PEEK(col_addr);
+		if((data>>4)>collision) collision=data>>4;
+		if((data&0x0f)>collision) collision=data&0x0f;
+	}
+	return collision;
+}
+
 
 inline ULONG CSusie::LineInit(ULONG voff)
 {
@@ -1362,9 +1497,18 @@ inline ULONG CSusie::LineInit(ULONG voff)
 
 	mTMPADR=mSPRDLINE;
 
+#ifdef HANDY_SPRITE_THREADS
+	if(mSpriteListActive) SpriteListCheck(mSPRDLINE.Word,3);
+#endif
+
 	// First read the Offset to the next line
 
 	ULONG offset=LineGetBits(8);
+
+#ifdef HANDY_SPRITE_THREADS
+	// The rest of the line and what LineDecode() fetches ahead
+	if(mSpriteListActive) SpriteListCheck(mSPRDLINE.Word,offset+9);
+#endif
 //	TRACE_SUSIE1("LineInit() Offset=%04x",offset);
 
 	// Specify the MAXIMUM number of bits in this packet, it
@@ -1394,6 +1538,11 @@ inline ULONG CSusie::LineInit(ULONG voff)
 
 	mLineBaseAddress=mVIDBAS.Word+(voff*(SCREEN_WIDTH/2));
 	mLineCollisionAddress=mCOLLBAS.Word+(voff*(SCREEN_WIDTH/2));
+
+	// Each pixel is only drawn once on a line so the writes can wait for
+	// the end of the line, unless a collision read could see them
+	ULONG apart=(mLineCollisionAddress-mLineBaseAddress)&0xffff;
+	mLineSpan=(apart>=SCREEN_WIDTH/2 && apart<=0x10000-SCREEN_WIDTH/2);
 //	TRACE_SUSIE1("LineInit() mLineBaseAddress=$%04x",mLineBaseAddress);
 //	TRACE_SUSIE1("LineInit() mLineCollisionAddress=$%04x",mLineCollisionAddress);
 
@@ -1402,77 +1551,6 @@ inline ULONG CSusie::LineInit(ULONG voff)
 	return offset;
 }
 
-inline ULONG CSusie::LineGetPixel()
-{
-	if(!mLineRepeatCount)
-	{
-		// Normal sprites fetch their counts on a packet basis
-		if(mLineType!=line_abs_literal)
-		{
-			ULONG literal=LineGetBits(1);
-			if(literal) mLineType=line_literal; else mLineType=line_packed;
-		}
-
-		// Pixel store is empty what should we do
-		switch(mLineType)
-		{
-			case line_abs_literal:
-				// This means end of line for us
-				mLinePixel=LINE_END;
-				return mLinePixel;		// SPEEDUP
-				break;
-			case line_literal:
-				mLineRepeatCount=LineGetBits(4);
-				mLineRepeatCount++;
-				break;
-			case line_packed:
-				//
-				// From reading in between the lines only a packed line with
-				// a zero size i.e 0b00000 as a header is allowable as a packet end
-				//
-				mLineRepeatCount=LineGetBits(4);
-				if(!mLineRepeatCount)
-				{
-					mLinePixel=LINE_END;
-				}
-				else
-				{
-					mLinePixel=mPenIndex[LineGetBits(mSPRCTL0_PixelBits)];
-				}
-				mLineRepeatCount++;
-				break;
-			default:
-				return 0;
-		}
-	}
-
-	if(mLinePixel!=LINE_END)
-	{
-		mLineRepeatCount--;
-
-		switch(mLineType)
-		{
-			case line_abs_literal:
-				mLinePixel=LineGetBits(mSPRCTL0_PixelBits);
-				// Check the special case of a zero in the last pixel
-				if(!mLineRepeatCount && !mLinePixel)
-					mLinePixel=LINE_END;
-				else
-					mLinePixel=mPenIndex[mLinePixel];
-				break;
-			case line_literal:
-				mLinePixel=mPenIndex[LineGetBits(mSPRCTL0_PixelBits)];
-				break;
-			case line_packed:
-				break;
-			default:
-				return 0;
-		}
-	}
-
-	return mLinePixel;
-}
-
 inline ULONG CSusie::LineGetBits(ULONG bits)
 {
 	ULONG retval;
@@ -1498,7 +1576,7 @@ inline ULONG CSusie::LineGetBits(ULONG bits)
 		mLineShiftRegCount+=24;
 
 		// Increment cycle count for the read
-		cycles_used+=3*SPR_RDWR_CYC;
+		mCyclesUsed+=3*SPR_RDWR_CYC;
 	}
 
 	// Extract the return value
@@ -1512,6 +1590,952 @@ inline ULONG CSusie::LineGetBits(ULONG bits)
 	return retval;
 }
 
+template<int Bits,int Literal> inline ULONG CSusie::LineGetPixel()
+{
+	if(Literal)
+	{
+		// This means end of line for us
+		if(!mLineRepeatCount)
+		{
+			mLinePixel=LINE_END;
+			return mLinePixel;
+		}
+
+		mLineRepeatCount--;
+		mLinePixel=LineGetBits(Bits);
+		// Check the special case of a zero in the last pixel
+		if(!mLineRepeatCount && !mLinePixel)
+			mLinePixel=LINE_END;
+		else
+			mLinePixel=mPenIndex[mLinePixel];
+		return mLinePixel;
+	}
+
+	if(!mLineRepeatCount)
+	{
+		// Pixel store is empty, fetch the next packet header
+		if(LineGetBits(1))
+		{
+			mLineType=line_literal;
+			mLineRepeatCount=LineGetBits(4);
+			mLineRepeatCount++;
+		}
+		else
+		{
+			mLineType=line_packed;
+			//
+			// From reading in between the lines only a packed line with
+			// a zero size i.e 0b00000 as a header is allowable as a packet end
+			//
+			mLineRepeatCount=LineGetBits(4);
+			if(!mLineRepeatCount)
+			{
+				mLinePixel=LINE_END;
+			}
+			else
+			{
+				mLinePixel=mPenIndex[LineGetBits(Bits)];
+			}
+			mLineRepeatCount++;
+		}
+	}
+
+	if(mLinePixel!=LINE_END)
+	{
+		mLineRepeatCount--;
+
+		if(mLineType==line_literal)
+		{
+			mLinePixel=mPenIndex[LineGetBits(Bits)];
+		}
+	}
+
+	return mLinePixel;
+}
+
+//
+// Packet headers are a literal flag and one less than the pixel count, a
+// repeat packet of one pixel ends the line. Each entry is the pixel count
+// with 0x20 set for literal packets, or zero for the end of the line.
+//
+static const UBYTE gSpritePacket[32]=
+{
+	0x00,0x02,0x03,0x04,0x05,0x06,0x07,0x08,
+	0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f,0x10,
+	0x21,0x22,0x23,0x24,0x25,0x26,0x27,0x28,
+	0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,0x30
+};
+
+//
+// Bit reader for LineDecode(), the same fields as LineGetBits() but the
+// shift register is topped up to 64 bits a byte at a time
+//
+struct TSpriteBits
+{
+	const UBYTE			*ram;
+	ULONG				addr;
+	unsigned long long	reg;
+	ULONG				count;
+	ULONG				left;
+
+	inline ULONG Get(ULONG bits)
+	{
+		// Fields past the end of the packet read as zero and use nothing
+		if(left<bits) return 0;
+
+		if(count<bits)
+		{
+			while(count<=56)
+			{
+				reg|=(unsigned long long)ram[addr&0xffff]<<(56-count);
+				addr++;
+				count+=8;
+			}
+		}
+
+		ULONG value=(ULONG)(reg>>(64-bits));
+		reg<<=bits;
+		count-=bits;
+		left-=bits;
+		return value;
+	}
+};
+
+static inline void SpriteAddRun(UBYTE *pen,UWORD *length,ULONG &runs,ULONG colour,ULONG count)
+{
+	if(runs && pen[runs-1]==colour)
+	{
+		length[runs-1]+=count;
+	}
+	else if(runs<LINE_MAX_RUNS)
+	{
+		pen[runs]=colour;
+		length[runs]=count;
+		runs++;
+	}
+}
+
+//
+// Expand the rest of the line set up by LineInit() into runs of pens.
+// Reading a field at a time the hardware fetches the line 3 bytes at a
+// time and LineInit() has charged for the first 3, we charge for the rest
+// here. LineInit() always comes before anything looks at the line state
+// again, so only the address and cycles need to come out the same.
+//
+template<int Bits,int Literal> inline void CSusie::LineDecode(void)
+{
+	TSpriteBits bits;
+	bits.ram=mRamPointer;
+	bits.addr=mSPRDLINE.Word+1;
+	bits.reg=0;
+	bits.count=0;
+	bits.left=mLinePacketBitsLeft;
+
+	ULONG runs=0;
+
+	if(Literal)
+	{
+		// Check the special case of a zero in the last pixel
+		for(ULONG pixels=mLineRepeatCount;pixels;pixels--)
+		{
+			ULONG pixel=bits.Get(Bits);
+			if(pixels==1 && !pixel) break;
+			SpriteAddRun(mLineRunPen,mLineRunLength,runs,mPenIndex[pixel],1);
+		}
+	}
+	else
+	{
+		for(;;)
+		{
+			ULONG header;
+			if(bits.left>=5)
+			{
+				header=bits.Get(5);
+			}
+			else
+			{
+				header=bits.Get(1)<<4;
+				header|=bits.Get(4);
+			}
+
+			ULONG packet=gSpritePacket[header];
+			if(!packet) break;
+
+			if(packet&0x20)
+			{
+				for(ULONG pixels=packet&0x1f;pixels;pixels--)
+				{
+					SpriteAddRun(mLineRunPen,mLineRunLength,runs,mPenIndex[bits.Get(Bits)],1);
+				}
+			}
+			else
+			{
+				SpriteAddRun(mLineRunPen,mLineRunLength,runs,mPenIndex[bits.Get(Bits)],packet);
+			}
+		}
+	}
+	mLineRuns=runs;
+
+	// The offset and the data used, in 3 byte reads
+	ULONG reads=(8+mLinePacketBitsLeft-bits.left+23)/24;
+	mCyclesUsed+=(reads-1)*3*SPR_RDWR_CYC;
+	mTMPADR.Word=mSPRDLINE.Word+reads*3;
+	mLinePacketBitsLeft=bits.left;
+}
+
+//
+// The pens each sprite type draws on the screen, as in ProcessPixel()
+//
+template<int Type> static inline bool SpriteWritesPen(ULONG pixel)
+{
+	switch(Type)
+	{
+		case sprite_background_shadow:
+		case sprite_background_noncollide:
+			return TRUE;
+		case sprite_boundary:
+			return pixel!=0x00 && pixel!=0x0f;
+		case sprite_boundary_shadow:
+			return pixel!=0x00 && pixel!=0x0e && pixel!=0x0f;
+		default:
+			return pixel!=0x00;
+	}
+}
+
+//
+// The pens each sprite type puts in the collision buffer when collisions
+// are on, all but the background shadow read the buffer first
+//
+template<int Type> static inline bool SpriteWritesCollision(ULONG pixel)
+{
+	switch(Type)
+	{
+		case sprite_background_shadow:
+			return pixel!=0x0e;
+		case sprite_boundary:
+		case sprite_normal:
+			return pixel!=0x00;
+		case sprite_boundary_shadow:
+		case sprite_shadow:
+		case sprite_xor_shadow:
+			return pixel!=0x00 && pixel!=0x0e;
+		default:
+			return FALSE;
+	}
+}
+
+//
+// The cycles ProcessSpan() takes for a span, they only depend on the pen
+//
+template<int Type,int Collide> static inline ULONG SpriteSpanCycles(ULONG pixel,ULONG count)
+{
+	ULONG cycles=0;
+	if(SpriteWritesPen<Type>(pixel)) cycles+=(Type==sprite_xor_shadow)?3:2;
+	if(Collide && SpriteWritesCollision<Type>(pixel)) cycles+=(Type==sprite_background_shadow)?2:3;
+	return cycles*count*SPR_RDWR_CYC;
+}
+
+template<int Type,int Bits,int Literal,int Collide,int Hsign> ULONG CSusie::SpriteLine(int hoff)
+{
+	if(LineOverwritesData<Collide>())
+	{
+#ifdef HANDY_SPRITE_THREADS
+		if(mSpriteListActive)
+		{
+			// Draw in turn, the sprite keeps any collision it finds
+			SpriteListFlush();
+			ULONG onscreen=SpriteFields<Type,Bits,Literal,Collide,Hsign>(hoff);
+			mpSpriteListSprite[mSpriteListSprites-1].collision=(UBYTE)mCollision;
+			return onscreen;
+		}
+#endif
+		return SpriteFields<Type,Bits,Literal,Collide,Hsign>(hoff);
+	}
+
+#ifdef HANDY_SPRITE_THREADS
+	if(mSpriteListActive)
+	{
+		LineDecode<Bits,Literal>();
+		return SpriteRecord<Type,Collide,Hsign>(hoff);
+	}
+#endif
+
+	if(Literal && !Collide && SpriteBlitAllowed()) return SpriteBlit<Type,Bits,Hsign>(hoff);
+
+	LineDecode<Bits,Literal>();
+
+	if(mLineSpan) return SpriteDraw<Type,Collide,Hsign,1>(hoff);
+	return SpriteDraw<Type,Collide,Hsign,0>(hoff);
+}
+
+//
+// Draw a line reading the data a field at a time between the pixels, so
+// pixels drawn over the data that is still to come are read back as the
+// hardware would.
+//
+template<int Type,int Bits,int Literal,int Collide,int Hsign> ULONG CSusie::SpriteFields(int hoff)
+{
+	ULONG onscreen=FALSE;
+	ULONG pixel;
+
+	while((pixel=LineGetPixel<Bits,Literal>())!=LINE_END)
+	{
+		// This is allowed to update every pixel
+		mHSIZACUM.Word+=mSPRHSIZ.Word;
+		int pixel_width=mHSIZACUM.Byte.High;
+		mHSIZACUM.Byte.High=0;
+
+		for(int hloop=0;hloop<pixel_width;hloop++)
+		{
+			// Draw if onscreen but break loop on transition to offscreen
+			if(hoff>=0 && hoff<SCREEN_WIDTH)
+			{
+				ProcessPixel<Type,Collide>(hoff,pixel);
+				onscreen=TRUE;
+			}
+			else
+			{
+				if(onscreen) break;
+			}
+			hoff+=Hsign;
+		}
+	}
+	return onscreen;
+}
+
+//
+// Check if the line data lies in the screen line, or the collision buffer
+// line when collisions are on, that the line is drawn on
+//
+template<int Collide> inline bool CSusie::LineOverwritesData(void)
+{
+	// The line data plus what the bit reader fetches ahead
+	ULONG length=mLinePacketBitsLeft/8+9;
+	if(((mLineBaseAddress-mSPRDLINE.Word)&0xffff)<length) return TRUE;
+	if(((mSPRDLINE.Word-mLineBaseAddress)&0xffff)<SCREEN_WIDTH/2) return TRUE;
+	if(Collide)
+	{
+		if(((mLineCollisionAddress-mSPRDLINE.Word)&0xffff)<length) return TRUE;
+		if(((mSPRDLINE.Word-mLineCollisionAddress)&0xffff)<SCREEN_WIDTH/2) return TRUE;
+	}
+	return FALSE;
+}
+
+template<int Type,int Collide,int Hsign,int Span> ULONG CSusie::SpriteDraw(int hoff)
+{
+	ULONG onscreen=FALSE;
+	int start=hoff;
+
+	for(ULONG run=0;run<mLineRuns;run++)
+	{
+		ULONG pixel=mLineRunPen[run];
+
+		if(Span)
+		{
+			// The screen pixels covered by the run, once the line has been
+			// on screen drawing stops at the edge
+			int width=LineRunWidth(mLineRunLength[run]);
+			int left=(Hsign>0)?hoff:hoff-width+1;
+			int right=(Hsign>0)?hoff+width-1:hoff;
+			if(left<0) left=0;
+			if(right>=SCREEN_WIDTH) right=SCREEN_WIDTH-1;
+
+			if(left<=right)
+			{
+				ProcessSpan<Type,Collide>(left,right,pixel);
+				onscreen=TRUE;
+			}
+			hoff+=width*Hsign;
+			if(onscreen && (hoff<-1 || hoff>SCREEN_WIDTH)) hoff=(Hsign>0)?SCREEN_WIDTH:-1;
+			continue;
+		}
+
+		for(ULONG length=mLineRunLength[run];length;length--)
+		{
+			// This is allowed to update every pixel
+			mHSIZACUM.Word+=mSPRHSIZ.Word;
+			int pixel_width=mHSIZACUM.Byte.High;
+			mHSIZACUM.Byte.High=0;
+
+			for(int hloop=0;hloop<pixel_width;hloop++)
+			{
+				// Draw if onscreen but break loop on transition to offscreen
+				if(hoff>=0 && hoff<SCREEN_WIDTH)
+				{
+					ProcessPixel<Type,Collide>(hoff,pixel);
+					onscreen=TRUE;
+				}
+				else
+				{
+					if(onscreen) break;
+				}
+				hoff+=Hsign;
+			}
+		}
+	}
+
+	if(Span && onscreen)
+	{
+		// Everything drawn lies between where we started and finished
+		if(Hsign>0) LineCommit(start,hoff-1); else LineCommit(hoff+1,start);
+	}
+	return onscreen;
+}
+
+//
+// The screen pixels a run of source pixels covers, stepping the size
+// accumulator as drawing each pixel would. Once the carry of the offset is
+// out of the accumulator each pixel adds the size to the fraction in the
+// low byte, so without the 16 bit wrap the widths add up in one go.
+//
+inline ULONG CSusie::LineRunWidth(ULONG length)
+{
+	ULONG width=0;
+
+	if(mHSIZACUM.Byte.High || mSPRHSIZ.Word>0xff00)
+	{
+		mHSIZACUM.Word+=mSPRHSIZ.Word;
+		width=mHSIZACUM.Byte.High;
+		mHSIZACUM.Byte.High=0;
+		length--;
+
+		if(mSPRHSIZ.Word>0xff00)
+		{
+			for(;length;length--)
+			{
+				mHSIZACUM.Word+=mSPRHSIZ.Word;
+				width+=mHSIZACUM.Byte.High;
+				mHSIZACUM.Byte.High=0;
+			}
+		}
+	}
+
+	ULONG total=mHSIZACUM.Byte.Low+length*mSPRHSIZ.Word;
+	mHSIZACUM.Byte.Low=(UBYTE)total;
+	return width+(total>>8);
+}
+
+//
+// Draw a span of pixels in the same pen on the current line, the same as
+// a ProcessPixel() of each one while the writes are held in the line
+// spans. Only the exclusive-or has to look at each pixel.
+//
+template<int Type,int Collide> inline void CSusie::ProcessSpan(int left,int right,ULONG pixel)
+{
+	ULONG count=right-left+1;
+
+	if(SpriteWritesPen<Type>(pixel))
+	{
+		if(Type==sprite_xor_shadow)
+		{
+			for(int hoff=left;hoff<=right;hoff++) WritePixel<1>(hoff,ReadPixel(hoff)^pixel);
+		}
+		else
+		{
+			memset(mLineSpanPen+left,pixel|LINE_SPAN_SET,count);
+			mCyclesUsed+=count*2*SPR_RDWR_CYC;
+		}
+	}
+
+	if(Collide && SpriteWritesCollision<Type>(pixel))
+	{
+		if(Type!=sprite_background_shadow)
+		{
+			int collision=ReadCollisionSpan(left,right);
+			if(collision>mCollision)
+			{
+				mCollision=collision;
+			}
+		}
+		memset(mLineSpanCollision+left,mSPRCOLL_Number|LINE_SPAN_SET,count);
+		mCyclesUsed+=count*2*SPR_RDWR_CYC;
+	}
+}
+
+//
+// Every pixel of the line is one screen pixel wide when the size is 1.0 and
+// the accumulator starts without a carry, the stretch and tilt are applied
+// between lines. The line data mustn't be in the screen line as it's read
+// while the line is written.
+//
+inline bool CSusie::SpriteBlitAllowed(void)
+{
+	if(mSPRHSIZ.Word!=0x100 || mHSIZACUM.Byte.High) return FALSE;
+
+	// The line data plus what the bit reader fetches ahead
+	ULONG length=mLinePacketBitsLeft/8+9;
+	if(((mLineBaseAddress-mSPRDLINE.Word)&0xffff)<length) return FALSE;
+	if(((mSPRDLINE.Word-mLineBaseAddress)&0xffff)<SCREEN_WIDTH/2) return FALSE;
+	return TRUE;
+}
+
+//
+// Draw an unscaled literal line without collision. Only the pixels that
+// land on screen are read, the pens are gathered into a byte and mask and
+// each screen byte is written once. The data used and the cycles come out
+// the same as LineDecode() and SpriteDraw().
+//
+template<int Type,int Bits,int Hsign> ULONG CSusie::SpriteBlit(int hoff)
+{
+	ULONG count=mLineRepeatCount;
+	ULONG onscreen=FALSE;
+
+	// The pixels from first up to last are on screen
+	int first,last;
+	if(Hsign>0)
+	{
+		first=(hoff<0)?-hoff:0;
+		last=SCREEN_WIDTH-hoff;
+	}
+	else
+	{
+		first=(hoff>=SCREEN_WIDTH)?hoff-(SCREEN_WIDTH-1):0;
+		last=hoff+1;
+	}
+	if(last>(int)count) last=count;
+
+	if(first<last)
+	{
+		ULONG skip=first*Bits;
+
+		TSpriteBits bits;
+		bits.ram=mRamPointer;
+		bits.addr=mSPRDLINE.Word+1+skip/8;
+		bits.reg=0;
+		bits.count=0;
+		bits.left=mLinePacketBitsLeft-(skip&~7);
+		if(skip&7) bits.Get(skip&7);
+
+		int x=hoff+first*Hsign;
+		ULONG mask=0;
+		ULONG value=0;
+
+		for(int loop=first;loop<last;loop++)
+		{
+			ULONG pixel=bits.Get(Bits);
+
+			// Check the special case of a zero in the last pixel
+			if(loop!=(int)count-1 || pixel)
+			{
+				pixel=mPenIndex[pixel];
+				onscreen=TRUE;
+
+				if(SpriteWritesPen<Type>(pixel))
+				{
+					ULONG shift=(x&0x01)?0:4;
+					mask|=0x0f<<shift;
+					value|=pixel<<shift;
+
+					// The read/modify/write of each pixel
+					if(Type==sprite_xor_shadow) mCyclesUsed+=3*SPR_RDWR_CYC; else mCyclesUsed+=2*SPR_RDWR_CYC;
+				}
+			}
+
+			// Write out the byte when leaving it
+			if(mask && (loop==last-1 || (Hsign>0)==((x&0x01)!=0)))
+			{
+				ULONG scr_addr=mLineBaseAddress+(x/2);
+				UBYTE dest;
+
+				if(Type==sprite_xor_shadow) dest=RAM_PEEK(scr_addr)^value;
+				else if(mask==0xff) dest=value;
+				else dest=(RAM_PEEK(scr_addr)&~mask)|value;
+				RAM_POKE(scr_addr,dest);
+				mask=0;
+				value=0;
+			}
+			x+=Hsign;
+		}
+	}
+
+	// Every pixel of the line is read, in 3 byte reads
+	ULONG used=count*Bits;
+	ULONG reads=(8+used+23)/24;
+	mCyclesUsed+=(reads-1)*3*SPR_RDWR_CYC;
+	mTMPADR.Word=mSPRDLINE.Word+reads*3;
+	mLinePacketBitsLeft-=used;
+	return onscreen;
+}
+
+//
+// Write the pixels held in the line spans to the screen and collision
+// buffers and clear the spans, bytes with both pixels written don't need
+// to be read first
+//
+void CSusie::LineCommit(int left,int right)
+{
+	if(left<0) left=0;
+	if(right>=SCREEN_WIDTH) right=SCREEN_WIDTH-1;
+
+	for(int hoff=left&~1;hoff<=right;hoff+=2)
+	{
+		ULONG high=mLineSpanPen[hoff];
+		ULONG low=mLineSpanPen[hoff+1];
+		if(high|low)
+		{
+			ULONG scr_addr=mLineBaseAddress+(hoff/2);
+			UBYTE dest;
+
+			if(high && low)
+			{
+				dest=(UBYTE)(((high&0x0f)<<4)|(low&0x0f));
+			}
+			else
+			{
+				dest=RAM_PEEK(scr_addr);
+				if(high) dest=(dest&0x0f)|((high&0x0f)<<4); else dest=(dest&0xf0)|(low&0x0f);
+			}
+			RAM_POKE(scr_addr,dest);
+			mLineSpanPen[hoff]=0;
+			mLineSpanPen[hoff+1]=0;
+		}
+
+		high=mLineSpanCollision[hoff];
+		low=mLineSpanCollision[hoff+1];
+		if(high|low)
+		{
+			ULONG col_addr=mLineCollisionAddress+(hoff/2);
+			UBYTE dest;
+
+			if(high && low)
+			{
+				dest=(UBYTE)(((high&0x0f)<<4)|(low&0x0f));
+			}
+			else
+			{
+				dest=RAM_PEEK(col_addr);
+				if(high) dest=(dest&0x0f)|((high&0x0f)<<4); else dest=(dest&0xf0)|(low&0x0f);
+			}
+			RAM_POKE(col_addr,dest);
+			mLineSpanCollision[hoff]=0;
+			mLineSpanCollision[hoff+1]=0;
+		}
+	}
+}
+
+#define SPRITE_DIRECTION(type,bits,literal,collide) \
+	{ \
+		&CSusie::SpriteLine<type,bits,literal,collide,-1>, \
+		&CSusie::SpriteLine<type,bits,literal,collide,1> \
+	}
+
+#define SPRITE_COLLIDE(type,bits,literal) \
+	{ SPRITE_DIRECTION(type,bits,literal,0), SPRITE_DIRECTION(type,bits,literal,1) }
+
+#define SPRITE_LITERAL(type,bits) \
+	{ SPRITE_COLLIDE(type,bits,0), SPRITE_COLLIDE(type,bits,1) }
+
+#define SPRITE_TYPE(type) \
+	{ SPRITE_LITERAL(type,1), SPRITE_LITERAL(type,2), SPRITE_LITERAL(type,3), SPRITE_LITERAL(type,4) }
+
+const CSusie::TSpriteLine* CSusie::SpriteSelectLine(void)
+{
+	static const TSpriteLine lines[8][4][2][2][2]=
+	{
+		SPRITE_TYPE(sprite_background_shadow),
+		SPRITE_TYPE(sprite_background_noncollide),
+		SPRITE_TYPE(sprite_boundary_shadow),
+		SPRITE_TYPE(sprite_boundary),
+		SPRITE_TYPE(sprite_normal),
+		SPRITE_TYPE(sprite_noncollide),
+		SPRITE_TYPE(sprite_xor_shadow),
+		SPRITE_TYPE(sprite_shadow)
+	};
+
+	// The collision flags can't change while the sprites are painted
+	ULONG collide=(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)?1:0;
+	ULONG literal=mSPRCTL1_Literal?1:0;
+
+	return lines[mSPRCTL0_Type][mSPRCTL0_PixelBits-1][literal][collide];
+}
+
+#undef SPRITE_TYPE
+#undef SPRITE_LITERAL
+#undef SPRITE_COLLIDE
+#undef SPRITE_DIRECTION
+
+#ifdef HANDY_SPRITE_THREADS
+//
+// Lines of different bands can be drawn in any order as long as no
+// collision buffer line shares bytes with a screen line
+//
+bool CSusie::SpriteListUsable(void)
+{
+	if(mThreads<2 || gSingleStepModeSprites) return FALSE;
+
+	ULONG size=SCREEN_HEIGHT*(SCREEN_WIDTH/2);
+	ULONG apart=(mCOLLBAS.Word-mVIDBAS.Word)&0xffff;
+	return apart>=size && apart<=0x10000-size;
+}
+
+void CSusie::SpriteListOpen(void)
+{
+	if(mSpriteListSprites==SPRITE_LIST_SPRITES) SpriteListFlush();
+
+	TSPRITELISTSPRITE &sprite=mpSpriteListSprite[mSpriteListSprites++];
+	sprite.type=(UBYTE)mSPRCTL0_Type;
+	sprite.collide=(!mSPRCOLL_Collide && !mSPRSYS_NoCollide)?1:0;
+	sprite.number=(UBYTE)mSPRCOLL_Number;
+	sprite.collision=0;
+	sprite.closed=mSPRCTL1_SkipSprite?1:0;
+	sprite.deposit=0;
+	sprite.everonscreen=0;
+	sprite.depositary=0;
+}
+
+void CSusie::SpriteListClose(int everonscreen)
+{
+	TSPRITELISTSPRITE &sprite=mpSpriteListSprite[mSpriteListSprites-1];
+	sprite.closed=1;
+	sprite.deposit=1;
+	sprite.everonscreen=everonscreen?1:0;
+	sprite.depositary=mSCBADR.Word+mCOLLOFF.Word;
+
+	if(sprite.collide || mEVERON)
+	{
+		mpSpriteListPending[sprite.depositary>>3]|=1<<(sprite.depositary&0x07);
+		mSpriteListPendings++;
+
+		// Sprites after this one might draw over it
+		ULONG size=SCREEN_HEIGHT*(SCREEN_WIDTH/2);
+		if(((sprite.depositary-mVIDBAS.Word)&0xffff)<size || ((sprite.depositary-mCOLLBAS.Word)&0xffff)<size)
+		{
+			SpriteListFlush();
+		}
+	}
+}
+
+//
+// Draw the list before reading RAM it could change
+//
+void CSusie::SpriteListCheck(ULONG addr,ULONG length)
+{
+	ULONG size=SCREEN_HEIGHT*(SCREEN_WIDTH/2);
+
+	if(mSpriteListLines)
+	{
+		if(((addr-mVIDBAS.Word)&0xffff)<size || ((mVIDBAS.Word-addr)&0xffff)<length ||
+			((addr-mCOLLBAS.Word)&0xffff)<size || ((mCOLLBAS.Word-addr)&0xffff)<length)
+		{
+			SpriteListFlush();
+			return;
+		}
+	}
+
+	if(mSpriteListPendings)
+	{
+		for(ULONG loop=0;loop<length;loop++)
+		{
+			ULONG pending=(addr+loop)&0xffff;
+			if(mpSpriteListPending[pending>>3]&(1<<(pending&0x07)))
+			{
+				SpriteListFlush();
+				return;
+			}
+		}
+	}
+}
+
+//
+// Record the spans a line would draw and take their cycles, the same
+// walk over the runs as SpriteDraw()
+//
+template<int Type,int Collide,int Hsign> ULONG CSusie::SpriteRecord(int hoff)
+{
+	if(mSpriteListLines==SPRITE_LIST_LINES || mSpriteListSpans+SCREEN_WIDTH>SPRITE_LIST_SPANS) SpriteListFlush();
+
+	TSPRITELISTLINE &line=mpSpriteListLine[mSpriteListLines];
+	line.sprite=(UWORD)(mSpriteListSprites-1);
+	line.voff=(UBYTE)((mLineBaseAddress-mVIDBAS.Word)/(SCREEN_WIDTH/2));
+	line.span=mSpriteListSpans;
+
+	ULONG onscreen=FALSE;
+
+	for(ULONG run=0;run<mLineRuns;run++)
+	{
+		ULONG pixel=mLineRunPen[run];
+
+		int width=LineRunWidth(mLineRunLength[run]);
+		int left=(Hsign>0)?hoff:hoff-width+1;
+		int right=(Hsign>0)?hoff+width-1:hoff;
+		if(left<0) left=0;
+		if(right>=SCREEN_WIDTH) right=SCREEN_WIDTH-1;
+
+		if(left<=right)
+		{
+			ULONG cycles=SpriteSpanCycles<Type,Collide>(pixel,right-left+1);
+			if(cycles)
+			{
+				TSPRITELISTSPAN &span=mpSpriteListSpan[mSpriteListSpans++];
+				span.left=(UBYTE)left;
+				span.right=(UBYTE)right;
+				span.pen=(UBYTE)pixel;
+				mCyclesUsed+=cycles;
+			}
+			onscreen=TRUE;
+		}
+		hoff+=width*Hsign;
+		if(onscreen && (hoff<-1 || hoff>SCREEN_WIDTH)) hoff=(Hsign>0)?SCREEN_WIDTH:-1;
+	}
+
+	line.spans=(UBYTE)(mSpriteListSpans-line.span);
+	if(line.spans) mSpriteListLines++;
+	return onscreen;
+}
+
+template<int Type,int Collide> void CSusie::SpriteListDraw(const CSusie &list,const TSPRITELISTLINE &line)
+{
+	const TSPRITELISTSPAN *span=list.mpSpriteListSpan+line.span;
+	int left=SCREEN_WIDTH;
+	int right=0;
+
+	for(ULONG loop=0;loop<line.spans;loop++,span++)
+	{
+		ProcessSpan<Type,Collide>(span->left,span->right,span->pen);
+		if(span->left<left) left=span->left;
+		if(span->right>right) right=span->right;
+	}
+	LineCommit(left,right);
+}
+
+#define SPRITE_LIST_DRAW(type) \
+	{ &CSusie::SpriteListDraw<type,0>, &CSusie::SpriteListDraw<type,1> }
+
+//
+// Draw the lines of the list that fall in the band, in list order. Run
+// on the Susie of the band, the list and the collision of each sprite
+// belong to the Susie painting the sprites.
+//
+void CSusie::SpriteListBand(const CSusie &list,ULONG band)
+{
+	static const TSpriteListDraw draw[8][2]=
+	{
+		SPRITE_LIST_DRAW(sprite_background_shadow),
+		SPRITE_LIST_DRAW(sprite_background_noncollide),
+		SPRITE_LIST_DRAW(sprite_boundary_shadow),
+		SPRITE_LIST_DRAW(sprite_boundary),
+		SPRITE_LIST_DRAW(sprite_normal),
+		SPRITE_LIST_DRAW(sprite_noncollide),
+		SPRITE_LIST_DRAW(sprite_xor_shadow),
+		SPRITE_LIST_DRAW(sprite_shadow)
+	};
+
+	ULONG top=SCREEN_HEIGHT*band/list.mThreads;
+	ULONG bottom=SCREEN_HEIGHT*(band+1)/list.mThreads;
+	UBYTE *collision=list.mpSpriteListCollision+band*SPRITE_LIST_SPRITES;
+	memset(collision,0,list.mSpriteListSprites);
+
+	for(ULONG loop=0;loop<list.mSpriteListLines;loop++)
+	{
+		const TSPRITELISTLINE &line=list.mpSpriteListLine[loop];
+		if(line.voff<top || line.voff>=bottom) continue;
+
+		const TSPRITELISTSPRITE &sprite=list.mpSpriteListSprite[line.sprite];
+		mLineBaseAddress=list.mVIDBAS.Word+(line.voff*(SCREEN_WIDTH/2));
+		mLineCollisionAddress=list.mCOLLBAS.Word+(line.voff*(SCREEN_WIDTH/2));
+		mSPRCOLL_Number=sprite.number;
+		mCollision=0;
+
+		(this->*draw[sprite.type][sprite.collide])(list,line);
+		if(mCollision>collision[line.sprite]) collision[line.sprite]=(UBYTE)mCollision;
+	}
+}
+
+#undef SPRITE_LIST_DRAW
+
+//
+// Draw the lines in the list and write the depositaries of the sprites
+// that are finished. A sprite still being painted carries its collision
+// into a new list.
+//
+void CSusie::SpriteListFlush(void)
+{
+	if(mSpriteListLines)
+	{
+		mPool.Run();
+
+#ifdef HANDY_BLOCK_CACHE
+		// Only now the bands are done can the CPU drop the code they wrote over
+		for(ULONG band=0;band<mThreads;band++)
+		{
+			UBYTE *written=mpBand[band]->mBandCodeWrites;
+			for(ULONG page=0;page<256;page++)
+			{
+				if(!written[page]) continue;
+				written[page]=FALSE;
+				mSystem.mCpu->CodeWrite(page<<8);
+			}
+		}
+#endif
+	}
+
+	for(ULONG loop=0;loop<mSpriteListSprites;loop++)
+	{
+		TSPRITELISTSPRITE &sprite=mpSpriteListSprite[loop];
+
+		int collision=sprite.collision;
+		if(mSpriteListLines)
+		{
+			for(ULONG band=0;band<mThreads;band++)
+			{
+				int value=mpSpriteListCollision[band*SPRITE_LIST_SPRITES+loop];
+				if(value>collision) collision=value;
+			}
+		}
+		mCollision=collision;
+
+		if(sprite.deposit)
+		{
+			WriteDepositary(sprite.type,sprite.collide,sprite.depositary,sprite.everonscreen);
+			mpSpriteListPending[sprite.depositary>>3]&=~(1<<(sprite.depositary&0x07));
+		}
+	}
+
+	if(mSpriteListSprites && !mpSpriteListSprite[mSpriteListSprites-1].closed)
+	{
+		mpSpriteListSprite[0]=mpSpriteListSprite[mSpriteListSprites-1];
+		mpSpriteListSprite[0].collision=(UBYTE)mCollision;
+		mSpriteListSprites=1;
+	}
+	else
+	{
+		mSpriteListSprites=0;
+	}
+	mSpriteListLines=0;
+	mSpriteListSpans=0;
+	mSpriteListPendings=0;
+}
+
+void CSusie::StopThreads(void)
+{
+	mPool.Stop();
+
+	for(int loop=0;loop<SPRITE_MAX_THREADS;loop++)
+	{
+		delete mpBand[loop];
+		mpBand[loop]=NULL;
+	}
+	delete[] mpSpriteListSprite;
+	delete[] mpSpriteListLine;
+	delete[] mpSpriteListSpan;
+	delete[] mpSpriteListPending;
+	delete[] mpSpriteListCollision;
+	mpSpriteListSprite=NULL;
+	mpSpriteListLine=NULL;
+	mpSpriteListSpan=NULL;
+	mpSpriteListPending=NULL;
+	mpSpriteListCollision=NULL;
+
+	mThreads=1;
+}
+
+void CSusie::BandEntry(void *object,ULONG band)
+{
+	CSusie *list=(CSusie*)object;
+	list->mpBand[band]->SpriteListBand(*list,band);
+}
+#endif
+
 
 void CSusie::Poke(ULONG addr,UBYTE data)
 {
@@ -45,6 +45,10 @@
 #ifndef SUSIE_H
 #define SUSIE_H
 
+#ifdef HANDY_SPRITE_THREADS
+#include "BandPool.h"
+#endif
+
 #ifdef TRACE_SUSIE
 
 #define TRACE_SUSIE0(msg)					_RPT1(_CRT_WARN,"CSusie::"msg" (Time=%012d)\n",gSystemCycleCount)
@@ -71,6 +75,21 @@ class CSystem;
 
 #define LINE_END		0x80
 
+// A line holds at most 254 bytes of data, every pixel run after the first
+// 16 costs at least one bit of it
+#define LINE_MAX_RUNS	2048
+
+// Marks a pixel in the line spans as written
+#define LINE_SPAN_SET	0x10
+
+// Most bands the screen is cut into, one thread each
+#define SPRITE_MAX_THREADS	8
+
+// Sprites, lines and spans the display list holds before it's drawn
+#define SPRITE_LIST_SPRITES	1024
+#define SPRITE_LIST_LINES	8192
+#define SPRITE_LIST_SPANS	65536
+
 //
 // Define button values
 //
@@ -86,6 +105,39 @@ class CSystem;
 #define BUTTON_PAUSE	0x0100
 
 
+#ifdef HANDY_SPRITE_THREADS
+//
+// The display list keeps what each sprite line draws, the collision
+// depositary of each sprite is written once the list has been drawn
+//
+typedef struct
+{
+	UBYTE	type;
+	UBYTE	collide;
+	UBYTE	number;
+	UBYTE	collision;		// From before the list was last drawn
+	UBYTE	closed;
+	UBYTE	deposit;
+	UBYTE	everonscreen;
+	UWORD	depositary;
+}TSPRITELISTSPRITE;
+
+typedef struct
+{
+	UWORD	sprite;
+	UBYTE	voff;
+	UBYTE	spans;
+	ULONG	span;
+}TSPRITELISTLINE;
+
+typedef struct
+{
+	UBYTE	left;
+	UBYTE	right;
+	UBYTE	pen;
+}TSPRITELISTSPAN;
+#endif
+
 enum {line_error=0,line_abs_literal,line_literal,line_packed};
 enum {math_finished=0,math_divide,math_multiply,math_init_divide,math_init_multiply};
 
@@ -351,18 +403,79 @@ class CSusie : public CLynxBase
 
 		ULONG	PaintSprites(void);
 
+		//
+		// With HANDY_SPRITE_THREADS the sprite lines are kept in a display
+		// list while the SCBs are walked and the screen is cut into bands
+		// that are drawn by that many threads. The RAM and cycles come out
+		// the same as drawing them in turn.
+		//
+		void	SetThreads(ULONG threads);
+		ULONG	GetThreads(void) { return mThreads; };
+
 	private:
 		void	DoMathDivide(void);
 		void	DoMathMultiply(void);
 		ULONG	LineInit(ULONG voff);
-		ULONG	LineGetPixel(void);
 		ULONG	LineGetBits(ULONG bits);
-
-		void	ProcessPixel(ULONG hoff,ULONG pixel);
-		void	WritePixel(ULONG hoff,ULONG pixel);
+		template<int Bits,int Literal> ULONG LineGetPixel(void);
+		template<int Bits,int Literal> void LineDecode(void);
+
+		//
+		// Each destination line of a sprite is drawn by an instance of
+		// SpriteLine() for the sprite type, bits per pixel, literal or
+		// packed data, collision and drawing direction, so there is no
+		// switching per pixel. SpriteSelectLine() looks up the instances
+		// for the two directions once per SCB. Returns TRUE if any pixel
+		// of the line was on screen.
+		//
+		// Unless the collision buffer line shares bytes with the screen
+		// line each run of pens is drawn as a span by ProcessSpan(), the
+		// writes go to the line spans and LineCommit() writes out whole
+		// bytes at the end of the line.
+		//
+		// Unscaled literal lines without collision are copied straight to
+		// the screen a byte at a time by SpriteBlit().
+		//
+		// A line that draws over its own data has to see the pixels it has
+		// already drawn, SpriteFields() reads it a field at a time as each
+		// pixel is drawn.
+		//
+		typedef ULONG (CSusie::*TSpriteLine)(int hoff);
+
+		template<int Type,int Bits,int Literal,int Collide,int Hsign> ULONG SpriteLine(int hoff);
+		template<int Type,int Bits,int Literal,int Collide,int Hsign> ULONG SpriteFields(int hoff);
+		template<int Collide> bool LineOverwritesData(void);
+		template<int Type,int Collide,int Hsign,int Span> ULONG SpriteDraw(int hoff);
+		template<int Type,int Bits,int Hsign> ULONG SpriteBlit(int hoff);
+		bool	SpriteBlitAllowed(void);
+		const TSpriteLine* SpriteSelectLine(void);
+		void	LineCommit(int left,int right);
+		ULONG	LineRunWidth(ULONG length);
+
+		template<int Type,int Collide> void ProcessPixel(ULONG hoff,ULONG pixel);
+		template<int Type,int Collide> void ProcessSpan(int left,int right,ULONG pixel);
+		template<int Span> void WritePixel(ULONG hoff,ULONG pixel);
 		ULONG	ReadPixel(ULONG hoff);
 		void	WriteCollision(ULONG hoff,ULONG pixel);
 		ULONG	ReadCollision(ULONG hoff);
+		ULONG	ReadCollisionSpan(int left,int right);
+		void	WriteDepositary(ULONG type,ULONG collide,UWORD coldep,int everonscreen);
+
+#ifdef HANDY_SPRITE_THREADS
+		typedef void (CSusie::*TSpriteListDraw)(const CSusie &list,const TSPRITELISTLINE &line);
+
+		template<int Type,int Collide,int Hsign> ULONG SpriteRecord(int hoff);
+		template<int Type,int Collide> void SpriteListDraw(const CSusie &list,const TSPRITELISTLINE &line);
+		bool	SpriteListUsable(void);
+		void	SpriteListOpen(void);
+		void	SpriteListClose(int everonscreen);
+		void	SpriteListCheck(ULONG addr,ULONG length);
+		void	SpriteListFlush(void);
+		void	SpriteListBand(const CSusie &list,ULONG band);
+		void	StopThreads(void);
+
+		static void	BandEntry(void *object,ULONG band);
+#endif
 
 	private:
 		CSystem&	mSystem;
@@ -447,7 +560,23 @@ class CSusie : public CLynxBase
 		ULONG		mLinePixel;
 		ULONG		mLinePacketBitsLeft;
 
+		// Pixel runs of the current line, filled by LineDecode()
+		UBYTE		mLineRunPen[LINE_MAX_RUNS];
+		UWORD		mLineRunLength[LINE_MAX_RUNS];
+		ULONG		mLineRuns;
+
+		// Pixels written to the current line, LINE_SPAN_SET and the pen
+		ULONG		mLineSpan;
+		UBYTE		mLineSpanPen[SCREEN_WIDTH];
+		UBYTE		mLineSpanCollision[SCREEN_WIDTH];
+
 		int			mCollision;
+		ULONG		mCyclesUsed;
+
+		// Drawing direction of the first quad, kept from one sprite to the
+		// next when that quad isn't rendered
+		int			mVQuadOff;
+		int			mHQuadOff;
 
 		UBYTE		*mRamPointer;
 
@@ -458,7 +587,39 @@ class CSusie : public CLynxBase
 
 		TJOYSTICK	mJOYSTICK;
 		TSWITCHES	mSWITCHES;
+
+		ULONG		mThreads;
+
+#ifdef HANDY_SPRITE_THREADS
+		// The display list, only allocated with more than one thread
+		ULONG		mSpriteListActive;
+		TSPRITELISTSPRITE	*mpSpriteListSprite;
+		TSPRITELISTLINE		*mpSpriteListLine;
+		TSPRITELISTSPAN		*mpSpriteListSpan;
+		ULONG		mSpriteListSprites;
+		ULONG		mSpriteListLines;
+		ULONG		mSpriteListSpans;
+
+		// One bit for each address a depositary in the list will write
+		UBYTE		*mpSpriteListPending;
+		ULONG		mSpriteListPendings;
+
+		// Highest collision of each sprite in the list, a row per band
+		UBYTE		*mpSpriteListCollision;
+
+		// Each band is drawn by a Susie of its own so the line state and
+		// cycle count aren't shared
+		CSusie		*mpBand[SPRITE_MAX_THREADS];
+		CBandPool	mPool;
+
+#ifdef HANDY_BLOCK_CACHE
+		// The pages of RAM a band has written, the CPU's block cache can
+		// only be told on the main thread
+		bool		mBand;
+		UBYTE		mBandCodeWrites[256];
+#endif
+#endif
 };
 
-#endif
-
+#endif
+
@@ -72,6 +72,17 @@ int lss_read(void* dest,int varsize, int varcount,LSS_FILE *fp)
 	return copysize;
 }
 
+int lss_read_cycle(UCYCLE *dest,LSS_FILE *fp)
+{
+	// Snapshots from before LSS4 hold their cycle counts in a ULONG
+	if(fp->cycle_size==sizeof(UCYCLE)) return lss_read(dest,sizeof(UCYCLE),1,fp);
+
+	ULONG cycle=0;
+	int copysize=lss_read(&cycle,fp->cycle_size,1,fp);
+	*dest=cycle;
+	return copysize;
+}
+
 CSystem::CSystem(char* gamefile,char* romfile)
 	:mCart(NULL),
 	mRom(NULL),
@@ -267,7 +278,7 @@ CSystem::CSystem(char* gamefile,char* romfile)
 		}
 	}
 	
-	mCycleCountBreakpoint=0xffffffff;
+	mCycleCountBreakpoint=HANDY_CYCLE_NEVER;
 
 // Create the system objects that we'll use
 
@@ -436,9 +447,7 @@ void CSystem::Reset(void)
 
 	gTimerCount=0;
 
-	gAudioBufferPointer=0;
 	gAudioLastUpdateCycle=0;
-	memset(gAudioBuffer,128,HANDY_AUDIO_BUFFER_SIZE);
 
 #ifdef _LYNXDBG
 	gSystemHalt=TRUE;
@@ -494,12 +503,12 @@ bool CSystem::ContextSave(FILE *fp)
 
 	if(!fprintf(fp,"CSystem::ContextSave")) status=0;
 
-	if(!fwrite(&mCycleCountBreakpoint,sizeof(ULONG),1,fp)) status=0;
-	if(!fwrite(&gSystemCycleCount,sizeof(ULONG),1,fp)) status=0;
-	if(!fwrite(&gNextTimerEvent,sizeof(ULONG),1,fp)) status=0;
-	if(!fwrite(&gCPUWakeupTime,sizeof(ULONG),1,fp)) status=0;
+	if(!fwrite(&mCycleCountBreakpoint,sizeof(UCYCLE),1,fp)) status=0;
+	if(!fwrite(&gSystemCycleCount,sizeof(UCYCLE),1,fp)) status=0;
+	if(!fwrite(&gNextTimerEvent,sizeof(UCYCLE),1,fp)) status=0;
+	if(!fwrite(&gCPUWakeupTime,sizeof(UCYCLE),1,fp)) status=0;
 	if(!fwrite(&gCPUBootAddress,sizeof(ULONG),1,fp)) status=0;
-	if(!fwrite(&gIRQEntryCycle,sizeof(ULONG),1,fp)) status=0;
+	if(!fwrite(&gIRQEntryCycle,sizeof(UCYCLE),1,fp)) status=0;
 	if(!fwrite(&gBreakpointHit,sizeof(ULONG),1,fp)) status=0;
 	if(!fwrite(&gSingleStepMode,sizeof(ULONG),1,fp)) status=0;
 	if(!fwrite(&gSystemIRQ,sizeof(ULONG),1,fp)) status=0;
@@ -509,14 +518,19 @@ bool CSystem::ContextSave(FILE *fp)
 	if(!fwrite(&gSystemHalt,sizeof(ULONG),1,fp)) status=0;
 	if(!fwrite(&gThrottleMaxPercentage,sizeof(ULONG),1,fp)) status=0;
 	if(!fwrite(&gThrottleLastTimerCount,sizeof(ULONG),1,fp)) status=0;
-	if(!fwrite(&gThrottleNextCycleCheckpoint,sizeof(ULONG),1,fp)) status=0;
+	if(!fwrite(&gThrottleNextCycleCheckpoint,sizeof(UCYCLE),1,fp)) status=0;
 
 	ULONG tmp=gTimerCount;
 	if(!fwrite(&tmp,sizeof(ULONG),1,fp)) status=0;
 
-	if(!fwrite(gAudioBuffer,sizeof(UBYTE),HANDY_AUDIO_BUFFER_SIZE,fp)) status=0;
-	if(!fwrite(&gAudioBufferPointer,sizeof(ULONG),1,fp)) status=0;
-	if(!fwrite(&gAudioLastUpdateCycle,sizeof(ULONG),1,fp)) status=0;
+	// Queued samples belong to the host rather than the Lynx, the space
+	// they used to take is kept so the layout doesn't change
+	UBYTE audio[HANDY_AUDIO_LEGACY_QUEUE];
+	memset(audio,0,sizeof(audio));
+	tmp=0;
+	if(!fwrite(audio,sizeof(UBYTE),HANDY_AUDIO_LEGACY_QUEUE,fp)) status=0;
+	if(!fwrite(&tmp,sizeof(ULONG),1,fp)) status=0;
+	if(!fwrite(&gAudioLastUpdateCycle,sizeof(UCYCLE),1,fp)) status=0;
 
 	// Save other device contexts
 	if(!mMemMap->ContextSave(fp)) status=0;
@@ -707,15 +721,19 @@ bool CSystem::ContextLoad(UBYTE *filememory, ULONG filesize)
   fp->memptr=filememory;
   fp->index=0;
   fp->index_limit=filesize;
+  fp->cycle_size=sizeof(UCYCLE);
 
   char teststr[100];
   // Check identifier
   if(!lss_read(teststr,sizeof(char),4,fp)) status=0;
   teststr[4]=0;
 
-  if(strcmp(teststr,LSS_VERSION)==0 || strcmp(teststr,LSS_VERSION_OLD)==0)
+  if(strcmp(teststr,LSS_VERSION)==0 || strcmp(teststr,LSS_VERSION_32)==0 || strcmp(teststr,LSS_VERSION_OLD)==0)
   {
     bool legacy=FALSE;
+    // Older snapshots were taken with a 32 bit cycle counter, we just widen
+    // their counts as they were kept clear of the wrap when they were saved
+    if(strcmp(teststr,LSS_VERSION)!=0) fp->cycle_size=sizeof(ULONG);
     if(strcmp(teststr,LSS_VERSION_OLD)==0)
     {
       legacy=TRUE;
@@ -739,12 +757,13 @@ bool CSystem::ContextLoad(UBYTE *filememory, ULONG filesize)
     teststr[20]=0;
     if(strcmp(teststr,"CSystem::ContextSave")!=0) status=0;
 
-    if(!lss_read(&mCycleCountBreakpoint,sizeof(ULONG),1,fp)) status=0;
-    if(!lss_read(&gSystemCycleCount,sizeof(ULONG),1,fp)) status=0;
-    if(!lss_read(&gNextTimerEvent,sizeof(ULONG),1,fp)) status=0;
-    if(!lss_read(&gCPUWakeupTime,sizeof(ULONG),1,fp)) status=0;
+    if(!lss_read_cycle(&mCycleCountBreakpoint,fp)) status=0;
+    if(fp->cycle_size!=sizeof(UCYCLE) && mCycleCountBreakpoint==0xffffffff) mCycleCountBreakpoint=HANDY_CYCLE_NEVER;
+    if(!lss_read_cycle(&gSystemCycleCount,fp)) status=0;
+    if(!lss_read_cycle(&gNextTimerEvent,fp)) status=0;
+    if(!lss_read_cycle(&gCPUWakeupTime,fp)) status=0;
     if(!lss_read(&gCPUBootAddress,sizeof(ULONG),1,fp)) status=0;
-    if(!lss_read(&gIRQEntryCycle,sizeof(ULONG),1,fp)) status=0;
+    if(!lss_read_cycle(&gIRQEntryCycle,fp)) status=0;
     if(!lss_read(&gBreakpointHit,sizeof(ULONG),1,fp)) status=0;
     if(!lss_read(&gSingleStepMode,sizeof(ULONG),1,fp)) status=0;
     if(!lss_read(&gSystemIRQ,sizeof(ULONG),1,fp)) status=0;
@@ -754,15 +773,17 @@ bool CSystem::ContextLoad(UBYTE *filememory, ULONG filesize)
     if(!lss_read(&gSystemHalt,sizeof(ULONG),1,fp)) status=0;
     if(!lss_read(&gThrottleMaxPercentage,sizeof(ULONG),1,fp)) status=0;
     if(!lss_read(&gThrottleLastTimerCount,sizeof(ULONG),1,fp)) status=0;
-    if(!lss_read(&gThrottleNextCycleCheckpoint,sizeof(ULONG),1,fp)) status=0;
+    if(!lss_read_cycle(&gThrottleNextCycleCheckpoint,fp)) status=0;
 
     ULONG tmp;
     if(!lss_read(&tmp,sizeof(ULONG),1,fp)) status=0;
     gTimerCount=tmp;
 
-    if(!lss_read(gAudioBuffer,sizeof(UBYTE),HANDY_AUDIO_BUFFER_SIZE,fp)) status=0;
-    if(!lss_read(&gAudioBufferPointer,sizeof(ULONG),1,fp)) status=0;
-    if(!lss_read(&gAudioLastUpdateCycle,sizeof(ULONG),1,fp)) status=0;
+    // Skip the old sample queue, the host's queue just carries on
+    UBYTE audio[HANDY_AUDIO_LEGACY_QUEUE];
+    if(!lss_read(audio,sizeof(UBYTE),HANDY_AUDIO_LEGACY_QUEUE,fp)) status=0;
+    if(!lss_read(&tmp,sizeof(ULONG),1,fp)) status=0;
+    if(!lss_read_cycle(&gAudioLastUpdateCycle,fp)) status=0;
 
     if(!mMemMap->ContextLoad(fp)) status=0;
     // Legacy support
@@ -797,7 +818,7 @@ void CSystem::DebugTrace(int address)
 	char message[1024+1];
 	int count=0;
 
-	sprintf(message,"%08x - DebugTrace(): ",gSystemCycleCount);
+	sprintf(message,"%08x - DebugTrace(): ",(ULONG)gSystemCycleCount);
 	count=strlen(message);
 
 	if(address)
@@ -63,23 +63,34 @@
 
 #include "Machine.h"
 
+// Default host sample rate, it can be changed at run time
 #ifndef HANDY_AUDIO_SAMPLE_FREQ
-#define HANDY_AUDIO_SAMPLE_FREQ         22050
+#define HANDY_AUDIO_SAMPLE_FREQ         44100
 #endif
 
 #define HANDY_SYSTEM_FREQ						16000000
 #define HANDY_TIMER_FREQ						20
-#define HANDY_AUDIO_SAMPLE_PERIOD				(HANDY_SYSTEM_FREQ/HANDY_AUDIO_SAMPLE_FREQ)
 #define HANDY_AUDIO_WAVESHAPER_TABLE_LENGTH		0x200000
 
+// Size of the sample queue in stereo samples, each a left and right SWORD,
+// this must be a power of two
 #ifndef HANDY_AUDIO_BUFFER_SIZE
 #ifdef LINUX_PATCH
 #define HANDY_AUDIO_BUFFER_SIZE					4096	// Needed forSDL
 #else // LINUX_PATCH
-#define HANDY_AUDIO_BUFFER_SIZE					(HANDY_AUDIO_SAMPLE_FREQ/4)
+#define HANDY_AUDIO_BUFFER_SIZE					8192
 #endif // else LINUX_PATCH
 #endif // HANDY_AUDIO_BUFFER_SIZE
 
+// Snapshots keep the space the old 8 bit sample queue took whatever size
+// the ring is, it was 4096 bytes in the SDL and PSP builds and a quarter
+// second at 22050Hz in the rest
+#if defined(LINUX_PATCH) || defined(PSP)
+#define HANDY_AUDIO_LEGACY_QUEUE				4096
+#else
+#define HANDY_AUDIO_LEGACY_QUEUE				(22050/4)
+#endif
+
 #ifndef __min
 #define __min(x, y) (((x) < (y)) ? (x) : (y))
 #endif
@@ -95,15 +106,23 @@
 
 #define HANDY_SCREEN_WIDTH	160
 #define HANDY_SCREEN_HEIGHT	102
+
+// Longest RunFrame() will go without seeing a frame end, covers the
+// slowest frame rate with plenty to spare for when the display is off
+#define HANDY_FRAME_CYCLE_LIMIT	(HANDY_SYSTEM_FREQ/25)
+// A cycle we will never reach, for an empty event queue or no breakpoint
+#define HANDY_CYCLE_NEVER		(~(UCYCLE)0)
+#include "AudioRing.h"
+
 //
 // Define the global variable list
 //
 
 #ifdef SYSTEM_CPP
-	ULONG	gSystemCycleCount=0;
-	ULONG	gNextTimerEvent=0;
-	ULONG	gCPUWakeupTime=0;
-	ULONG	gIRQEntryCycle=0;
+	UCYCLE	gSystemCycleCount=0;
+	UCYCLE	gNextTimerEvent=0;
+	UCYCLE	gCPUWakeupTime=0;
+	UCYCLE	gIRQEntryCycle=0;
 	ULONG	gCPUBootAddress=0;
 	ULONG	gBreakpointHit=FALSE;
 	ULONG	gSingleStepMode=FALSE;
@@ -113,24 +132,24 @@
 	ULONG	gSystemCPUSleep=FALSE;
 	ULONG	gSystemCPUSleep_Saved=FALSE;
 	ULONG	gSystemHalt=FALSE;
+	ULONG	gEndOfFrame=FALSE;
 	ULONG	gThrottleMaxPercentage=100;
 	ULONG	gThrottleLastTimerCount=0;
-	ULONG	gThrottleNextCycleCheckpoint=0;
+	UCYCLE	gThrottleNextCycleCheckpoint=0;
 
 	volatile ULONG gTimerCount=0;
 
 	ULONG	gAudioEnabled=FALSE;
-	UBYTE	gAudioBuffer[HANDY_AUDIO_BUFFER_SIZE];
-	ULONG	gAudioBufferPointer=0;
-	ULONG	gAudioLastUpdateCycle=0;
+	CAudioRing	gAudioRing;
+	UCYCLE	gAudioLastUpdateCycle=0;
 
 	CErrorInterface *gError=NULL;
 #else
 
-	extern ULONG	gSystemCycleCount;
-	extern ULONG	gNextTimerEvent;
-	extern ULONG	gCPUWakeupTime;
-	extern ULONG	gIRQEntryCycle;
+	extern UCYCLE	gSystemCycleCount;
+	extern UCYCLE	gNextTimerEvent;
+	extern UCYCLE	gCPUWakeupTime;
+	extern UCYCLE	gIRQEntryCycle;
 	extern ULONG	gCPUBootAddress;
 	extern ULONG	gBreakpointHit;
 	extern ULONG	gSingleStepMode;
@@ -140,16 +159,16 @@
 	extern ULONG	gSystemCPUSleep;
 	extern ULONG	gSystemCPUSleep_Saved;
 	extern ULONG	gSystemHalt;
+	extern ULONG	gEndOfFrame;
 	extern ULONG	gThrottleMaxPercentage;
 	extern ULONG	gThrottleLastTimerCount;
-	extern ULONG	gThrottleNextCycleCheckpoint;
+	extern UCYCLE	gThrottleNextCycleCheckpoint;
 
 	extern volatile ULONG gTimerCount;
 
 	extern ULONG	gAudioEnabled;
-	extern UBYTE	gAudioBuffer[HANDY_AUDIO_BUFFER_SIZE];
-	extern ULONG	gAudioBufferPointer;
-	extern ULONG	gAudioLastUpdateCycle;
+	extern CAudioRing	gAudioRing;
+	extern UCYCLE	gAudioLastUpdateCycle;
 
 	extern CErrorInterface *gError;
 #endif
@@ -159,9 +178,11 @@ typedef struct lssfile
 	UBYTE *memptr;
 	ULONG index;
 	ULONG index_limit;
+	ULONG cycle_size;
 } LSS_FILE;
 
 int lss_read(void* dest,int varsize, int varcount,LSS_FILE *fp);
+int lss_read_cycle(UCYCLE *dest,LSS_FILE *fp);
 
 //
 // Define the interfaces before we start pulling in the classes
@@ -182,6 +203,7 @@ class CSystem;
 #include "Memmap.h"
 #include "Cart.h"
 #include "Susie.h"
+#include "Blip.h"
 #include "Mikie.h"
 #include "C65c02.h"
 
@@ -190,8 +212,27 @@ class CSystem;
 #define TOP_SIZE	0x400
 #define SYSTEM_SIZE	65536
 
+//
+// CPU memory dispatch is by 256 byte page, the last page is split between
+// ROM, RAM, the memory map register and the vectors so it has a per byte
+// table of its own
+//
+
+#define SYSTEM_PAGES		256
+#define SYSTEM_PAGE_SHIFT	8
+#define SYSTEM_PAGE_MASK	0xff
+#define SYSTEM_LAST_PAGE	0xff
+
+#define HANDLER_RAM		0
+#define HANDLER_SUSIE	1
+#define HANDLER_MIKIE	2
+#define HANDLER_ROM		3
+#define HANDLER_MEMMAP	4
+#define HANDLER_SPLIT	5
+
 #define LSS_VERSION_OLD	"LSS2"
-#define LSS_VERSION	"LSS3"
+#define LSS_VERSION_32	"LSS3"
+#define LSS_VERSION	"LSS4"
 
 class CSystem : public CSystemBase
 {
@@ -202,31 +243,26 @@ class CSystem : public CSystemBase
   private:
     bool  ContextLoad(UBYTE *filememory, ULONG filesize);
 
-	public:
-		void	Reset(void);
-		bool	ContextSave(char *context);
-    bool  ContextSave(FILE *fp);
-		bool	ContextLoad(char *context);
-    bool  ContextLoad(FILE *fp);
-		bool	IsZip(char *filename);
-
-		inline void Update(void)
+		//
+		// One step of the system, shared by Update() and RunCycles()
+		//
+		inline void Step(C65C02 *cpu,CMikie *mikie)
 		{
 			// 
 			// Only update if there is a predicted timer event
 			//
 			if(gSystemCycleCount>=gNextTimerEvent)
 			{
-				mMikie->Update();
+				mikie->Update();
 			}
 			//
 			// Step the processor through 1 instruction
 			//
-			mCpu->Update();
+			cpu->Update();
 
 #ifdef _LYNXDBG
 			// Check breakpoint
-			static ULONG lastcycle=0;
+			static UCYCLE lastcycle=0;
 			if(lastcycle<mCycleCountBreakpoint && gSystemCycleCount>=mCycleCountBreakpoint) gBreakpointHit=TRUE;
 			lastcycle=gSystemCycleCount;
 
@@ -243,6 +279,57 @@ class CSystem : public CSystemBase
 			}
 		}
 
+	public:
+		void	Reset(void);
+		bool	ContextSave(char *context);
+    bool  ContextSave(FILE *fp);
+		bool	ContextLoad(char *context);
+    bool  ContextLoad(FILE *fp);
+		bool	IsZip(char *filename);
+
+		inline void Update(void)
+		{
+			Step(mCpu,mMikie);
+		}
+
+		//
+		// Run for a cycle budget, this is the same sequence of Mikie and CPU
+		// steps as calling Update() but without returning to the caller for
+		// each instruction. Returns TRUE if it stopped at the end of a frame,
+		// which is at the end of the step in which Mikie called the display
+		// callback so that the next call carries on exactly where Update()
+		// would have.
+		//
+		// What it buys is the frame exact return, not speed. The cycle count
+		// and next event time stay in their globals for the slice as every
+		// instruction moves the count and any Mikie register access can bring
+		// the next event forward, so a local copy would be stale by the next
+		// step.
+		//
+		inline bool RunCycles(ULONG cycles)
+		{
+			C65C02 *cpu=mCpu;
+			CMikie *mikie=mMikie;
+			UCYCLE start=gSystemCycleCount;
+
+			gEndOfFrame=FALSE;
+			do
+			{
+				Step(cpu,mikie);
+#ifdef _LYNXDBG
+				if(gBreakpointHit) break;
+#endif
+			}
+			while(!gEndOfFrame && (gSystemCycleCount-start)<cycles);
+
+			return gEndOfFrame;
+		}
+
+		//
+		// Run until the end of the current frame
+		//
+		inline bool RunFrame(void) { return RunCycles(HANDY_FRAME_CYCLE_LIMIT); };
+
 		//
 		// We MUST have separate CPU & RAM peek & poke handlers as all CPU accesses must
 		// go thru the address generator at $FFF9
@@ -256,17 +343,57 @@ class CSystem : public CSystemBase
 		//
 		// CPU
 		//
-		inline void  Poke_CPU(ULONG addr, UBYTE data) { mMemoryHandlers[addr]->Poke(addr,data);};
-		inline UBYTE Peek_CPU(ULONG addr) { return mMemoryHandlers[addr]->Peek(addr);};
-		inline void  PokeW_CPU(ULONG addr,UWORD data) { mMemoryHandlers[addr]->Poke(addr,data&0xff);addr++;mMemoryHandlers[addr]->Poke(addr,data>>8);};
-		inline UWORD PeekW_CPU(ULONG addr) {return ((mMemoryHandlers[addr]->Peek(addr))+(mMemoryHandlers[addr]->Peek(addr+1)<<8));};
+		inline ULONG Handler_CPU(ULONG addr)
+		{
+			ULONG handler=mMemoryPages[addr>>SYSTEM_PAGE_SHIFT];
+			return (handler==HANDLER_SPLIT)?mLastPageHandlers[addr&SYSTEM_PAGE_MASK]:handler;
+		}
+
+		// The handlers are called by class so the compiler can bind them
+		// directly rather than through the vtable
+		inline void Poke_Handler(ULONG handler,ULONG addr,UBYTE data)
+		{
+			switch(handler)
+			{
+				case HANDLER_SUSIE:		mSusie->CSusie::Poke(addr,data); break;
+				case HANDLER_MIKIE:		mMikie->CMikie::Poke(addr,data); break;
+				case HANDLER_ROM:		mRom->CRom::Poke(addr,data); break;
+				case HANDLER_MEMMAP:	mMemMap->CMemMap::Poke(addr,data); break;
+				default:				mRam->CRam::Poke(addr,data); break;
+			}
+		}
+
+		inline UBYTE Peek_Handler(ULONG handler,ULONG addr)
+		{
+			switch(handler)
+			{
+				case HANDLER_SUSIE:		return mSusie->CSusie::Peek(addr);
+				case HANDLER_MIKIE:		return mMikie->CMikie::Peek(addr);
+				case HANDLER_ROM:		return mRom->CRom::Peek(addr);
+				case HANDLER_MEMMAP:	return mMemMap->CMemMap::Peek(addr);
+				default:				return mRam->CRam::Peek(addr);
+			}
+		}
+
+		inline void  Poke_CPU(ULONG addr, UBYTE data) { Poke_Handler(Handler_CPU(addr),addr,data);};
+		inline UBYTE Peek_CPU(ULONG addr) { return Peek_Handler(Handler_CPU(addr),addr);};
+		inline void  PokeW_CPU(ULONG addr,UWORD data) { Poke_Handler(Handler_CPU(addr),addr,data&0xff);addr++;Poke_Handler(Handler_CPU(addr),addr,data>>8);};
+		inline UWORD PeekW_CPU(ULONG addr) {ULONG handler=Handler_CPU(addr); return (Peek_Handler(handler,addr)+(Peek_Handler(handler,addr+1)<<8));};
 
 		//
 		// RAM
 		//
+#ifdef HANDY_BLOCK_CACHE
+		inline void  Poke_RAM(ULONG addr, UBYTE data) { mRam->Poke(addr,data);mCpu->CodeWrite(addr);};
+#else
 		inline void  Poke_RAM(ULONG addr, UBYTE data) { mRam->Poke(addr,data);};
+#endif
 		inline UBYTE Peek_RAM(ULONG addr) { return mRam->Peek(addr);};
+#ifdef HANDY_BLOCK_CACHE
+		inline void  PokeW_RAM(ULONG addr,UWORD data) { mRam->Poke(addr,data&0xff);mCpu->CodeWrite(addr);addr++;mRam->Poke(addr,data>>8);mCpu->CodeWrite(addr);};
+#else
 		inline void  PokeW_RAM(ULONG addr,UWORD data) { mRam->Poke(addr,data&0xff);addr++;mRam->Poke(addr,data>>8);};
+#endif
 		inline UWORD PeekW_RAM(ULONG addr) {return ((mRam->Peek(addr))+(mRam->Peek(addr+1)<<8));};
 
 // High level cart access for debug etc
@@ -297,6 +424,15 @@ class CSystem : public CSystemBase
 
     void  DisplaySetAttributes(ULONG Rotate,ULONG Format,ULONG Pitch,UBYTE* (*DisplayCallback)(ULONG objref),ULONG objref) { mMikie->DisplaySetAttributes(Rotate,Format,Pitch,DisplayCallback,objref); };
     ULONG DisplayGetRotation() { return mMikie->DisplayGetRotation(); }
+		void	DisplaySetDeferred(ULONG deferred) { mMikie->DisplaySetDeferred(deferred); };
+		ULONG	DisplayGetFramePalette(ULONG *palette) { return mMikie->DisplayGetFramePalette(palette); };
+		void	DisplaySetLineTracking(ULONG track) { mMikie->DisplaySetLineTracking(track); };
+		void	DisplaySetHeadless(ULONG headless) { mMikie->DisplaySetHeadless(headless); };
+		void	DisplaySetScale(ULONG scale) { mMikie->DisplaySetScale(scale); };
+		void	DisplayRenderFrame(UBYTE *bits) { mMikie->DisplayRenderFrame(bits); };
+		ULONG	DisplayGetDirtyLines(UBYTE *dirty) { return mMikie->DisplayGetDirtyLines(dirty); };
+		void	AudioSetSampleFreq(ULONG freq) { mMikie->AudioSetSampleFreq(freq); };
+		ULONG	AudioGetSampleFreq(void) { return mMikie->AudioGetSampleFreq(); };
 
 		void	ComLynxCable(int status) { mMikie->ComLynxCable(status); };
 		void	ComLynxRxData(int data)  { mMikie->ComLynxRxData(data); };
@@ -305,12 +441,14 @@ class CSystem : public CSystemBase
 // Suzy system interfacing
 
 		ULONG	PaintSprites(void) {return mSusie->PaintSprites();};
+		void	SetSpriteThreads(ULONG threads) { mSusie->SetThreads(threads); };
+		ULONG	GetSpriteThreads(void) { return mSusie->GetThreads(); };
 
 // Miscellaneous
 
 		void	SetButtonData(ULONG data) {mSusie->SetButtonData(data);};
 		ULONG	GetButtonData(void) {return mSusie->GetButtonData();};
-		void	SetCycleBreakpoint(ULONG breakpoint) {mCycleCountBreakpoint=breakpoint;};
+		void	SetCycleBreakpoint(UCYCLE breakpoint) {mCycleCountBreakpoint=breakpoint;};
 		UBYTE*	GetRamPointer(void) {return mRam->GetRamPointer();};
 #ifdef _LYNXDBG
 		void	DebugTrace(int address);
@@ -322,8 +460,9 @@ class CSystem : public CSystemBase
 #endif
 
 	public:
-		ULONG			mCycleCountBreakpoint;
-		CLynxBase		*mMemoryHandlers[SYSTEM_SIZE];
+		UCYCLE			mCycleCountBreakpoint;
+		UBYTE			mMemoryPages[SYSTEM_PAGES];
+		UBYTE			mLastPageHandlers[SYSTEM_PAGES];
 		CCart			*mCart;
 		CRom			*mRom;
 		CMemMap			*mMemMap;
@@ -274,8 +274,7 @@ void RunEmulation()
   /* Main emulation loop */
 	while (!ExitPSP)
 	{
-		for (ULONG loop = 1024; loop; loop--)
-			LynxSystem->Update();
+		LynxSystem->RunFrame();
 
     if (ParseInput()) break;
 	}
@@ -288,28 +287,12 @@ void RunEmulation()
 // inline?
 void AudioCallback(void *buffer, unsigned int *length, void *userdata)
 {
-  PspMonoSample *OutBuf = (PspMonoSample*)buffer;
-  int i;
-  int len = *length >> 1;
-
-  if(((int)gAudioBufferPointer >= len)
-    && (gAudioBufferPointer != 0) && (!gSystemHalt) )
-  {
-    for (i = 0; i < len; i++)
-    {
-      short sample = (short)(((int)gAudioBuffer[i] << 8) - 32768);
-      (OutBuf++)->Channel = sample;
-      (OutBuf++)->Channel = sample;
-    }
-    gAudioBufferPointer = 0;
-  }
-  else
-  {
-    *length = 64;
-    for (i = 0; i < (int)*length; i+=2)
-    {
-      (OutBuf++)->Channel = 0;
-      (OutBuf++)->Channel = 0;
-    }
-  }
+  PspStereoSample *OutBuf = (PspStereoSample*)buffer;
+  unsigned int len = *length;
+  unsigned int got = 0;
+
+  /* Take what's queued and pad any shortfall with silence */
+  if (!gSystemHalt)
+    got = gAudioRing.Read((SWORD*)OutBuf, len);
+  memset(OutBuf + got, 0, (len - got) * sizeof(PspStereoSample));
 }
@@ -0,0 +1,173 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Audio sample queue test                                                  //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Runs CAudioRing the way the emulator does, one thread queueing samples   //
+// and another taking them, with odd sized blocks at both ends so the       //
+// copies keep landing across the end of the buffer.                        //
+//                                                                          //
+// Each stereo sample carries a running count on the left and its           //
+// complement on the right. Whatever the producer has queued must come out  //
+// the other end complete and in order, nothing dropped by an overrun may   //
+// show up, and the overrun and underrun counts must match the short writes //
+// and reads each side saw. Build with "make tsan" to run it under the      //
+// thread sanitizer.                                                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "Machine.h"
+#include "AudioRing.h"
+
+#define TEST_SAMPLES	(8*1024*1024)
+#define TEST_BLOCK		(AUDIO_RING_SIZE/3+7)
+
+static CAudioRing ring;
+
+static ULONG writes_short=0;
+static ULONG reads_short=0;
+static ULONG samples_written=0;
+static ULONG samples_read=0;
+static ULONG errors=0;
+static volatile ULONG producer_done=0;
+
+// Small per thread generator so both ends vary their block sizes
+static ULONG Random(ULONG &seed)
+{
+	seed=seed*1103515245+12345;
+	return (seed>>16)&0x7fff;
+}
+
+static void* Producer(void *)
+{
+	SWORD block[TEST_BLOCK*2];
+	ULONG seed=1;
+	ULONG sequence=0;
+
+	while(samples_written<TEST_SAMPLES)
+	{
+		ULONG count=Random(seed)%TEST_BLOCK+1;
+		for(ULONG loop=0;loop<count;loop++)
+		{
+			block[loop*2]=(SWORD)(sequence+loop);
+			block[loop*2+1]=(SWORD)~(sequence+loop);
+		}
+
+		ULONG queued=ring.Write(block,count);
+		if(queued<count) writes_short++;
+
+		// The dropped tail is never seen again, carry on from what went in
+		sequence+=queued;
+		samples_written+=queued;
+
+		if(!(Random(seed)&7)) sched_yield();
+	}
+
+	__atomic_store_n(&producer_done,1,__ATOMIC_RELEASE);
+	return NULL;
+}
+
+static void* Consumer(void *)
+{
+	SWORD block[TEST_BLOCK*2];
+	ULONG seed=2;
+	ULONG sequence=0;
+
+	for(;;)
+	{
+		// Sample the flag first so a final read after it drains everything
+		ULONG done=__atomic_load_n(&producer_done,__ATOMIC_ACQUIRE);
+
+		ULONG count=Random(seed)%TEST_BLOCK+1;
+		ULONG got=ring.Read(block,count);
+		if(got<count) reads_short++;
+
+		for(ULONG loop=0;loop<got;loop++)
+		{
+			if(block[loop*2]!=(SWORD)sequence || block[loop*2+1]!=(SWORD)~sequence)
+			{
+				if(errors<10) printf("Sample %lu read as %04x/%04x\n",sequence,(UWORD)block[loop*2],(UWORD)block[loop*2+1]);
+				errors++;
+			}
+			sequence++;
+		}
+		samples_read+=got;
+
+		if(done && !got) break;
+		if(!(Random(seed)&7)) sched_yield();
+	}
+	return NULL;
+}
+
+static int Check(const char *what,ULONG got,ULONG expected)
+{
+	if(got==expected) return 0;
+	printf("%s: got %lu expected %lu\n",what,got,expected);
+	return 1;
+}
+
+int main(void)
+{
+	int failed=0;
+	SWORD block[AUDIO_RING_SIZE*2+2];
+
+	// Single threaded edges first, a full ring takes no more and an empty one gives nothing
+	for(ULONG loop=0;loop<AUDIO_RING_SIZE+1;loop++) block[loop*2]=block[loop*2+1]=(SWORD)loop;
+	failed|=Check("Write to empty ring",ring.Write(block,AUDIO_RING_SIZE+1),AUDIO_RING_SIZE);
+	failed|=Check("Overruns after overfill",ring.Overruns(),1);
+	failed|=Check("Space when full",ring.Space(),0);
+	failed|=Check("Read from full ring",ring.Read(block,AUDIO_RING_SIZE+1),AUDIO_RING_SIZE);
+	failed|=Check("Underruns after overdrain",ring.Underruns(),1);
+	failed|=Check("Last sample read",(UWORD)block[(AUDIO_RING_SIZE-1)*2],AUDIO_RING_SIZE-1);
+	failed|=Check("Fill when empty",ring.Fill(),0);
+
+	ULONG overruns=ring.Overruns();
+	ULONG underruns=ring.Underruns();
+
+	pthread_t producer,consumer;
+	if(pthread_create(&consumer,NULL,Consumer,NULL) || pthread_create(&producer,NULL,Producer,NULL))
+	{
+		printf("Couldn't start the test threads\n");
+		return 1;
+	}
+	pthread_join(producer,NULL);
+	pthread_join(consumer,NULL);
+
+	failed|=Check("Samples out of order",errors,0);
+	failed|=Check("Samples read",samples_read,samples_written);
+	failed|=Check("Overruns",ring.Overruns()-overruns,writes_short);
+	failed|=Check("Underruns",ring.Underruns()-underruns,reads_short);
+
+	printf("%s: %lu samples, %lu overruns, %lu underruns\n",failed?"FAIL":"PASS",samples_read,writes_short,reads_short);
+	return failed;
+}
@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// 65C02 recompiler test                                                    //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Runs random 65C02 programs and prints a hash of the CPU state and RAM    //
+// taken at every timer event. The makefile builds it with the plain        //
+// interpreter and with the recompiler, the two must print the same hash    //
+// sequence. A third build runs the recompiler in lockstep so every native  //
+// block is checked against the interpreter as it goes, it must see no      //
+// differences.                                                             //
+//                                                                          //
+// The programs are loops of the opcodes the recompiler handles mixed with  //
+// decimal mode arithmetic, stack traffic, subroutine calls and I/O reads   //
+// that keep blocks with the interpreter. Every pass patches the immediate  //
+// operands of a routine it then calls so the self modifying code handling  //
+// is used, both while the routine is recompiled and once it is given up.   //
+//                                                                          //
+// The test writes its own blank boot ROM and an empty homebrew image to    //
+// load as the game.                                                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "System.h"
+
+static char rom_file[]="cpu_jit_test.rom";
+static char game_file[]="cpu_jit_test.o";
+
+#define TEST_PROGRAMS	4
+#define TEST_CYCLES		3000000
+#define TEST_REPORT		1024		// Timer events between printed hashes
+#define TEST_MAIN		0x0400
+#define TEST_MAIN_END	0x1000
+#define TEST_PATCHED	0x1800
+#define TEST_SUBS		0x2000
+#define TEST_COUNTER	0x2f00
+#define TEST_PASSES		0x2f01
+#define TEST_DATA		0x3000
+#define TEST_DATA_SIZE	0x200
+#define TEST_MAX_SITES	64
+#define TEST_MAX_SUBS	16
+#define TEST_HOT		16			// Runs before a block is recompiled
+
+static ULONG seed=1;
+
+static ULONG Random(ULONG range)
+{
+	seed^=(seed<<13)&0xffffffff;
+	seed^=seed>>17;
+	seed^=(seed<<5)&0xffffffff;
+	return range?seed%range:seed;
+}
+
+static ULONG Fnv(const UBYTE *data,ULONG size,ULONG hash)
+{
+	for(ULONG loop=0;loop<size;loop++) hash=((hash^data[loop])*16777619)&0xffffffff;
+	return hash;
+}
+
+//
+// Opcodes for the random mix by operand type, stack, flow, I/O and the
+// flag changes that would let interrupts in are generated separately
+//
+static const UBYTE immediate_ops[]={0x09,0x29,0x49,0x69,0x89,0xa0,0xa2,0xa9,0xc0,0xc9,0xe0,0xe9};
+static const UBYTE zeropage_ops[]={
+	0x04,0x05,0x06,0x14,0x24,0x25,0x26,0x45,0x46,0x64,0x65,0x66,0x84,0x85,0x86,0xa4,
+	0xa5,0xa6,0xc4,0xc5,0xc6,0xe4,0xe5,0xe6,0x15,0x16,0x34,0x35,0x36,0x55,0x56,0x74,
+	0x75,0x76,0x94,0x95,0x96,0xb4,0xb5,0xb6,0xd5,0xd6,0xf5,0xf6};
+static const UBYTE absolute_ops[]={
+	0x0c,0x0d,0x0e,0x1c,0x2c,0x2d,0x2e,0x4d,0x4e,0x6d,0x6e,0x8c,0x8d,0x8e,0x9c,0xac,
+	0xad,0xae,0xcc,0xcd,0xce,0xec,0xed,0xee};
+static const UBYTE indexed_ops[]={
+	0x19,0x1d,0x1e,0x39,0x3c,0x3d,0x3e,0x59,0x5d,0x5e,0x79,0x7d,0x7e,0x99,0x9d,0x9e,
+	0xb9,0xbc,0xbd,0xbe,0xd9,0xdd,0xde,0xf9,0xfd,0xfe};
+static const UBYTE implied_ops[]={
+	0x0a,0x1a,0x2a,0x3a,0x4a,0x6a,0x18,0x38,0xb8,0xd8,0xf8,0xea,0x88,0x8a,0x98,0xa8,
+	0xaa,0xba,0xc8,0xca,0xe8,0x78};
+static const UBYTE push_ops[]={0x48,0xda,0x5a,0x08};
+static const UBYTE pull_ops[]={0x68,0xfa,0x7a};
+static const UBYTE branch_ops[]={0x10,0x30,0x50,0x70,0x90,0xb0,0xd0,0xf0,0x80};
+
+#define PICK(table)		table[Random(sizeof(table))]
+
+static ULONG sites[TEST_MAX_SITES];
+static ULONG site_count;
+static ULONG subs[TEST_MAX_SUBS];
+static ULONG sub_count;
+
+//
+// One instruction from the random mix, immediate operands are noted as
+// places to patch when patchable is set. Returns the next address.
+//
+static ULONG Instruction(UBYTE *ram,ULONG pc,bool patchable)
+{
+	ULONG addr;
+
+	switch(Random(8))
+	{
+		case 0:
+		case 1:
+			ram[pc++]=PICK(immediate_ops);
+			if(patchable && site_count<TEST_MAX_SITES) sites[site_count++]=pc;
+			ram[pc++]=(UBYTE)Random(256);
+			break;
+		case 2:
+		case 3:
+			ram[pc++]=PICK(zeropage_ops);
+			ram[pc++]=(UBYTE)Random(256);
+			break;
+		case 4:
+			addr=TEST_DATA+Random(TEST_DATA_SIZE);
+			ram[pc++]=PICK(absolute_ops);
+			ram[pc++]=(UBYTE)addr;
+			ram[pc++]=(UBYTE)(addr>>8);
+			break;
+		case 5:
+			addr=TEST_DATA+Random(TEST_DATA_SIZE/2);
+			ram[pc++]=PICK(indexed_ops);
+			ram[pc++]=(UBYTE)addr;
+			ram[pc++]=(UBYTE)(addr>>8);
+			break;
+		default:
+			ram[pc++]=PICK(implied_ops);
+			break;
+	}
+	return pc;
+}
+
+//
+// A counted loop of random work, LDA #n:STA counter, body, DEC counter:BNE.
+// Patched code loops for longer so it gets hot enough to be recompiled
+// between patches.
+//
+static ULONG Segment(UBYTE *ram,ULONG pc,bool patchable)
+{
+	ULONG depth=0;
+
+	ram[pc++]=0xa9;
+	ram[pc++]=(UBYTE)(patchable?TEST_HOT+Random(32):1+Random(12));
+	ram[pc++]=0x8d;
+	ram[pc++]=(UBYTE)TEST_COUNTER;
+	ram[pc++]=(UBYTE)(TEST_COUNTER>>8);
+
+	ULONG loop=pc;
+	ULONG items=1+Random(16);
+	for(ULONG item=0;item<items;item++)
+	{
+		switch(Random(16))
+		{
+			case 9:
+				ram[pc++]=PICK(push_ops);
+				depth++;
+				break;
+			case 10:
+				if(!depth) break;
+				ram[pc++]=PICK(pull_ops);
+				depth--;
+				break;
+			case 11:
+			{
+				// Branch over the next instruction
+				ram[pc++]=PICK(branch_ops);
+				ULONG offset=pc++;
+				ULONG next=Instruction(ram,pc,patchable);
+				ram[offset]=(UBYTE)(next-pc);
+				pc=next;
+				break;
+			}
+			case 12:
+			{
+				if(!sub_count) break;
+				ULONG sub=subs[Random(sub_count)];
+				ram[pc++]=0x20;
+				ram[pc++]=(UBYTE)sub;
+				ram[pc++]=(UBYTE)(sub>>8);
+				break;
+			}
+			case 13:
+			{
+				// Patch some code, STA, STX, STY or INC absolute
+				if(!site_count) break;
+				static const UBYTE patch_ops[]={0x8d,0x8e,0x8c,0xee};
+				ULONG site=sites[Random(site_count)];
+				ram[pc++]=PICK(patch_ops);
+				ram[pc++]=(UBYTE)site;
+				ram[pc++]=(UBYTE)(site>>8);
+				break;
+			}
+			case 14:
+				// Read a timer count, blocks touching I/O are never recompiled
+				ram[pc++]=0xad;
+				ram[pc++]=(UBYTE)(0x02+Random(4)*4);
+				ram[pc++]=0xfd;
+				break;
+			default:
+				pc=Instruction(ram,pc,patchable);
+				break;
+		}
+	}
+	while(depth--) ram[pc++]=0x68;
+
+	ram[pc++]=0xce;
+	ram[pc++]=(UBYTE)TEST_COUNTER;
+	ram[pc++]=(UBYTE)(TEST_COUNTER>>8);
+	ram[pc++]=0xd0;
+	ram[pc]=(UBYTE)(loop-(pc+1));
+	pc++;
+	return pc;
+}
+
+static void Program(UBYTE *ram,ULONG program)
+{
+	seed=0x2545f491+program*0x9e3779b9;
+	seed&=0xffffffff;
+	if(!seed) seed=1;
+
+	for(ULONG loop=0;loop<0x100;loop++) ram[loop]=(UBYTE)Random(256);
+	for(ULONG loop=0;loop<TEST_DATA_SIZE;loop++) ram[TEST_DATA+loop]=(UBYTE)Random(256);
+	site_count=0;
+	sub_count=0;
+
+	// Subroutines of straight line code
+	ULONG pc=TEST_SUBS;
+	for(ULONG loop=0;loop<TEST_MAX_SUBS;loop++)
+	{
+		subs[sub_count++]=pc;
+		ULONG length=1+Random(12);
+		for(ULONG insn=0;insn<length;insn++) pc=Instruction(ram,pc,FALSE);
+		ram[pc++]=0x60;
+	}
+
+	// The routine that gets patched
+	pc=TEST_PATCHED;
+	for(ULONG loop=0;loop<4;loop++) pc=Segment(ram,pc,TRUE);
+	ram[pc++]=0x60;
+
+	// Main loop, runs every segment then the patched routine and counts
+	pc=TEST_MAIN;
+	ram[pc++]=0x78;		// SEI
+	ram[pc++]=0xd8;		// CLD
+	while(pc<TEST_MAIN_END) pc=Segment(ram,pc,FALSE);
+	ram[pc++]=0x20;
+	ram[pc++]=(UBYTE)TEST_PATCHED;
+	ram[pc++]=(UBYTE)(TEST_PATCHED>>8);
+	ram[pc++]=0xee;
+	ram[pc++]=(UBYTE)TEST_PASSES;
+	ram[pc++]=(UBYTE)(TEST_PASSES>>8);
+	ram[pc++]=0x4c;
+	ram[pc++]=(UBYTE)TEST_MAIN;
+	ram[pc++]=(UBYTE)(TEST_MAIN>>8);
+}
+
+static ULONG StateHash(CSystem &system,ULONG hash)
+{
+	C6502_REGS regs;
+	system.GetRegs(regs);
+	ULONG state[8]={(ULONG)regs.PC,(ULONG)regs.A,(ULONG)regs.X,(ULONG)regs.Y,(ULONG)regs.SP,(ULONG)regs.PS,
+		(ULONG)(gSystemCycleCount&0xffffffff),(ULONG)(gSystemCycleCount>>32)};
+	hash=Fnv((UBYTE*)state,sizeof(state),hash);
+	return Fnv(system.GetRamPointer(),RAM_SIZE,hash);
+}
+
+static bool WriteFile(const char *name,const UBYTE *data,ULONG size)
+{
+	FILE *fp=fopen(name,"wb");
+	if(fp==NULL) return FALSE;
+	bool ok=(fwrite(data,1,size,fp)==size);
+	fclose(fp);
+	return ok;
+}
+
+int main(void)
+{
+	static CErrorInterface error;
+	gError=&error;
+
+	// A homebrew header with nothing after it, loaded at 0x200
+	static const UBYTE game[16]={0x80,0x08,0x02,0x00,0x00,0x10,'B','S','9','3',0,0,0,0,0,0};
+	UBYTE rom[ROM_SIZE];
+	memset(rom,0,sizeof(rom));
+	if(!WriteFile(rom_file,rom,sizeof(rom)) || !WriteFile(game_file,game,sizeof(game)))
+	{
+		printf("Couldn't write the test files\n");
+		return 1;
+	}
+
+	CSystem *system=new CSystem(game_file,rom_file);
+	remove(rom_file);
+	remove(game_file);
+
+	for(ULONG program=0;program<TEST_PROGRAMS;program++)
+	{
+		system->Reset();
+		UBYTE *ram=system->GetRamPointer();
+		Program(ram,program);
+
+		C6502_REGS regs;
+		system->GetRegs(regs);
+		regs.PC=TEST_MAIN;
+		regs.SP=0xff;
+		regs.PS=0x24;
+		system->SetRegs(regs);
+
+		// Hash at each timer event, every way of running the CPU hands
+		// back to the system at the same instruction for these
+		ULONG hash=2166136261u;
+		ULONG events=0;
+		while(gSystemCycleCount<TEST_CYCLES || gSystemCycleCount<gNextTimerEvent)
+		{
+			if(gSystemCycleCount>=gNextTimerEvent)
+			{
+				hash=StateHash(*system,hash);
+				if(!(++events%TEST_REPORT)) printf("program %lu event %lu hash %08lx\n",program,events,hash);
+			}
+			system->Update();
+		}
+		hash=StateHash(*system,hash);
+		printf("program %lu passes %u hash %08lx\n",program,ram[TEST_PASSES],hash);
+	}
+
+#ifdef HANDY_CPU_JIT
+	ULONG blocks=system->mCpu->GetJitBlocks();
+	if(!blocks)
+	{
+		fprintf(stderr,"FAIL: nothing was recompiled\n");
+		return 1;
+	}
+#ifdef HANDY_CPU_JIT_LOCKSTEP
+	ULONG mismatches=system->mCpu->GetJitMismatches();
+	if(mismatches)
+	{
+		fprintf(stderr,"FAIL: %lu native blocks differ from the interpreter\n",mismatches);
+		return 1;
+	}
+	fprintf(stderr,"PASS: %lu blocks recompiled, all match the interpreter\n",blocks);
+#else
+	fprintf(stderr,"%lu blocks recompiled\n",blocks);
+#endif
+#endif
+
+	delete system;
+	return 0;
+}
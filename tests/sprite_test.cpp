@@ -0,0 +1,452 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Sprite engine band test                                                  //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Paints random SCB chains with Susie drawing the sprites in turn and      //
+// again with the screen cut into bands drawn by worker threads, then       //
+// checks the two give the same RAM image, depositaries and cycle count.    //
+//                                                                          //
+// The chains mix every sprite type, bit depth, literal and packed data,    //
+// scaling, tilt and quadrant, with the collision buffer sometimes on the   //
+// screen and the depositaries and screen sometimes over the SCB and        //
+// sprite data so the checks that fall back to drawing in turn are hit.     //
+//                                                                          //
+// Scenes where sprites draw over their own line data are also checked     //
+// against the RAM image and cycle count of the field at a time line reader //
+// every earlier build used.                                                //
+//                                                                          //
+// Needs HANDY_SPRITE_THREADS. With HANDY_BLOCK_CACHE a block of code is    //
+// decoded in every page first so the sprites write over code the CPU has  //
+// to drop. The test writes its own blank boot ROM and an empty homebrew    //
+// image to load as the game.                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "System.h"
+
+static char rom_file[]="sprite_test.rom";
+static char game_file[]="sprite_test.o";
+
+#define TEST_SCENES		250
+#define TEST_SCB		0x1000
+#define TEST_SCB_SIZE	0x30
+#define TEST_DATA		0x1800
+#define TEST_DATA_END	0x3e00
+#define TEST_OVERLAP_SCENES	32
+
+static ULONG seed=1;
+
+static ULONG Random(ULONG range)
+{
+	seed^=(seed<<13)&0xffffffff;
+	seed^=seed>>17;
+	seed^=(seed<<5)&0xffffffff;
+	return range?seed%range:seed;
+}
+
+static void PutBits(UBYTE *buffer,ULONG &bit,ULONG value,ULONG bits)
+{
+	while(bits--)
+	{
+		if(value&(1<<bits)) buffer[bit>>3]|=0x80>>(bit&7);
+		bit++;
+	}
+}
+
+//
+// Write one line of sprite data, style 0 is random bytes, 1 a short line
+// and 2 a long one. Returns the bytes used including the offset byte.
+//
+static ULONG SpriteLine(UBYTE *ram,ULONG addr,ULONG literal,ULONG bpp,ULONG style)
+{
+	UBYTE line[300];
+	ULONG length;
+
+	memset(line,0,sizeof(line));
+	if(style==0)
+	{
+		length=1+Random(24);
+		for(ULONG loop=0;loop<length;loop++) line[loop]=(UBYTE)Random(256);
+	}
+	else
+	{
+		ULONG bit=0;
+		if(literal)
+		{
+			ULONG pixels=1+Random(style==2?160:40);
+			for(ULONG loop=0;loop<pixels;loop++) PutBits(line,bit,Random(4)?Random(1<<bpp):0,bpp);
+		}
+		else
+		{
+			ULONG packets=1+Random(style==2?30:8);
+			for(ULONG loop=0;loop<packets && bit<1800;loop++)
+			{
+				ULONG count=1+Random(16);
+				if(Random(2))
+				{
+					PutBits(line,bit,1,1);
+					PutBits(line,bit,count-1,4);
+					while(count--) PutBits(line,bit,Random(1<<bpp),bpp);
+				}
+				else
+				{
+					PutBits(line,bit,0,1);
+					PutBits(line,bit,count-1,4);
+					PutBits(line,bit,Random(1<<bpp),bpp);
+				}
+			}
+			if(Random(8)) PutBits(line,bit,0,5);
+		}
+		length=(bit+7)/8;
+		if(length>250) length=250;
+	}
+
+	ram[addr&0xffff]=(UBYTE)(length+1);
+	for(ULONG loop=0;loop<length;loop++) ram[(addr+1+loop)&0xffff]=line[loop];
+	return length+1;
+}
+
+static void Poke(CSystem &system,ULONG addr,ULONG data)
+{
+	system.Poke_CPU(addr,(UBYTE)(data&0xff));
+	system.Poke_CPU(addr+1,(UBYTE)((data>>8)&0xff));
+}
+
+//
+// Set up the Susie registers, screen, collision buffer and an SCB chain
+// from the scene number so both systems get exactly the same. Returns the
+// collision depositary address of each SCB in the chain. With overlap set
+// the screen or collision buffer covers the sprite data and each sprite
+// starts on the line holding its own data.
+//
+static ULONG Scene(CSystem &system,ULONG scene,ULONG *depositary,bool overlap)
+{
+	UBYTE *ram=system.GetRamPointer();
+	seed=scene*2654435761u+1;
+
+	ULONG fill=Random(3);
+	for(ULONG addr=0x4000;addr<0x10000;addr++) ram[addr]=(UBYTE)((fill==0)?Random(256):(fill==1)?0:((Random(8)==0)?Random(256):0x11*Random(16)));
+	for(ULONG addr=0x1000;addr<0x4000;addr++) ram[addr]=0;
+
+	// Now and then the screen lands on the sprite data and the collision
+	// buffer on the screen
+	ULONG vidbas=0x4000+Random(2)*0x2000;
+	ULONG collbas=0xa000+Random(2)*0x2000;
+	if(Random(4)==0) vidbas=0x2800+Random(0x800);
+	if(Random(6)==0) collbas=vidbas;
+	ULONG over=vidbas;
+	if(overlap)
+	{
+		over=TEST_DATA-0x400+Random(0x800);
+		if(Random(2)) vidbas=over; else collbas=over;
+	}
+	Poke(system,0xfc08,vidbas);
+	Poke(system,0xfc0a,collbas);
+
+	ULONG hoff=Random(4)?0:Random(0x10000);
+	ULONG voff=Random(4)?0:Random(0x10000);
+	if(Random(4)==0)
+	{
+		hoff=(Random(64)-32)&0xffff;
+		voff=(Random(64)-32)&0xffff;
+	}
+	Poke(system,0xfc04,hoff);
+	Poke(system,0xfc06,voff);
+
+	// A big offset puts the depositaries over the next SCB
+	ULONG colloff=Random(4)?Random(32):Random(0x60);
+	Poke(system,0xfc24,colloff);
+	Poke(system,0xfc28,Random(2)?0x7f:Random(0x100));
+	Poke(system,0xfc2a,Random(2)?0x7f:Random(0x100));
+	system.Poke_CPU(0xfc92,(UBYTE)(Random(256)&0xfe&(Random(2)?0xff:0xdf)));
+	system.Poke_CPU(0xfc83,0xf3);
+	system.Poke_CPU(0xfc90,1);
+
+	ULONG scbs=1+Random(12);
+	ULONG scb=TEST_SCB;
+	ULONG data=TEST_DATA;
+	Poke(system,0xfc10,scb);
+
+	for(ULONG loop=0;loop<scbs;loop++)
+	{
+		// 0 anything, 1 literal unscaled, 2 big background, 3 packed unscaled
+		ULONG kind=Random(4);
+		ULONG bppsel=Random(4);
+		ULONG literal=(kind==1)?1:(kind==3)?0:Random(2);
+		ULONG depth=(kind==0)?Random(4):(kind==2)?Random(2):(Random(3)==0);
+		ULONG sprctl1=(literal<<7)|(Random(2)<<6)|(depth<<4)|(Random(2)<<3)|(Random(4)==0?Random(4):0);
+		if(Random(16)==0) sprctl1|=0x04;
+
+		ULONG addr=scb;
+		ram[addr++]=(UBYTE)((bppsel<<6)|(Random(4)<<4)|Random(8));
+		ram[addr++]=(UBYTE)sprctl1;
+		ram[addr++]=(UBYTE)((Random(3)==0?0x20:0)|Random(16));
+		ULONG next=(loop+1<scbs)?scb+TEST_SCB_SIZE:0;
+		ram[addr++]=(UBYTE)(next&0xff);
+		ram[addr++]=(UBYTE)(next>>8);
+		ram[addr++]=(UBYTE)(data&0xff);
+		ram[addr++]=(UBYTE)(data>>8);
+
+		int hpos=Random(8)?(int)Random(180)-10:(int)Random(600)-300;
+		int vpos=Random(8)?(int)Random(120)-10:(int)Random(400)-200;
+		if(overlap)
+		{
+			ULONG offset=(data-over)&0xffff;
+			hpos=(int)(offset%(SCREEN_WIDTH/2))*2-(int)Random(16);
+			vpos=(int)(offset/(SCREEN_WIDTH/2));
+		}
+		hpos+=(SWORD)hoff;
+		vpos+=(SWORD)voff;
+		ram[addr++]=(UBYTE)(hpos&0xff);
+		ram[addr++]=(UBYTE)((hpos>>8)&0xff);
+		ram[addr++]=(UBYTE)(vpos&0xff);
+		ram[addr++]=(UBYTE)((vpos>>8)&0xff);
+
+		if(depth>=1)
+		{
+			static const ULONG sizes[8]={0x100,0x100,0x100,0x80,0x200,0x180,0x40,0x300};
+			ULONG hsize=Random(4)?sizes[Random(8)]:Random(0x400);
+			ULONG vsize=Random(4)?sizes[Random(8)]:Random(0x400);
+			if(kind!=0 && Random(2)) hsize=vsize=0x100;
+			ram[addr++]=(UBYTE)(hsize&0xff);
+			ram[addr++]=(UBYTE)(hsize>>8);
+			ram[addr++]=(UBYTE)(vsize&0xff);
+			ram[addr++]=(UBYTE)(vsize>>8);
+		}
+		if(depth>=2)
+		{
+			int stretch=(int)Random(0x80)-0x40;
+			ram[addr++]=(UBYTE)(stretch&0xff);
+			ram[addr++]=(UBYTE)((stretch>>8)&0xff);
+		}
+		if(depth>=3)
+		{
+			int tilt=(int)Random(0x100)-0x80;
+			ram[addr++]=(UBYTE)(tilt&0xff);
+			ram[addr++]=(UBYTE)((tilt>>8)&0xff);
+		}
+		if(!(sprctl1&0x08))
+		{
+			for(ULONG pen=0;pen<8;pen++) ram[addr++]=(UBYTE)Random(256);
+		}
+
+		ULONG quadrants=(kind==0)?1+Random(4):1+(Random(4)==0);
+		for(ULONG quadrant=0;quadrant<quadrants;quadrant++)
+		{
+			ULONG lines=(kind==2)?20+Random(80):1+Random(30);
+			for(ULONG line=0;line<lines && data<TEST_DATA_END;line++)
+			{
+				data+=SpriteLine(ram,data,literal,bppsel+1,(kind==0)?Random(3):(Random(8)?1+(kind==2):0));
+			}
+			ram[data++]=(quadrant+1<quadrants)?1:0;
+		}
+		if(data>=TEST_DATA_END)
+		{
+			data=TEST_DATA_END;
+			ram[data]=0;
+		}
+
+		depositary[loop]=(scb+colloff)&0xffff;
+		scb+=TEST_SCB_SIZE;
+	}
+
+	system.Poke_CPU(0xfc91,(UBYTE)(1|(Random(2)<<2)));
+	return scbs;
+}
+
+#ifdef HANDY_BLOCK_CACHE
+//
+// Decode a block at the start of every RAM page a scene draws on
+//
+static void DecodePages(CSystem &system)
+{
+	for(ULONG page=TEST_SCB>>8;page<0xfc;page++) system.mCpu->DecodeBlock(page<<8);
+}
+#endif
+
+static ULONG Fnv(const UBYTE *data,ULONG size)
+{
+	ULONG hash=2166136261u;
+	for(ULONG loop=0;loop<size;loop++) hash=((hash^data[loop])*16777619)&0xffffffff;
+	return hash;
+}
+
+//
+// The cycles and RAM hash of each overlapping scene as drawn by the field
+// at a time reader
+//
+static const ULONG overlap_expected[TEST_OVERLAP_SCENES][2]=
+{
+	{15315,0x20eee7a7},
+	{216018,0xb4a1a513},
+	{40944,0xe19af29f},
+	{13473,0x2541671c},
+	{135330,0xbe6b4ab3},
+	{4938,0xc3a5c796},
+	{633,0x6d860c74},
+	{462,0x74435ae9},
+	{9747,0x76e23f39},
+	{26349,0x1fcdc1fa},
+	{6144,0x973d7ec1},
+	{10995,0xf6852064},
+	{96234,0x3a4263fd},
+	{465132,0x01455c8f},
+	{103653,0x0e299cca},
+	{406698,0x578d46ca},
+	{87021,0x2e9c5e43},
+	{4587,0xa12aff7f},
+	{282,0x2762ee2c},
+	{33321,0x18ce4958},
+	{239010,0xca83a907},
+	{8253,0x3a979fea},
+	{167784,0xd8bbd87d},
+	{60654,0x310daa81},
+	{15,0x6bb664b3},
+	{837,0xd9529aaf},
+	{243,0xcb715fd7},
+	{1566,0x440ae5c6},
+	{366,0x08c68ce7},
+	{133527,0x6d7cfec0},
+	{315,0xc7f3bc16},
+	{93600,0xf69b62d3}
+};
+
+static bool WriteFile(const char *name,const UBYTE *data,ULONG size)
+{
+	FILE *fp=fopen(name,"wb");
+	if(fp==NULL) return FALSE;
+	bool ok=(fwrite(data,1,size,fp)==size);
+	fclose(fp);
+	return ok;
+}
+
+int main(void)
+{
+	static CErrorInterface error;
+	gError=&error;
+
+	// A homebrew header with nothing after it, loaded at 0x200
+	static const UBYTE game[16]={0x80,0x08,0x02,0x00,0x00,0x10,'B','S','9','3',0,0,0,0,0,0};
+	UBYTE rom[ROM_SIZE];
+	memset(rom,0,sizeof(rom));
+	if(!WriteFile(rom_file,rom,sizeof(rom)) || !WriteFile(game_file,game,sizeof(game)))
+	{
+		printf("Couldn't write the test files\n");
+		return 1;
+	}
+
+	CSystem *serial=new CSystem(game_file,rom_file);
+	CSystem *banded=new CSystem(game_file,rom_file);
+	remove(rom_file);
+	remove(game_file);
+
+	static const ULONG threads[3]={2,3,SPRITE_MAX_THREADS};
+	ULONG failed=0;
+
+	for(ULONG pass=0;pass<3;pass++)
+	{
+		banded->SetSpriteThreads(threads[pass]);
+		ULONG bands=banded->GetSpriteThreads();
+		if(bands<2)
+		{
+			printf("Couldn't start the sprite threads\n");
+			return 1;
+		}
+
+		for(ULONG scene=0;scene<TEST_SCENES;scene++)
+		{
+			ULONG depositary[16];
+			ULONG scbs=Scene(*serial,scene,depositary,FALSE);
+			Scene(*banded,scene,depositary,FALSE);
+#ifdef HANDY_BLOCK_CACHE
+			DecodePages(*serial);
+			DecodePages(*banded);
+#endif
+
+			ULONG serialcycles=serial->PaintSprites();
+			ULONG bandedcycles=banded->PaintSprites();
+			const UBYTE *serialram=serial->GetRamPointer();
+			const UBYTE *bandedram=banded->GetRamPointer();
+			ULONG errors=0;
+
+			if(serialcycles!=bandedcycles)
+			{
+				printf("%lu bands, scene %lu: %lu cycles, %lu in turn\n",bands,scene,bandedcycles,serialcycles);
+				errors++;
+			}
+			for(ULONG loop=0;loop<scbs;loop++)
+			{
+				ULONG addr=depositary[loop];
+				if(serialram[addr]==bandedram[addr]) continue;
+				printf("%lu bands, scene %lu: SCB %lu depositary %02x, %02x in turn\n",bands,scene,loop,bandedram[addr],serialram[addr]);
+				errors++;
+			}
+			for(ULONG addr=0;addr<0x10000;addr++)
+			{
+				if(serialram[addr]==bandedram[addr]) continue;
+				printf("%lu bands, scene %lu: RAM %04lx is %02x, %02x in turn\n",bands,scene,addr,bandedram[addr],serialram[addr]);
+				errors++;
+				break;
+			}
+			if(errors) failed++;
+		}
+	}
+
+	for(ULONG scene=0;scene<TEST_OVERLAP_SCENES;scene++)
+	{
+		ULONG depositary[16];
+		serial->Reset();
+		banded->Reset();
+		Scene(*serial,scene,depositary,TRUE);
+		Scene(*banded,scene,depositary,TRUE);
+
+		ULONG serialcycles=serial->PaintSprites();
+		ULONG bandedcycles=banded->PaintSprites();
+		ULONG serialhash=Fnv(serial->GetRamPointer(),0x10000);
+		ULONG bandedhash=Fnv(banded->GetRamPointer(),0x10000);
+		ULONG cycles=overlap_expected[scene][0];
+		ULONG hash=overlap_expected[scene][1];
+
+		if(serialcycles!=cycles || serialhash!=hash || bandedcycles!=cycles || bandedhash!=hash)
+		{
+			printf("overlapping scene %lu: %lu cycles hash %08lx, %lu cycles hash %08lx in bands, expected %lu cycles hash %08lx\n",
+				scene,serialcycles,serialhash,bandedcycles,bandedhash,cycles,hash);
+			failed++;
+		}
+	}
+
+	delete banded;
+	delete serial;
+
+	printf("%s: %d scenes, %lu differ\n",failed?"FAIL":"PASS",3*TEST_SCENES+TEST_OVERLAP_SCENES,failed);
+	return failed?1:0;
+}
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2004 K. Wilkins
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from
+// the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+//////////////////////////////////////////////////////////////////////////////
+//                       Handy - An Atari Lynx Emulator                     //
+//                          Copyright (c) 1996,1997                         //
+//                                 K. Wilkins                               //
+//////////////////////////////////////////////////////////////////////////////
+// Mikie timer test                                                         //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Runs each interrupting timer as a one-shot until it is done, then clears //
+// TIMER_DONE through its CTLB register and checks the timer starts again   //
+// and interrupts a second time, as it did when every timer was serviced on //
+// every update. Timers of the 1 -> 3 -> 5 -> 7 chain are also run linked  //
+// to a free running timer that is not watched by anyone.                   //
+//                                                                          //
+// The test writes its own blank boot ROM and an empty homebrew image to    //
+// load as the game, the CPU sits in a loop with interrupts off.            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "System.h"
+#include "lynxdef.h"
+
+static char rom_file[]="timer_test.rom";
+static char game_file[]="timer_test.o";
+
+#define TEST_LOOP		0x0400
+#define TEST_COUNT		5
+#define TEST_CTLA		0x88		// Interrupt enable, count, no reload, 1us clock
+#define TEST_LINKED		0x8f		// Interrupt enable, count, no reload, linked
+#define TEST_SOURCE		0x18		// Count and reload, 1us clock
+#define TEST_SOURCE_BKUP	9
+#define TEST_TIMEOUT	100000		// Cycles to wait for an interrupt
+#define TEST_QUIET		20000		// Cycles a done one-shot must stay quiet for
+#define TEST_UNLINKED	8
+
+//
+// The timer under test and the timer it is linked to
+//
+static const ULONG timers[][2]={
+	{1,TEST_UNLINKED},
+	{3,TEST_UNLINKED},
+	{5,TEST_UNLINKED},
+	{6,TEST_UNLINKED},
+	{7,TEST_UNLINKED},
+	{3,1},
+	{5,3},
+	{7,5}};
+
+static bool WriteFile(const char *name,const UBYTE *data,ULONG size)
+{
+	FILE *fp=fopen(name,"wb");
+	if(fp==NULL) return FALSE;
+	bool ok=(fwrite(data,1,size,fp)==size);
+	fclose(fp);
+	return ok;
+}
+
+//
+// Run until the timer interrupt bit comes up, returns the cycles taken or
+// TEST_TIMEOUT if it never did
+//
+static ULONG WaitIRQ(CSystem &system,UBYTE bit,ULONG timeout)
+{
+	UCYCLE start=gSystemCycleCount;
+	while(gSystemCycleCount-start<timeout)
+	{
+		system.Update();
+		if(system.Peek_CPU(INTSET)&bit) return (ULONG)(gSystemCycleCount-start);
+	}
+	return TEST_TIMEOUT;
+}
+
+int main(void)
+{
+	static CErrorInterface error;
+	gError=&error;
+
+	// A homebrew header with nothing after it, loaded at 0x200
+	static const UBYTE game[16]={0x80,0x08,0x02,0x00,0x00,0x10,'B','S','9','3',0,0,0,0,0,0};
+	UBYTE rom[ROM_SIZE];
+	memset(rom,0,sizeof(rom));
+	if(!WriteFile(rom_file,rom,sizeof(rom)) || !WriteFile(game_file,game,sizeof(game)))
+	{
+		printf("Couldn't write the test files\n");
+		return 1;
+	}
+	CSystem *system=new CSystem(game_file,rom_file);
+	remove(rom_file);
+	remove(game_file);
+
+	ULONG failed=0;
+	for(ULONG loop=0;loop<sizeof(timers)/sizeof(timers[0]);loop++)
+	{
+		ULONG timer=timers[loop][0];
+		ULONG source=timers[loop][1];
+		ULONG base=TIM0BKUP+timer*4;
+		UBYTE bit=(UBYTE)(1<<timer);
+
+		system->Reset();
+		UBYTE *ram=system->GetRamPointer();
+		ram[TEST_LOOP]=0x4c;
+		ram[TEST_LOOP+1]=(UBYTE)TEST_LOOP;
+		ram[TEST_LOOP+2]=(UBYTE)(TEST_LOOP>>8);
+		C6502_REGS regs;
+		system->GetRegs(regs);
+		regs.PC=TEST_LOOP;
+		regs.PS=0x24;
+		system->SetRegs(regs);
+
+		// Run the timer as a one-shot until it interrupts
+		system->Poke_CPU(INTRST,0xff);
+		system->Poke_CPU(base+2,TEST_COUNT);
+		if(source==TEST_UNLINKED)
+		{
+			system->Poke_CPU(base+1,TEST_CTLA);
+		}
+		else
+		{
+			system->Poke_CPU(base+1,TEST_LINKED);
+			system->Poke_CPU(TIM0BKUP+source*4,TEST_SOURCE_BKUP);
+			system->Poke_CPU(TIM0BKUP+source*4+1,TEST_SOURCE);
+		}
+		ULONG first=WaitIRQ(*system,bit,TEST_TIMEOUT);
+
+		// Once done it must stay quiet
+		system->Poke_CPU(INTRST,bit);
+		ULONG quiet=WaitIRQ(*system,bit,TEST_QUIET);
+		UBYTE done=system->Peek_CPU(base+3);
+
+		// Clearing TIMER_DONE restarts it
+		system->Poke_CPU(base+3,0x00);
+		ULONG restart=WaitIRQ(*system,bit,TEST_TIMEOUT);
+		UBYTE count=system->Peek_CPU(base+2);
+
+		bool ok=(first<TEST_TIMEOUT && quiet==TEST_TIMEOUT && (done&0x08) && restart<TEST_TIMEOUT);
+		if(source==TEST_UNLINKED) printf("timer %lu",timer); else printf("timer %lu linked to %lu",timer,source);
+		printf(" first %lu restart %lu count %02x %s\n",first,restart,count,ok?"ok":"FAIL");
+		if(!ok) failed++;
+	}
+
+	delete system;
+	if(failed)
+	{
+		printf("FAIL: %lu timers did not restart\n",failed);
+		return 1;
+	}
+	printf("PASS: every one-shot timer restarts through CTLB\n");
+	return 0;
+}